@@ -0,0 +1,43 @@
+#ifndef _COMPLEX_BUFFER_H_
+#define _COMPLEX_BUFFER_H_
+
+#include <fftw3.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interleaved complex float samples (re,im pairs) in SIMD aligned memory,
+// usable directly as the input or output of an FFT_FORWARD/FFT_BACKWARD plan.
+typedef struct Complex_Buffer {
+    fftwf_complex *data;
+    int length;             // samples in use
+    int capacity;           // samples allocated
+} Complex_Buffer;
+
+/**
+ * Allocates a zeroed buffer of length samples.
+ *
+ * @return  Zero if no error.
+ */
+int complex_buffer_init(Complex_Buffer *b, int length);
+
+/**
+ * Changes the length, keeping the samples that fit. Memory is only
+ * reallocated when the buffer grows past its capacity, and any new samples are zeroed.
+ *
+ * @return  Zero if no error, the buffer is unchanged on failure.
+ */
+int complex_buffer_resize(Complex_Buffer *b, int length);
+
+/** Fills the buffer from real samples with zero imaginary parts, resizing it to N. Zero if no error. */
+int complex_buffer_from_real(Complex_Buffer *b, const float in[], int N);
+
+/** Frees the samples. The struct can be reused with complex_buffer_init. */
+void complex_buffer_free(Complex_Buffer *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef _DDC_H_
+#define _DDC_H_
+
+#include <stdint.h>
+#include <fftw3.h>
+#include <../include/NCO.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DDC_CIC_ORDER   4       // CIC integrator/comb pairs
+#define DDC_MAX_STAGES  32      // FIR stages after the CIC
+
+// Decimating FIR on complex samples, split into polyphase branches so every
+// dot product runs over contiguous samples and all zero branches are skipped.
+// A half-band filter needs a single tap in its odd branch.
+typedef struct DDC_Fir {
+    int decimation;             // branches, one per input phase
+    float **taps;               // per branch, reversed, with leading and trailing zeros trimmed
+    int *length;                // taps per branch, 0 if the branch is all zero
+    int *delay;                 // branch samples between the newest one and the first tap
+    fftwf_complex **buffer;     // per branch: history followed by the new samples
+    int history;                // branch samples kept from one block to the next
+    int *fill;                  // samples in each buffer
+    int phase;                  // input samples since the last output
+} DDC_Fir;
+
+// Digital down converter: tunes to a sub-band with an NCO, then decimates
+// through a CIC, half-band stages and a final FIR that also flattens the CIC droop.
+typedef struct DDC {
+    double sample_rate;         // Hz in
+    double output_rate;         // Hz out, sample_rate/decimation
+    double frequency;           // Hz moved to 0
+    int decimation;
+    NCO nco;
+    int cic_decimation;         // 1 when there is no CIC
+    int cic_phase;
+    float cic_in_scale;
+    double cic_out_scale;
+    uint64_t cic_state[4*DDC_CIC_ORDER];
+    int stages;                 // FIR stages in use
+    DDC_Fir fir[DDC_MAX_STAGES];
+    fftwf_complex *work[2];     // a chunk of samples passed between stages
+} DDC;
+
+/**
+ * Sets up a down converter. The decimation is split as C*r*2^k: a CIC decimates
+ * by as much C of the odd part as still leaves its output at least 8 times the
+ * output rate, k-1 half-band filters halve the rate, and a compensating FIR
+ * takes the rest r of the odd part with the last factor of two. That FIR is
+ * flat to 0.4 of the output rate and stops from 0.5, so nothing it lets
+ * through folds below 0.4. A large prime odd part is all taken by the FIR,
+ * which then has about 64 taps per factor of the decimation.
+ *
+ * @param sample_rate  Hz of the input.
+ * @param frequency    Hz of the input that ends up at 0 Hz, may be negative for complex input.
+ * @param decimation   Any factor from 1 whose odd part is at most 4096.
+ *
+ * @return  Zero if no error.
+ */
+int ddc_init(DDC *ddc, double sample_rate, double frequency, int decimation);
+
+/** Retunes without restarting the filters, the mixer phase carries on. */
+void ddc_set_frequency(DDC *ddc, double frequency);
+
+/**
+ * Down converts a block of complex samples. Blocks may be any length, the
+ * filter state carries over so a stream can be fed in pieces.
+ *
+ * @param out  Room for N/decimation+1 samples.
+ *
+ * @return  The number of output samples.
+ */
+int ddc_process(DDC *ddc, const fftwf_complex in[], int N, fftwf_complex out[]);
+
+/** Real input version of ddc_process. A real tone of amplitude a comes out with amplitude a/2. */
+int ddc_process_real(DDC *ddc, const float in[], int N, fftwf_complex out[]);
+
+/** Clears the filter state and mixer phase as if no samples had been processed. */
+void ddc_reset(DDC *ddc);
+
+/** Frees the filters. The DDC struct is now invalid. */
+void ddc_destroy(DDC *ddc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef _DEMOD_H_
+#define _DEMOD_H_
+
+#include <fftw3.h>
+#include <../include/Resampler.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Demodulators take complex baseband, e.g. the output of a DDC tuned to the
+// channel, and return audio. Each one keeps all of its state in its struct so
+// dozens of channels from one wideband capture can run side by side, one per
+// thread if need be.
+
+typedef enum AM_Mode {
+    AM_ENVELOPE,        // |x|, for AM with a carrier (DSB_LC_MOD)
+    AM_SYNCHRONOUS      // Costas loop locks to the suppressed carrier, works for DSB_SC_MOD too
+} AM_Mode;
+
+typedef struct AM_Demod {
+    AM_Mode mode;
+    int sample_rate;            // Hz in
+    int audio_rate;             // Hz out
+    float phasor[2];            // synchronous: conjugate of the recovered carrier
+    float frequency;            // synchronous: carrier offset, radians per sample
+    float gain_p;               // synchronous: loop filter proportional gain
+    float gain_i;               // synchronous: loop filter integral gain
+    float dc_pole;              // DC blocker pole at the audio rate
+    float dc_in;                // DC blocker last input and output
+    float dc_out;
+    int resample;               // audio_rate differs from sample_rate
+    Resampler audio;            // anti-alias filter and decimation to the audio rate
+    float *work;                // a chunk of detected samples at the input rate
+} AM_Demod;
+
+#define FM_DEEMPHASIS_EU    50e-6   // seconds, broadcast FM in Europe and most of the world
+#define FM_DEEMPHASIS_US    75e-6   // seconds, broadcast FM in the Americas and Korea
+
+typedef struct FM_Demod {
+    int sample_rate;            // Hz in
+    int audio_rate;             // Hz out
+    double deviation;           // Hz of deviation that gives full scale audio
+    float gain;                 // phase step in radians to audio
+    float previous[2];          // last input sample, the discriminator's reference
+    int deemphasis;             // de-emphasis on
+    float deemph_b;             // one pole low pass at the audio rate, b0=b1
+    float deemph_a;             // its feedback coefficient a1
+    float deemph_in;            // last input and output
+    float deemph_out;
+    int resample;               // audio_rate differs from sample_rate
+    Resampler audio;            // anti-alias filter and decimation to the audio rate
+    float *work;                // a chunk of discriminator output at the input rate
+} FM_Demod;
+
+/**
+ * Sets up an AM demodulator.
+ *
+ * @param sample_rate  Hz of the complex input.
+ * @param audio_rate   Hz of the audio out, e.g. 48000. May equal sample_rate.
+ *
+ * @return  Zero if no error.
+ */
+int am_demod_init(AM_Demod *am, AM_Mode mode, int sample_rate, int audio_rate);
+
+/** Largest number of audio samples N more inputs can produce, the size to give am_demod_process. */
+int am_demod_max_output(const AM_Demod *am, int N);
+
+/**
+ * Demodulates a block. Blocks may be any length, the loop, filter and DC
+ * blocker state carry over so a stream can be fed in pieces.
+ *
+ * @return  The number of audio samples.
+ */
+int am_demod_process(AM_Demod *am, const fftwf_complex in[], int N, float audio[]);
+
+/** Clears the state as if no samples had been processed. */
+void am_demod_reset(AM_Demod *am);
+
+/** Frees the buffers. The AM_Demod struct is now invalid. */
+void am_demod_destroy(AM_Demod *am);
+
+/**
+ * Sets up an FM discriminator. All buffers are allocated here, processing allocates nothing.
+ *
+ * @param sample_rate  Hz of the complex input, at least twice the deviation plus the audio bandwidth.
+ * @param audio_rate   Hz of the audio out, may equal sample_rate.
+ * @param deviation    Hz that gives full scale audio, 75000 for broadcast, 2500 or 5000 for narrowband.
+ * @param deemphasis   Time constant in seconds, FM_DEEMPHASIS_EU or FM_DEEMPHASIS_US, 0 for none.
+ *
+ * @return  Zero if no error.
+ */
+int fm_demod_init(FM_Demod *fm, int sample_rate, int audio_rate, double deviation, double deemphasis);
+
+/** Largest number of audio samples N more inputs can produce, the size to give fm_demod_process. */
+int fm_demod_max_output(const FM_Demod *fm, int N);
+
+/**
+ * Demodulates a block. Blocks may be any length, the discriminator, filter and
+ * de-emphasis state carry over so a stream can be fed in pieces.
+ *
+ * @return  The number of audio samples.
+ */
+int fm_demod_process(FM_Demod *fm, const fftwf_complex in[], int N, float audio[]);
+
+/** Clears the state as if no samples had been processed. */
+void fm_demod_reset(FM_Demod *fm);
+
+/** Frees the buffers. The FM_Demod struct is now invalid. */
+void fm_demod_destroy(FM_Demod *fm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef _FFT_PLAN_H_
+#define _FFT_PLAN_H_
+
+#include <fftw3.h>
+#include <../include/tinywav.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum FFT_Kind {
+    FFT_R2C,        // real to half complex, N/2+1 bins
+    FFT_C2R,        // half complex back to real, unnormalised
+    FFT_FORWARD,    // complex to complex forward
+    FFT_BACKWARD    // complex to complex backward, unnormalised
+} FFT_Kind;
+
+/**
+ * Loads FFTW wisdom so measured plans from earlier runs are reused.
+ *
+ * @param wisdom_path  Wisdom file, or NULL for the per host default
+ *                     $HOME/.sdr-fftwf-<hostname>.wisdom
+ *
+ * @return  Zero if wisdom was loaded, -1 if there was none yet.
+ */
+int fft_plan_cache_init(const char *wisdom_path);
+
+/** Writes the accumulated wisdom back to the wisdom file. Zero if no error. */
+int fft_plan_cache_save(void);
+
+/** Waits for pre-measuring, saves wisdom and destroys every cached plan. */
+void fft_plan_cache_shutdown(void);
+
+/**
+ * Enables FFTW's threaded transforms. Plans made afterwards whose total
+ * points per execution reach the threshold run on nthreads threads, smaller
+ * ones stay serial.
+ *
+ * @param nthreads  Worker threads, 0 for every online core.
+ *
+ * @return  Zero if no error.
+ */
+int fft_threads_init(int nthreads);
+
+/** Points per execution (N*howmany) from which plans are threaded, default 2^18. */
+void fft_threads_set_threshold(int points);
+
+/**
+ * Returns the cached plan for (N, kind, in-place, alignment of in/out, threads),
+ * measuring it on scratch buffers the first time so in and out are never
+ * touched. Run the plan with the fftwf_execute_dft* new-array functions on
+ * in and out. The plan stays owned by the cache.
+ */
+fftwf_plan fft_plan_get(int N, FFT_Kind kind, const void *in, const void *out);
+
+/**
+ * Returns the cached plan doing howmany transforms of length N in a single
+ * execution, with the data laid out like a tinywav channel buffer:
+ *   TW_INLINE       transforms follow each other [LLLLRRRR], bins likewise.
+ *                   Also the layout of a stack of STFT frames. In place real
+ *                   rows are padded to 2*(N/2+1) floats.
+ *   TW_INTERLEAVED  samples of each transform are howmany apart [LRLRLRLR],
+ *                   bins likewise. Out of place only.
+ * TW_SPLIT has no single stride/distance and returns NULL.
+ */
+fftwf_plan fft_plan_many(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, const void *in, const void *out);
+
+/** Real to complex transform of every channel in one plan execution. Zero if no error. */
+int fft_execute_many_r2c(int N, int howmany, TinyWavChannelFormat layout, float *in, fftwf_complex *out);
+
+/** Complex to real transform of every channel in one plan execution. Zero if no error. */
+int fft_execute_many_c2r(int N, int howmany, TinyWavChannelFormat layout, fftwf_complex *in, float *out);
+
+/**
+ * Complex to complex transform of an IQ block with the cached plan, N bins
+ * covering -fs/2..fs/2 rather than the N/2+1 of a real transform.
+ *
+ * @param kind  FFT_FORWARD or FFT_BACKWARD (unnormalised).
+ * @param in    May be the same array as out.
+ *
+ * @return  Zero if no error.
+ */
+int fft_execute_c2c(int N, FFT_Kind kind, fftwf_complex *in, fftwf_complex *out);
+
+/** Complex to complex transform of every channel in one plan execution. Zero if no error. */
+int fft_execute_many_c2c(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, fftwf_complex *in, fftwf_complex *out);
+
+/**
+ * Plans aligned r2c and c2r transforms for each size on a background thread
+ * so later fft_plan_get() calls for them return immediately.
+ *
+ * @return  Zero if the thread was started.
+ */
+int fft_plan_premeasure(const int sizes[], int count);
+
+/** Blocks until a running pre-measure has finished. */
+void fft_plan_premeasure_wait(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
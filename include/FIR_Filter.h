@@ -0,0 +1,80 @@
+#ifndef _FIR_FILTER_H_
+#define _FIR_FILTER_H_
+
+#include <fftw3.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIR_DIRECT_MAX      64      // longest filter FIR_AUTO runs in direct form
+#define FIR_DEFAULT_BLOCK   256     // FIR_PARTITIONED block when none is given
+
+typedef enum FIR_Method {
+    FIR_AUTO,           // direct form up to FIR_DIRECT_MAX taps, overlap-save beyond
+    FIR_DIRECT,         // SIMD dot product per output, no latency
+    FIR_OVERLAP_SAVE,   // one FFT block at least as long as the filter, latency of one block
+    FIR_PARTITIONED     // filter cut into block sized partitions, latency of one short block
+} FIR_Method;
+
+// Streaming FIR filter on real or complex samples with real taps. The FFT
+// methods are uniformly partitioned overlap-save: each new block of B samples
+// is transformed once at size 2B, kept in a delay line of spectra, and every
+// partition of the filter is applied as a spectral multiply accumulate.
+typedef struct FIR_Filter {
+    FIR_Method method;          // never FIR_AUTO once set up
+    int complex_data;           // samples are fftwf_complex rather than float
+    int length;                 // taps
+    int latency;                // samples the output lags the ideal filter by, 0 or block
+    float *taps;                // direct form, reversed so they line up with the samples
+    float *history;             // direct form: length-1 samples followed by the new ones
+    int block;                  // B, new samples per FFT
+    int partitions;             // P, partitions of B taps
+    int bins;                   // per spectrum, B+1 real or 2B complex
+    int stride;                 // complex values between spectra, bins padded to keep them aligned
+    fftwf_complex *spectra;     // P partition spectra of the taps, scaled for the unnormalised inverse
+    fftwf_complex *delay_line;  // P input spectra, the newest at slot newest
+    int newest;
+    fftwf_complex *accumulator; // sum of the products, one spectrum
+    float *time;                // 2B samples: the last block then the one filling up
+    float *result;              // inverse FFT, its last B samples are handed out as the next block fills
+    int fill;                   // samples in the block filling up
+    fftwf_plan forward;
+    fftwf_plan backward;
+} FIR_Filter;
+
+/**
+ * Sets up a streaming filter, the taps are copied.
+ *
+ * @param complex_data  Non zero to filter fftwf_complex samples with fir_filter_process_c.
+ * @param method        FIR_AUTO picks by length, e.g. a 4k tap channel filter runs
+ *                      overlap-save at O(log N) per sample.
+ * @param block         FIR_PARTITIONED samples per block, the latency. 0 for the default.
+ *                      Ignored by the other methods.
+ *
+ * @return  Zero if no error.
+ */
+int fir_filter_init(FIR_Filter *f, const float taps[], int length, int complex_data, FIR_Method method, int block);
+
+/**
+ * Filters a block of real samples, N in and N out. Blocks may be any length, the
+ * state carries over so a stream can be fed in pieces. out may be the same array as in.
+ *
+ * @return  Zero if no error.
+ */
+int fir_filter_process(FIR_Filter *f, const float in[], int N, float out[]);
+
+/** Complex sample version of fir_filter_process. */
+int fir_filter_process_c(FIR_Filter *f, const fftwf_complex in[], int N, fftwf_complex out[]);
+
+/** Clears the state as if no samples had been processed. */
+void fir_filter_reset(FIR_Filter *f);
+
+/** Frees the buffers. The FIR_Filter struct is now invalid. */
+void fir_filter_destroy(FIR_Filter *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
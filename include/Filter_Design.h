@@ -0,0 +1,115 @@
+#ifndef _FILTER_DESIGN_H_
+#define _FILTER_DESIGN_H_
+
+#include <../include/Window_Cache.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FILTER_MAX_ORDER    32      // highest IIR prototype order, a band pass has as many sections
+
+// Frequencies throughout are in cycles per sample, 0 to 0.5 (Hz divided by the sample rate).
+
+typedef enum Filter_Band {
+    FILTER_LOWPASS,     // passes 0 to low
+    FILTER_HIGHPASS,    // passes low to 0.5
+    FILTER_BANDPASS     // passes low to high
+} Filter_Band;
+
+typedef enum Filter_Method {
+    FILTER_WINDOWED_SINC,   // FIR, ideal response times a window from the window cache
+    FILTER_EQUIRIPPLE,      // FIR, Parks-McClellan, equal ripple in each band
+    FILTER_BUTTERWORTH,     // IIR, maximally flat
+    FILTER_CHEBYSHEV        // IIR, type I, equal ripple in the pass band
+} Filter_Method;
+
+// One second order section, a0 is 1:
+// H(z) = (b0 + b1 z^-1 + b2 z^-2)/(1 + a1 z^-1 + a2 z^-2)
+// A first order section has b2 = a2 = 0.
+typedef struct Biquad {
+    float b0, b1, b2;
+    float a1, a2;
+} Biquad;
+
+// Everything that decides a design, fields a method does not use are ignored.
+typedef struct Filter_Spec {
+    Filter_Method method;
+    Filter_Band band;
+    int order;                  // FIR taps, or the IIR prototype order
+    double low;                 // cut off, or the lower edge of a band pass
+    double high;                // upper edge of a band pass
+    Window_Type window;         // windowed sinc
+    float window_parameter;     // windowed sinc Gaussian delta or Kaiser beta
+    double transition;          // equiripple width of each transition band, centred on the edge
+    double stop_weight;         // equiripple stop band error weight relative to the pass band, 0 for 1
+    double ripple;              // Chebyshev pass band ripple, dB
+} Filter_Spec;
+
+// A cached design: taps for the FIR methods, sections for the IIR ones.
+typedef struct Filter_Design {
+    Filter_Spec spec;
+    int length;                 // taps, 0 for IIR
+    float *taps;
+    int sections;               // second order sections, 0 for FIR
+    Biquad *sos;
+} Filter_Design;
+
+/**
+ * Windowed sinc FIR. The window_size+1 table from the window cache is spread
+ * over length+1 so its zero end points fall outside the taps. The gain is 1 at
+ * 0 Hz for a low pass, at 0.5 for a high pass and at the centre of a band pass.
+ *
+ * @param length  Taps, odd for a high pass.
+ *
+ * @return  Zero if no error.
+ */
+int filter_design_window(Filter_Band band, int length, double low, double high,
+                         Window_Type window, float parameter, float taps[]);
+
+/**
+ * Equiripple linear phase FIR by the Parks-McClellan (Remez exchange) algorithm.
+ * Each edge is the centre of a transition band of the given width.
+ *
+ * @param length       Taps, odd for a high pass.
+ * @param stop_weight  Larger values trade pass band ripple for stop band depth.
+ *
+ * @return  Zero if no error, -1 for bad arguments or if the exchange did not converge,
+ *          e.g. a length and transition that would put the stop band below double precision.
+ */
+int filter_design_equiripple(Filter_Band band, int length, double low, double high,
+                             double transition, double stop_weight, float taps[]);
+
+/**
+ * Butterworth or Chebyshev type I IIR by the bilinear transform, as second order
+ * sections ordered with the poles nearest the unit circle last. The gain is 1
+ * at 0 Hz, 0.5 or the band centre, the top of the ripple for a Chebyshev.
+ *
+ * @param method    FILTER_BUTTERWORTH or FILTER_CHEBYSHEV.
+ * @param order     Prototype order, 1 to FILTER_MAX_ORDER. A band pass doubles it.
+ * @param ripple    Chebyshev pass band ripple in dB.
+ * @param sections  Room for order sections.
+ *
+ * @return  The number of sections, -1 on error.
+ */
+int filter_design_iir(Filter_Method method, Filter_Band band, int order, double low, double high,
+                      double ripple, Biquad sections[]);
+
+/**
+ * Returns the cached design for a spec, designing it the first time. Retuning
+ * back to an earlier setting is a lookup rather than a redesign, and other
+ * threads' lookups do not wait while a new spec is designed. The design
+ * stays valid until filter_design_cache_clear().
+ *
+ * @return  NULL if the spec cannot be designed.
+ */
+const Filter_Design *filter_design_get(const Filter_Spec *spec);
+
+/** Frees every cached design. Pointers handed out before this are invalid. */
+void filter_design_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
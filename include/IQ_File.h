@@ -0,0 +1,132 @@
+#ifndef _IQ_FILE_H_
+#define _IQ_FILE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <fftw3.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Raw interleaved IQ sample formats, all little endian
+typedef enum IQ_Format {
+    IQ_UNKNOWN,
+    IQ_CU8,     // unsigned 8 bit offset binary (RTL-SDR), SigMF "cu8"
+    IQ_CS8,     // signed 8 bit (HackRF), SigMF "ci8"
+    IQ_CS16,    // signed 16 bit, SigMF "ci16_le"
+    IQ_CF32     // 32 bit float, SigMF "cf32_le", the same layout as fftwf_complex
+} IQ_Format;
+
+typedef struct IQ_Annotation {
+    uint64_t sample_start;
+    uint64_t sample_count;
+    double freq_lower;          // Hz, 0 if not given
+    double freq_upper;          // Hz, 0 if not given
+    char label[64];
+} IQ_Annotation;
+
+// The parts of a .sigmf-meta sidecar this project uses
+typedef struct IQ_Meta {
+    IQ_Format format;
+    double sample_rate;         // Hz, 0 if not known
+    double center_frequency;    // Hz of the first capture segment, 0 if not known
+    IQ_Annotation *annotations;
+    int annotation_count;
+    int annotation_capacity;
+} IQ_Meta;
+
+typedef struct IQ_File {
+    void *base;                 // start of the mapped file
+    size_t length;              // bytes mapped
+    int sample_bytes;           // bytes per complex sample
+    uint64_t num_samples;       // complex samples in the file
+    uint64_t position;          // next sample iq_file_read returns
+    IQ_Meta meta;
+} IQ_File;
+
+typedef struct IQ_Writer {
+    FILE *f;
+    char *meta_path;            // sidecar written on close
+    int sample_bytes;
+    uint64_t samples;           // complex samples written
+    IQ_Meta meta;
+} IQ_Writer;
+
+/**
+ * Memory maps a raw IQ recording. The format comes from the SigMF sidecar
+ * (name.sigmf-meta next to name.sigmf-data or name.cs16 etc.) when there is
+ * one, then from the extension (.cu8 .cs8 .cs16 .cf32 .cfile), then from format.
+ *
+ * @param path    The recording to open.
+ * @param format  Format to assume if neither the sidecar nor the name give one, or IQ_UNKNOWN.
+ *
+ * @return  Zero if no error.
+ */
+int iq_file_open(IQ_File *iq, const char *path, IQ_Format format);
+
+/**
+ * Converts the next N samples to complex float in [-1,1), ready for an FFT_FORWARD plan.
+ *
+ * @return  The number of samples read, less than N at the end of the file.
+ */
+int iq_file_read(IQ_File *iq, fftwf_complex out[], int N);
+
+/** Moves the read position to sample. Returns zero if the sample is inside the file. */
+int iq_file_seek(IQ_File *iq, uint64_t sample);
+
+/**
+ * Zero copy view of a cf32 recording from sample on, usable as the input of an out of place FFT.
+ *
+ * @param count  Set to the number of samples from sample to the end. May be NULL.
+ *
+ * @return  Pointer into the mapping, NULL if the file is not cf32 or sample is past the end.
+ */
+const fftwf_complex *iq_file_view(const IQ_File *iq, uint64_t sample, uint64_t *count);
+
+/** Hint that samples [sample, sample+count) will be needed soon so the kernel reads them ahead. */
+void iq_file_willneed(const IQ_File *iq, uint64_t sample, uint64_t count);
+
+/** Unmaps the file. The IQ_File struct is now invalid. */
+void iq_file_close(IQ_File *iq);
+
+/**
+ * Opens a raw IQ file for writing, its SigMF sidecar is written on close.
+ *
+ * @param path              The data file, name.sigmf-data is recommended. It is overwritten.
+ * @param format            Sample format to write.
+ * @param sample_rate       Hz.
+ * @param center_frequency  Hz, 0 if not known.
+ *
+ * @return  Zero if no error.
+ */
+int iq_writer_open(IQ_Writer *w, const char *path, IQ_Format format, double sample_rate, double center_frequency);
+
+/**
+ * Converts N complex float samples to the file format and writes them.
+ *
+ * @return  The number of samples written.
+ */
+int iq_writer_write(IQ_Writer *w, const fftwf_complex in[], int N);
+
+/** Adds an annotation to the sidecar. freq_lower and freq_upper are left out of it when both are 0. */
+int iq_writer_annotate(IQ_Writer *w, uint64_t sample_start, uint64_t sample_count,
+                       double freq_lower, double freq_upper, const char *label);
+
+/** Closes the data file and writes the sidecar. The IQ_Writer struct is now invalid. */
+int iq_writer_close(IQ_Writer *w);
+
+/** Reads a .sigmf-meta file. Returns zero if it was read, meta must be freed with iq_meta_free. */
+int iq_meta_read(IQ_Meta *meta, const char *path);
+
+/** Writes meta as a .sigmf-meta file. */
+int iq_meta_write(const IQ_Meta *meta, const char *path);
+
+/** Frees the annotations of meta. */
+void iq_meta_free(IQ_Meta *meta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _NCO_H_
+#define _NCO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum NCO_Mode {
+    NCO_LUT,       // sine table indexed by the top phase bits, linearly interpolated
+    NCO_ROTATOR,   // complex multiply recurrence, restarted from the phase accumulator every block
+    NCO_POLY       // SIMD polynomial sine of the phase accumulator
+} NCO_Mode;
+
+// Numerically controlled oscillator. The phase is a 32 bit accumulator that
+// wraps exactly, so the output never drifts however long it runs.
+typedef struct NCO {
+    NCO_Mode mode;
+    double sample_rate;
+    uint32_t phase;          // phase of the next sample, 2^32 is one cycle
+    uint32_t step;           // phase advance per sample, frequency/sample_rate*2^32
+    float levels;            // (2^bits-1)/2 quantisation levels, 0 for none
+    double rotate[2];        // cos and sin of one step for NCO_ROTATOR
+} NCO;
+
+/**
+ * Sets up an oscillator starting at phase 0.
+ *
+ * @param mode         How the samples are generated.
+ * @param sample_rate  Samples per second.
+ * @param frequency    Hz, negative values turn the other way.
+ * @param bit          Output is quantised like a bit wide converter, 0 (or 24 and over) for none.
+ *
+ * @return  Zero if no error.
+ */
+int nco_init(NCO *nco, NCO_Mode mode, double sample_rate, double frequency, int bit);
+
+/** Changes the frequency, the phase carries on from where it is so there is no step in the output. */
+void nco_set_frequency(NCO *nco, double frequency);
+
+/** Sets the phase of the next sample in cycles, only the fraction is used. */
+void nco_set_phase(NCO *nco, double cycles);
+
+/** Next N samples of sin, the phase is left ready for the following block. */
+void nco_sin(NCO *nco, float out[], int N);
+
+/** Next N samples of cos. */
+void nco_cos(NCO *nco, float out[], int N);
+
+/** Next N samples of cos + j sin, interleaved like fftwf_complex. */
+void nco_complex(NCO *nco, float out[][2], int N);
+
+/**
+ * Amplitude modulates the next N samples of cos, out[i] = cos[i]*(in[i]+offset).
+ * NCO_POLY generates, quantises and multiplies in a single SIMD pass.
+ *
+ * @param in      Message samples, may be the same array as out.
+ * @param offset  Added to the message before the multiply, the carrier level of large carrier AM.
+ */
+void nco_modulate(NCO *nco, const float in[], float offset, float out[], int N);
+
+/** Frequency shifts complex samples, out[i] = in[i]*(cos + j sin). in may be the same array as out. */
+void nco_mix(NCO *nco, const float in[][2], float out[][2], int N);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
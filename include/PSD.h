@@ -0,0 +1,81 @@
+#ifndef _PSD_H_
+#define _PSD_H_
+
+#include <fftw3.h>
+#include <../include/Window_Cache.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum PSD_Average {
+    PSD_LINEAR,       // mean of every segment
+    PSD_EXPONENTIAL,  // running average weighted by alpha
+    PSD_MAX_HOLD      // largest value seen in each bin
+} PSD_Average;
+
+typedef struct PSD_Welch {
+    int segment;             // FFT length of each segment
+    int hop;                 // samples between segment starts
+    int bins;                // segment/2+1
+    int batch;               // segments transformed per plan execution
+    PSD_Average mode;
+    float alpha;             // weight of the newest segment for PSD_EXPONENTIAL
+    double scale;            // 1/(sample_rate*sum(w^2)), the window power normalisation
+    const float *window;     // shared table from the window cache
+    float *history;          // input waiting to be segmented
+    int capacity;            // segment+(batch-1)*hop
+    int filled;
+    float *frames;           // batch windowed segments back to back (TW_INLINE)
+    fftwf_complex *spectra;  // batch spectra back to back
+    fftwf_plan plan;         // batched plan, owned by the plan cache
+    double *average;         // running average per bin
+    float *psd;              // last result
+    long segments;           // segments averaged so far
+} PSD_Welch;
+
+/**
+ * Sets up a streaming Welch estimate. Memory is fixed here and does not grow
+ * with the length of the input.
+ *
+ * @param segment      FFT length of each segment.
+ * @param hop          Samples between segments, segment/2 for 50% overlap.
+ * @param window       Window applied to each segment.
+ * @param parameter    Window parameter (delta for the Gaussian window).
+ * @param sample_rate  Sample rate in Hz, the result is in units^2/Hz.
+ * @param mode         How segments are averaged.
+ * @param alpha        Newest segment weight for PSD_EXPONENTIAL, 0..1.
+ *
+ * @return  Zero if no error.
+ */
+int psd_welch_init(PSD_Welch *w, int segment, int hop, Window_Type window, float parameter,
+                   double sample_rate, PSD_Average mode, float alpha);
+
+/** Feeds samples to the estimate. Returns the number of segments averaged by this call. */
+int psd_welch_push(PSD_Welch *w, const float samples[], int N);
+
+/**
+ * Averages any complete segments still buffered and returns the one sided
+ * PSD, segment/2+1 bins. The array belongs to the estimator.
+ */
+const float *psd_welch_result(PSD_Welch *w);
+
+/** Clears the average and buffered input. */
+void psd_welch_reset(PSD_Welch *w);
+
+/** Frees the buffers. The PSD_Welch struct is now invalid. */
+void psd_welch_destroy(PSD_Welch *w);
+
+/**
+ * One shot Welch PSD of a whole buffer into psd[] (segment/2+1 long).
+ *
+ * @return  The number of segments averaged, or -1 on error.
+ */
+int psd_welch(const float data[], int N, int segment, int hop, Window_Type window, float parameter,
+              double sample_rate, PSD_Average mode, float psd[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
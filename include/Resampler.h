@@ -0,0 +1,52 @@
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming rational resampler. The rate changes by exactly L/M through a
+// polyphase bank of L filters, one per output phase, each a SIMD dot product.
+typedef struct Resampler {
+    int input_rate;
+    int output_rate;
+    int L;                      // interpolation, output_rate/gcd
+    int M;                      // decimation, input_rate/gcd
+    int taps;                   // taps per phase
+    float *bank;                // L phases of taps, each reversed so it lines up with the samples
+    float *buffer;              // taps-1 samples of history followed by the new input
+    int fill;                   // samples in buffer
+    int position;               // buffer index of the newest sample the next output uses
+    int phase;                  // bank phase of the next output
+} Resampler;
+
+/**
+ * Sets up a resampler between two sample rates, e.g. 44100 to 48000 is L/M = 160/147.
+ * The low pass is flat to 0.03 dB up to 0.44 of the lower rate and stops 80 dB or more from 0.52 of it.
+ *
+ * @return  Zero if no error.
+ */
+int resampler_init(Resampler *rs, int input_rate, int output_rate);
+
+/** Largest number of outputs N more inputs can produce, the size to give resampler_process. */
+int resampler_max_output(const Resampler *rs, int N);
+
+/**
+ * Resamples a block. Blocks may be any length, the history carries over so a
+ * stream can be fed in pieces.
+ *
+ * @return  The number of output samples.
+ */
+int resampler_process(Resampler *rs, const float in[], int N, float out[]);
+
+/** Clears the history as if no samples had been processed. */
+void resampler_reset(Resampler *rs);
+
+/** Frees the filter bank. The Resampler struct is now invalid. */
+void resampler_destroy(Resampler *rs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,37 +1,89 @@
-#ifndef _SDR_H_
-#define _SDR_H_
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-int triangle(int window_size, float data[]);
-
-int Welch(int window_size, float data[]);
-
-int Sine(int window_size, float data[]);
-
-int Hann(int window_size, float data[]);
-
-int Hamming(int window_size, float data[]);
-
-int Blackman(int window_size, float data[]);
-
-int Gaussian(int window_size, float data[],float delta);
-
-int multiply(float window[],float data[],int window_size, float final_data[]);
-
-int divide(float window[],float data[],int window_size, float final_data[]);
-
-int writetextc(float data[][2],int N,char *name);
-
-int writetextf(float data[],int N,char *name, bool normalised);
-
-int testsdr(void);
-
-
-#ifdef __cplusplus
-}
-#endif
-
+#ifndef _SDR_H_
+#define _SDR_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <fftw3.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum Dump_Format {
+    DUMP_TEXT,   // one "%f" value per line, complex as "re im"
+    DUMP_RAW,    // bare little endian float32, complex interleaved re,im
+    DUMP_NPY     // NumPy .npy, float32 or complex64
+} Dump_Format;
+
+// File that equal length frames are appended to, e.g. every STFT frame of a run
+typedef struct Dump_File {
+    FILE *f;
+    char *buffer;        // stdio buffer so frames are written in bulk
+    Dump_Format format;
+    bool complex_data;   // frames are fftwf_complex rather than float
+    int frame_length;    // values (or complex pairs) per frame
+    long frames;         // frames written, the first .npy dimension
+} Dump_File;
+
+int triangle(int window_size, float data[]);
+
+int Welch(int window_size, float data[]);
+
+int Sine(int window_size, float data[]);
+
+int Hann(int window_size, float data[]);
+
+int Hamming(int window_size, float data[]);
+
+int Blackman(int window_size, float data[]);
+
+int Gaussian(int window_size, float data[],float delta);
+
+int Kaiser(int window_size, float data[],float beta);
+
+// Modified Bessel function of the first kind, order 0, the shape of the Kaiser window
+double bessel_i0(double x);
+
+int multiply(float window[],float data[],int window_size, float final_data[]);
+
+int divide(float window[],float data[],int window_size, float final_data[]);
+
+int multiply_inplace(const float window[],float data[],int window_size);
+
+int divide_reciprocal(const float inverse[],float data[],int window_size, float final_data[]);
+
+int divide_reciprocal_inplace(const float inverse[],float data[],int window_size);
+
+// Complex (IQ) versions, the real window scales both parts of every sample
+int multiply_c(const float window[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]);
+
+int divide_c(const float window[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]);
+
+int multiply_inplace_c(const float window[],fftwf_complex data[],int window_size);
+
+int divide_reciprocal_c(const float inverse[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]);
+
+int divide_reciprocal_inplace_c(const float inverse[],fftwf_complex data[],int window_size);
+
+int writetextc(float data[][2],int N,char *name);
+
+int writetextf(float data[],int N,char *name, bool normalised);
+
+int writebinf(const float data[],int N,const char *name,Dump_Format format);
+
+int writebinc(const float data[][2],int N,const char *name,Dump_Format format);
+
+int dump_open(Dump_File *d,const char *name,Dump_Format format,bool complex_data,int frame_length);
+
+int dump_frame(Dump_File *d,const float data[]);
+
+int dump_close(Dump_File *d);
+
+int testsdr(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef _SOS_FILTER_H_
+#define _SOS_FILTER_H_
+
+#include <../include/Filter_Design.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cascade of second order sections over several channels at once, one channel
+// per SIMD lane with transposed direct form II state. Channels are grouped
+// SOS_LANES at a time, so up to 8 channels cost the same as one. An IQ stream
+// is two channels, its fftwf_complex samples are already interleaved frames.
+typedef struct SOS_Filter {
+    int channels;
+    int sections;
+    int groups;                 // of SOS_LANES channels, the last one padded
+    float *coefficients;        // per group and section: b0,b1,b2,a1,a2, one per lane
+    float *state;               // per group and section: s1,s2, one per lane
+    float *work;                // a chunk of frames padded to whole groups, NULL when channels fill them
+} SOS_Filter;
+
+/**
+ * Sets up a filter running the same sections on every channel, e.g. from
+ * filter_design_iir or a cached Filter_Design.
+ *
+ * @param count     Sections in the cascade.
+ * @param channels  Channels interleaved in each frame.
+ *
+ * @return  Zero if no error.
+ */
+int sos_filter_init(SOS_Filter *f, const Biquad sections[], int count, int channels);
+
+/** Gives one channel its own sections, count as given to sos_filter_init. Its state is kept. Zero if no error. */
+int sos_filter_set_channel(SOS_Filter *f, int channel, const Biquad sections[]);
+
+/**
+ * Filters interleaved frames of channels. Blocks may be any length, the state
+ * carries over so a stream can be fed in pieces. out may be the same array as in.
+ *
+ * @return  Zero if no error.
+ */
+int sos_filter_process(SOS_Filter *f, const float in[], float out[], int frames);
+
+/** Clears the state as if no samples had been processed. */
+void sos_filter_reset(SOS_Filter *f);
+
+/** Frees the buffers. The SOS_Filter struct is now invalid. */
+void sos_filter_destroy(SOS_Filter *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
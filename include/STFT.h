@@ -0,0 +1,61 @@
+#ifndef _STFT_H_
+#define _STFT_H_
+
+#include <fftw3.h>
+#include <../include/Window_Cache.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Called once per completed frame with frame_size/2+1 bins. The spectrum
+// belongs to the STFT and is overwritten by the next frame.
+typedef void (*STFT_Callback)(const fftwf_complex spectrum[], int bins, void *user);
+
+typedef struct STFT {
+    int frame_size;           // samples per FFT frame
+    int hop;                  // samples between frame starts, frame_size/2 for 50% overlap
+    int bins;                 // frame_size/2+1
+    int filled;               // samples waiting in history
+    long frames;              // frames produced since init
+    const float *window;      // shared table from the window cache
+    float *history;           // last frame_size input samples
+    float *frame;             // windowed frame, input of the plan
+    fftwf_complex *spectrum;  // output of the plan
+    fftwf_plan plan;          // owned by the plan cache
+} STFT;
+
+/**
+ * Sets up a streaming STFT. The buffers are allocated and the plan taken from
+ * the plan cache here, then reused for the life of the object.
+ *
+ * @param frame_size  FFT length in samples.
+ * @param hop         Samples between frames, 1..frame_size.
+ * @param window      Window applied to each frame.
+ * @param parameter   Window parameter (delta for the Gaussian window).
+ *
+ * @return  Zero if no error.
+ */
+int stft_init(STFT *st, int frame_size, int hop, Window_Type window, float parameter);
+
+/**
+ * Feeds samples into the STFT, calling back once for every frame completed.
+ *
+ * @return  The number of frames produced by this call.
+ */
+int stft_push(STFT *st, const float samples[], int N, STFT_Callback callback, void *user);
+
+/** Switches the window for the next frames, buffered samples are kept. Zero if no error. */
+int stft_set_window(STFT *st, Window_Type window, float parameter);
+
+/** Drops any buffered samples so the next push starts a new stream. */
+void stft_reset(STFT *st);
+
+/** Frees the buffers, the plan stays in the FFT_Plan cache. The STFT struct is now invalid. */
+void stft_destroy(STFT *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
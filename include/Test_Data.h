@@ -1,35 +1,63 @@
-#ifndef _TESTDATA_H_
-#define _TESTDATA_H_
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-
-void Create_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]);
-
-
-
-void DSB_SC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]);
-
-
-
-
-void DSB_LC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit, int A,double t_start,float dataout[]);
-
-
-
-
-
-
-
-
-
-
-
-
-#ifdef __cplusplus
-}
-#endif
-
+#ifndef _TESTDATA_H_
+#define _TESTDATA_H_
+
+#include <fftw3.h>
+#include <../include/NCO.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Double sideband modulator that keeps its carrier phase between blocks
+typedef struct DSB_Modulator {
+    NCO carrier;
+    float A;                    // carrier level added to the message, 0 for suppressed carrier
+} DSB_Modulator;
+
+
+void Create_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]);
+
+// Complex exponential cos + j sin, the baseband version of Create_Sine_Wave, negative frequencies turn the other way
+void Create_Complex_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,fftwf_complex dataout[]);
+
+
+
+void DSB_SC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]);
+
+
+
+
+void DSB_LC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit, int A,double t_start,float dataout[]);
+
+/**
+ * Sets up a modulator whose first sample is one period after t_start, as DSB_SC_MOD and DSB_LC_MOD do.
+ *
+ * @param bit  Carrier quantisation, 0 for none.
+ * @param A    Carrier level, 0 for DSB_SC and A>0 for DSB_LC.
+ *
+ * @return  Zero if no error.
+ */
+int DSB_Modulator_Init(DSB_Modulator *mod, double sample_rate, double frequency, int bit, float A, double t_start);
+
+/** Modulates the next N message samples, dataout may be the same array as datain. */
+void DSB_Modulate(DSB_Modulator *mod, const float datain[], float dataout[], int Number_of_samples);
+
+/** Complex baseband version of DSB_Modulate, (message+A)*(cos + j sin) with the frequency as an offset from the tuning. */
+void DSB_Modulate_c(DSB_Modulator *mod, const float datain[], fftwf_complex dataout[], int Number_of_samples);
+
+
+
+
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef _VECTOR_OPS_H_
+#define _VECTOR_OPS_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Instruction set picked at runtime for the vector kernels
+typedef enum Vector_Isa {
+    VECTOR_SCALAR,
+    VECTOR_SSE2,
+    VECTOR_AVX2,        // AVX2 with FMA, as every AVX2 CPU but some VMs have
+    VECTOR_NEON
+} Vector_Isa;
+
+Vector_Isa vector_isa(void);
+
+const char *vector_isa_name(void);
+
+// out[i] = a[i]*b[i], out may be the same array as a or b
+void vector_multiply(const float a[], const float b[], float out[], int N);
+
+// data[i] *= window[i]
+void vector_multiply_inplace(const float window[], float data[], int N);
+
+// Complex arrays are interleaved re,im pairs, the same layout as fftwf_complex.
+// out[i] = a[i]*in[i] for real a, out may be the same array as in
+void vector_multiply_real_complex(const float a[], const float in[][2], float out[][2], int N);
+
+// out[i] = in[i]/a[i] for real a, out may be the same array as in
+void vector_divide_real_complex(const float a[], const float in[][2], float out[][2], int N);
+
+// out[i] = a[i]*b[i] complex, out may be the same array as a or b
+void vector_complex_multiply(const float a[][2], const float b[][2], float out[][2], int N);
+
+// acc[i] += a[i]*b[i] complex
+void vector_complex_multiply_add(const float a[][2], const float b[][2], float acc[][2], int N);
+
+// out[i] = |in[i]|, the envelope of a complex block
+void vector_complex_magnitude(const float in[][2], float out[], int N);
+
+// out[i] = gain*arg(in[i]*conj(in[i-1])), the phase step of an FM discriminator with a
+// polynomial atan2 good to about 1e-5 rad. previous is in[-1] and is updated to in[N-1].
+void vector_fm_discriminate(const float in[][2], float previous[2], float out[], int N, float gain);
+
+// sum of a[i]*b[i], one output of a real FIR
+float vector_dot(const float a[], const float b[], int N);
+
+// out = sum taps[i]*x[i] for real taps and complex x, one output of a complex FIR
+void vector_dot_real_complex(const float taps[], const float x[][2], int N, float out[2]);
+
+// CIC decimator on complex samples with 64 bit wrapping integer state.
+// state holds 4*order values (integrators then comb delays), zeroed before the first call.
+// Samples are scaled by in_scale and rounded on the way in, outputs are multiplied by out_scale.
+// phase counts samples since the last output. Order is at most 8. Returns the outputs written.
+int vector_cic_decimate(uint64_t state[], int order, int decimation, int *phase, float in_scale, double out_scale,
+                        const float in[][2], float out[][2], int N);
+
+#define SOS_LANES 8
+
+// Cascaded biquads (transposed direct form II) run on groups*SOS_LANES channels at once, one per lane.
+// data is frames of groups*SOS_LANES samples, filtered in place. Per group and section, coefficients
+// hold b0,b1,b2,a1,a2 and state holds s1,s2, each SOS_LANES wide with one value per lane.
+void vector_sos_lanes(const float coefficients[], float state[], int sections, int groups, float data[], int frames);
+
+// out[i] = a[i]/b[i], out may be the same array as a or b
+void vector_divide(const float a[], const float b[], float out[], int N);
+
+// out[i] = 1/in[i] with zero coefficients mapped to 0 rather than inf
+void vector_reciprocal(const float in[], float out[], int N);
+
+// out[i] = sin(2*pi*(phase+i*step)/2^32), polynomial accurate to about 5e-7
+void vector_sine_phase(uint32_t phase, uint32_t step, float out[], int N);
+
+// data = round((data+1)*levels)/levels-1, the amplitude quantisation of a (2*levels+1) level converter
+void vector_quantize(float data[], int N, float levels);
+
+// out[i] = s[i]*(in[i]+offset) with s the vector_sine_phase carrier, quantised first when levels>0.
+// One pass over the data, in may be the same array as out.
+void vector_sine_mix(uint32_t phase, uint32_t step, float levels, const float in[], float offset, float out[], int N);
+
+// 8 bit IQ to float, unsigned is offset binary (cu8) centred on 127.5, signed is cs8
+void vector_u8_to_float(const uint8_t in[], float out[], int N);
+
+void vector_s8_to_float(const int8_t in[], float out[], int N);
+
+void vector_float_to_u8(const float in[], uint8_t out[], int N);
+
+void vector_float_to_s8(const float in[], int8_t out[], int N);
+
+// PCM to float, full scale maps to [-1,1). 24 bit samples are packed little endian.
+void vector_s16_to_float(const int16_t in[], float out[], int N);
+
+void vector_s24_to_float(const uint8_t in[], float out[], int N);
+
+void vector_s32_to_float(const int32_t in[], float out[], int N);
+
+// float to PCM as x*2^(bits-1), rounded to nearest and clipped at full scale, so every
+// width round trips through its decoder the same way
+void vector_float_to_s16(const float in[], int16_t out[], int N);
+
+void vector_float_to_s24(const float in[], uint8_t out[], int N);
+
+void vector_float_to_s32(const float in[], int32_t out[], int N);
+
+// [LRLR] <-> one array per channel, out/in hold channels pointers
+void vector_deinterleave(const float in[], float *const out[], int channels, int frames);
+
+void vector_interleave(const float *const in[], float out[], int channels, int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
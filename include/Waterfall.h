@@ -0,0 +1,56 @@
+#ifndef _WATERFALL_H_
+#define _WATERFALL_H_
+
+#include <gtk/gtk.h>
+#include <../include/STFT.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Waterfall {
+    GtkWidget *area;           // drawing area the waterfall is shown in
+    cairo_surface_t *texture;  // ring of dB mapped rows, one row per STFT frame
+    int columns;               // texture width, spectrum bins are max pooled into it
+    int rows;                  // texture height, the history shown
+    int row;                   // texture row holding the newest frame
+    int bins;
+    float floor_db;            // level drawn with the first palette colour
+    float range_db;            // levels above floor_db+range_db use the last colour
+    float norm;                // scales |X|^2 so a full scale sine is near 0 dB
+    gboolean dirty;            // rows added since the last redraw request
+    guint32 palette[256];
+    STFT stft;
+} Waterfall;
+
+/**
+ * Creates the waterfall widget and its STFT.
+ *
+ * @param fft_size  FFT length of each row.
+ * @param hop       Samples between rows, fft_size/4 for 75% overlap.
+ * @param window    Window applied before each FFT.
+ * @param parameter Window parameter (delta for the Gaussian window).
+ * @param columns   Texture width, at most fft_size/2+1.
+ * @param rows      Number of rows of history kept, at least 1.
+ * @param floor_db  Lowest level shown.
+ * @param range_db  Span of levels shown above floor_db.
+ *
+ * @return  Zero if no error.
+ */
+int waterfall_init(Waterfall *wf, int fft_size, int hop, Window_Type window, float parameter,
+                   int columns, int rows, float floor_db, float range_db);
+
+/** Feeds samples in, adding one row per completed frame and asking for a redraw if any were added. */
+void waterfall_push(Waterfall *wf, const float samples[], int N);
+
+/** Changes the window of the rows still to come, the history already drawn is kept. Zero if no error. */
+int waterfall_set_window(Waterfall *wf, Window_Type window, float parameter);
+
+/** Destroys the widget and frees the texture. The Waterfall struct is now invalid. */
+void waterfall_destroy(Waterfall *wf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef _WAV_WRITER_H_
+#define _WAV_WRITER_H_
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <../include/tinywav.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WAV_WRITER_BLOCKS 16  // blocks in the queue between the caller and the writer thread
+
+typedef struct Wav_Writer {
+    int fd;
+    TinyWavHeader header;              // rewritten with the final sizes on close
+    int direct;                        // file opened with O_DIRECT
+    int16_t numChannels;
+    TinyWavSampleFormat sampFmt;       // format written to the file
+    TinyWavChannelFormat chanFmt;      // layout of the float data handed to wav_writer_write
+    int frame_bytes;                   // bytes per frame in the file
+    size_t block_bytes;                // size of each block, a multiple of the O_DIRECT alignment
+    uint8_t *blocks[WAV_WRITER_BLOCKS];
+    size_t used[WAV_WRITER_BLOCKS];    // bytes filled in each queued block
+    size_t fill;                       // bytes filled in the block the caller is writing into
+    unsigned long head;                // blocks handed to the writer thread, only the caller stores it
+    unsigned long tail;                // blocks written to disk, only the writer thread stores it
+    int running;                       // writer thread started
+    int stop;
+    int error;                         // set by the writer thread if a write failed
+    uint64_t data_bytes;               // bytes of sample data accepted
+    uint64_t frames;                   // frames accepted
+    uint64_t dropped;                  // frames dropped because the queue was full
+    sem_t ready;                       // posted once per block queued
+    pthread_t thread;
+} Wav_Writer;
+
+/**
+ * Opens a wav file and starts its writer thread. Samples are handed over in
+ * blocks through a queue so wav_writer_write never waits on the disk.
+ *
+ * @param path         The file to write, it is overwritten.
+ * @param numChannels  The number of channels to write.
+ * @param samplerate   The sample rate of the audio.
+ * @param sampFmt      The sample format written to the file.
+ * @param chanFmt      How the float data given to wav_writer_write is laid out.
+ * @param direct       Nonzero to bypass the page cache with O_DIRECT where supported.
+ *
+ * @return  Zero if no error.
+ */
+int wav_writer_open(Wav_Writer *ww, const char *path, int16_t numChannels, int32_t samplerate,
+                    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt, int direct);
+
+/**
+ * Encodes len frames of float data into the queue and returns without touching the disk.
+ * If the writer thread has fallen so far behind that the queue is full the rest
+ * of the frames are dropped and counted in ww->dropped.
+ *
+ * @return  The number of frames accepted.
+ */
+int wav_writer_write(Wav_Writer *ww, const void *data, int len);
+
+/**
+ * Flushes the queue, stops the thread and fills in the header sizes. A file
+ * with more than 4 GB of data is written as RF64. The Wav_Writer struct is now invalid.
+ *
+ * @return  Zero if every block reached the file.
+ */
+int wav_writer_close(Wav_Writer *ww);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
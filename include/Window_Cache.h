@@ -0,0 +1,39 @@
+#ifndef _WINDOW_CACHE_H_
+#define _WINDOW_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum Window_Type {
+    WINDOW_NONE,      // uniform window, every coefficient is 1
+    WINDOW_TRIANGLE,
+    WINDOW_WELCH,
+    WINDOW_SINE,
+    WINDOW_HANN,
+    WINDOW_HAMMING,
+    WINDOW_BLACKMAN,
+    WINDOW_GAUSSIAN,  // uses parameter as delta
+    WINDOW_KAISER     // uses parameter as beta
+} Window_Type;
+
+// Returns a read-only table of window_size+1 coefficients, built once and
+// shared by every caller asking for the same (type, size, parameter).
+// The table is SIMD aligned and stays valid until window_cache_clear().
+const float *window_cache_get(Window_Type type, int window_size, float parameter);
+
+// Returns the matching table of 1/window coefficients for undoing a window
+// with a multiply. Zero coefficients map to 0. Valid until window_cache_clear().
+const float *window_cache_get_inverse(Window_Type type, int window_size, float parameter);
+
+// Fills data[] (window_size+1 long) from the cache instead of recomputing.
+int window_cache_copy(Window_Type type, int window_size, float parameter, float data[]);
+
+// Frees every cached table. Pointers handed out before this are invalid.
+void window_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,129 +1,215 @@
-/**
- * Copyright (c) 2015-2017, Martin Roth (mhroth@gmail.com)
- *
- * Permission to use, copy, modify, and/or distribute this software for any
- * purpose with or without fee is hereby granted, provided that the above
- * copyright notice and this permission notice appear in all copies.
- *
- * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
- * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
- * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
- * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
- * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
- * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
- * PERFORMANCE OF THIS SOFTWARE.
- */
-
-
-
-#ifndef _TINY_WAV_
-#define _TINY_WAV_
-
-#include <stdint.h>
-#include <stdio.h>
-#include <stdbool.h>
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-// http://soundfile.sapp.org/doc/WaveFormat/
-typedef struct TinyWavHeader {
-  uint32_t ChunkID;
-  uint32_t ChunkSize;
-  uint32_t Format;
-  uint32_t Subchunk1ID;
-  uint32_t Subchunk1Size;
-  uint16_t AudioFormat;
-  uint16_t NumChannels;
-  uint32_t SampleRate;
-  uint32_t ByteRate;
-  uint16_t BlockAlign;
-  uint16_t BitsPerSample;
-  uint32_t Subchunk2ID;
-  uint32_t Subchunk2Size;
-} TinyWavHeader;
-
-typedef enum TinyWavChannelFormat {
-  TW_INTERLEAVED, // channel buffer is interleaved e.g. [LRLRLRLR]
-  TW_INLINE,      // channel buffer is inlined e.g. [LLLLRRRR]
-  TW_SPLIT        // channel buffer is split e.g. [[LLLL],[RRRR]]
-} TinyWavChannelFormat;
-
-typedef enum TinyWavSampleFormat {
-  TW_INT16 = 2,  // two byte signed integer
-  TW_FLOAT32 = 4 // four byte IEEE float
-} TinyWavSampleFormat;
-
-typedef struct TinyWav {
-  FILE *f;
-  TinyWavHeader h;
-  int16_t numChannels;
-  uint32_t totalFramesWritten;
-  TinyWavChannelFormat chanFmt;
-  TinyWavSampleFormat sampFmt;
-} TinyWav;
-
-/**
- * Open a file for writing.
- *
- * @param numChannels  The number of channels to write.
- * @param samplerate   The sample rate of the audio.
- * @param sampFmt      The sample format (e.g. 16-bit integer or 32-bit float).
- * @param chanFmt      The channel format (how the channel data is layed out in memory)
- * @param path         The path of the file to write to. The file will be overwritten.
- *
- * @return  The error code. Zero if no error.
- */
-int tinywav_open_write(TinyWav *tw,
-    int16_t numChannels, int32_t samplerate,
-    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt,
-    const char *path);
-
-/**
- * Open a file for reading.
- *
- * @param sampFmt  The sample format (e.g. 16-bit integer or 32-bit float)
- *                 that the file should be converted to.
- * @param chanFmt  The channel format (how the channel data is layed out in memory) when read.
- * @param path     The path of the file to read.
- *
- * @return  The error code. Zero if no error.
- */
-int tinywav_open_read(TinyWav *tw, const char *path,
-    TinyWavChannelFormat chanFmt, TinyWavSampleFormat sampFmt);
-
-/**
- * Read sample data from the file.
- *
- * @param data  A pointer to the data structure to read to. This data is expected to have the
- *              correct memory layout to match the specifications given in tinywav_open_read().
- * @param len   The number of frames to read.
- */
-int tinywav_read_f(TinyWav *tw, void *data, int len);
-
-/** Stop reading the file. The Tinywav struct is now invalid. */
-void tinywav_close_read(TinyWav *tw);
-
-/**
- * Write sample data to file.
- *
- * @param tw   The TinyWav structure which has already been prepared.
- * @param f    A pointer to the sample data to write.
- * @param len  The number of frames to write.
- *
- * @return The total number of samples written to file.
- */
-size_t tinywav_write_f(TinyWav *tw, void *f, int len);
-
-/** Stop writing to the file. The Tinywav struct is now invalid. */
-void tinywav_close_write(TinyWav *tw);
-
-/** Returns true if the Tinywav struct is available to write or write. False otherwise. */
-bool tinywav_isOpen(TinyWav *tw);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif // _TINY_WAV_
+/**
+ * Copyright (c) 2015-2017, Martin Roth (mhroth@gmail.com)
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+
+#ifndef _TINY_WAV_
+#define _TINY_WAV_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// RF64/BW64 64-bit sizes (EBU Tech 3306). Written as a "JUNK" chunk of the same size
+// so a file can become RF64 on close without moving its data.
+typedef struct TinyWavDs64 {
+  uint32_t ChunkID;           // "JUNK" until the file needs 64-bit sizes, then "ds64"
+  uint32_t ChunkSize;         // 28
+  uint32_t RiffSizeLow;
+  uint32_t RiffSizeHigh;
+  uint32_t DataSizeLow;
+  uint32_t DataSizeHigh;
+  uint32_t SampleCountLow;
+  uint32_t SampleCountHigh;
+  uint32_t TableLength;       // no extra chunk sizes
+} TinyWavDs64;
+
+// http://soundfile.sapp.org/doc/WaveFormat/ with the ds64 placeholder before "fmt "
+typedef struct TinyWavHeader {
+  uint32_t ChunkID;
+  uint32_t ChunkSize;
+  uint32_t Format;
+  TinyWavDs64 Ds64;
+  uint32_t Subchunk1ID;
+  uint32_t Subchunk1Size;
+  uint16_t AudioFormat;
+  uint16_t NumChannels;
+  uint32_t SampleRate;
+  uint32_t ByteRate;
+  uint16_t BlockAlign;
+  uint16_t BitsPerSample;
+  uint32_t Subchunk2ID;
+  uint32_t Subchunk2Size;
+} TinyWavHeader;
+
+typedef enum TinyWavChannelFormat {
+  TW_INTERLEAVED, // channel buffer is interleaved e.g. [LRLRLRLR]
+  TW_INLINE,      // channel buffer is inlined e.g. [LLLLRRRR]
+  TW_SPLIT        // channel buffer is split e.g. [[LLLL],[RRRR]]
+} TinyWavChannelFormat;
+
+typedef enum TinyWavSampleFormat {
+  TW_INT16 = 2,   // two byte signed integer
+  TW_INT24 = 3,   // three byte signed integer, packed
+  TW_FLOAT32 = 4, // four byte IEEE float
+  TW_INT32 = 5    // four byte signed integer (the value is not its size, use tinywav_sample_bytes())
+} TinyWavSampleFormat;
+
+typedef struct TinyWav {
+  FILE *f;
+  TinyWavHeader h;
+  int16_t numChannels;
+  uint64_t totalFramesWritten; // frames written, or frames in the data chunk when reading
+  uint64_t totalFramesRead;
+  TinyWavChannelFormat chanFmt;
+  TinyWavSampleFormat sampFmt;
+} TinyWav;
+
+typedef struct TinyWavMap {
+  void *base;             // start of the mapped file
+  size_t length;          // bytes mapped
+  const uint8_t *data;    // first byte of the data chunk
+  uint64_t dataSize;      // bytes in the data chunk, from ds64 for RF64 files
+  uint64_t numFrames;     // frames in the data chunk
+  uint32_t sampleRate;
+  int16_t numChannels;
+  uint16_t audioFormat;   // 1 PCM, 3 IEEE float
+  uint16_t bitsPerSample;
+  uint16_t blockAlign;    // bytes per frame
+} TinyWavMap;
+
+/**
+ * Open a file for writing.
+ *
+ * @param numChannels  The number of channels to write.
+ * @param samplerate   The sample rate of the audio.
+ * @param sampFmt      The sample format (e.g. 16-bit integer or 32-bit float).
+ * @param chanFmt      The channel format (how the channel data is layed out in memory)
+ * @param path         The path of the file to write to. The file will be overwritten.
+ *
+ * @return  The error code. Zero if no error.
+ */
+int tinywav_open_write(TinyWav *tw,
+    int16_t numChannels, int32_t samplerate,
+    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt,
+    const char *path);
+
+/**
+ * Open a file for reading. 16, 24 and 32-bit PCM and 32-bit float files are
+ * read, the samples are always converted to float in [-1,1). RF64 and BW64
+ * files are read as well.
+ *
+ * @param sampFmt  Unused, samples are always read as 32-bit float. The format of the
+ *                 file itself is taken from its header and left in tw->sampFmt.
+ * @param chanFmt  The channel format (how the channel data is layed out in memory) when read.
+ * @param path     The path of the file to read.
+ *
+ * @return  The error code. Zero if no error.
+ */
+int tinywav_open_read(TinyWav *tw, const char *path,
+    TinyWavChannelFormat chanFmt, TinyWavSampleFormat sampFmt);
+
+/**
+ * Read sample data from the file as float.
+ *
+ * @param data  A pointer to the data structure to read to. This data is expected to have the
+ *              correct memory layout to match the specifications given in tinywav_open_read().
+ * @param len   The number of frames to read. With TW_INLINE it is also the length of each
+ *              channel's run, channel c starts at c*len even when fewer frames are left.
+ *
+ * @return  The number of frames read, less than len at the end of the data.
+ */
+int tinywav_read_f(TinyWav *tw, void *data, int len);
+
+/** Stop reading the file. The Tinywav struct is now invalid. */
+void tinywav_close_read(TinyWav *tw);
+
+/**
+ * Write float sample data to file, encoded in the sample format given to tinywav_open_write().
+ * Integer formats are rounded and clipped at full scale.
+ *
+ * @param tw   The TinyWav structure which has already been prepared.
+ * @param f    A pointer to the sample data to write.
+ * @param len  The number of frames to write.
+ *
+ * @return The total number of samples written to file.
+ */
+size_t tinywav_write_f(TinyWav *tw, void *f, int len);
+
+/**
+ * Stop writing to the file. The Tinywav struct is now invalid. A file with
+ * more than 4 GB of data is written as RF64.
+ */
+void tinywav_close_write(TinyWav *tw);
+
+/**
+ * Memory map a file for reading. Opening costs the same whatever the file size,
+ * pages are only read when the data is touched.
+ *
+ * @param path  The path of the file to map.
+ *
+ * @return  The error code. Zero if no error.
+ */
+int tinywav_map_open(TinyWavMap *map, const char *path);
+
+/**
+ * Direct pointer to the data of a frame, in the file's own sample format.
+ *
+ * @param frame  Index of the first frame wanted.
+ * @param count  Set to the number of frames available from that frame on. May be NULL.
+ *
+ * @return  Pointer into the mapping, NULL if frame is past the end.
+ */
+const void *tinywav_map_frame(const TinyWavMap *map, uint64_t frame, uint64_t *count);
+
+/**
+ * Zero copy view of interleaved float32 frames e.g. [LRLRLRLR].
+ *
+ * @return  Pointer into the mapping, NULL if the file is not 32-bit float or frame is past the end.
+ */
+const float *tinywav_map_frames_f(const TinyWavMap *map, uint64_t frame, uint64_t *count);
+
+/** Hint that frames [frame, frame+count) will be needed soon so the kernel reads them ahead. */
+void tinywav_map_willneed(const TinyWavMap *map, uint64_t frame, uint64_t count);
+
+/** Unmap the file. The TinyWavMap struct is now invalid. */
+void tinywav_map_close(TinyWavMap *map);
+
+/** Fill in the header tinywav_open_write() starts a file with, the two sizes are left at zero. */
+void tinywav_header(TinyWavHeader *h, int16_t numChannels, int32_t samplerate, TinyWavSampleFormat sampFmt);
+
+/**
+ * Fill in the sizes of a header for dataBytes bytes of sample data. Files whose
+ * RIFF size does not fit 32 bits become RF64, the 32-bit sizes are set to
+ * 0xFFFFFFFF and the real ones go in the ds64 chunk.
+ */
+void tinywav_header_sizes(TinyWavHeader *h, uint64_t dataBytes);
+
+/** Bytes one sample takes in the file. */
+int tinywav_sample_bytes(TinyWavSampleFormat sampFmt);
+
+/** Returns true if the Tinywav struct is available to write or write. False otherwise. */
+bool tinywav_isOpen(TinyWav *tw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TINY_WAV_
@@ -0,0 +1,96 @@
+//********************************************************************
+//*                    Complex Buffer                                *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Aligned interleaved complex sample buffers for      *
+//*             processing IQ data at baseband                       *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Complex_Buffer.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int complex_buffer_init(Complex_Buffer *b, int length);
+
+int complex_buffer_resize(Complex_Buffer *b, int length);
+
+int complex_buffer_from_real(Complex_Buffer *b, const float in[], int N);
+
+void complex_buffer_free(Complex_Buffer *b);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//fftwf_malloc gives the alignment FFTW's SIMD codelets and the vector kernels want
+int complex_buffer_init(Complex_Buffer *b, int length){
+
+    memset(b,0,sizeof(Complex_Buffer));
+    return complex_buffer_resize(b,length);
+}
+
+//Grows the allocation only when needed so a buffer reused block after block settles at its largest size
+int complex_buffer_resize(Complex_Buffer *b, int length){
+
+    if (length<0){
+        return -1;
+    }
+    if (length>b->capacity){
+        fftwf_complex *data=(fftwf_complex *) fftwf_malloc((size_t)length*sizeof(fftwf_complex));
+        if (data==NULL){
+            return -1;
+        }
+        if (b->length>0){
+            memcpy(data,b->data,(size_t)b->length*sizeof(fftwf_complex));
+        }
+        fftwf_free(b->data);
+        b->data=data;
+        b->capacity=length;
+    }
+    if (length>b->length){
+        memset(b->data+b->length,0,(size_t)(length-b->length)*sizeof(fftwf_complex));
+    }
+    b->length=length;
+    return 0;
+}
+
+//Real samples become re with im left at zero
+int complex_buffer_from_real(Complex_Buffer *b, const float in[], int N){
+
+    int i;
+    if (complex_buffer_resize(b,N)!=0){
+        return -1;
+    }
+    for (i=0;i<N;i++){
+        b->data[i][0]=in[i];
+        b->data[i][1]=0;
+    }
+    return 0;
+}
+
+//Frees the samples and clears the struct
+void complex_buffer_free(Complex_Buffer *b){
+
+    fftwf_free(b->data);
+    memset(b,0,sizeof(Complex_Buffer));
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
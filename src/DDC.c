@@ -0,0 +1,434 @@
+//********************************************************************
+//*                    DDC                                           *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Digital down converter, NCO mixer followed by CIC,  *
+//*             half-band and compensating FIR decimation            *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/DDC.h>
+#include <../include/Vector_Ops.h>
+#include <../include/Window_Cache.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define DDC_CHUNK          4096    //input samples mixed and filtered per pass
+#define DDC_HALFBAND_TAPS  31      //4k-1 taps so the centre tap is in the odd branch
+#define DDC_CFIR_TAPS      64      //final FIR taps per factor of its decimation, for the 0.4 to 0.5 transition at 80 dB
+#define DDC_CFIR_BETA      8.0     //Kaiser beta for about 80 dB of stop band
+#define DDC_PASS_EDGE      0.4     //of the output rate, flat up to here
+#define DDC_STOP_EDGE      0.5     //of the output rate, stopped from here
+#define DDC_MAX_BOOST      16.0    //largest droop correction the compensating FIR applies
+#define DDC_CIC_MAX        4096    //largest odd decimation the 64 bit CIC can take with 12 bits of input left
+#define DDC_CIC_MIN_RATIO  8       //the CIC stops at least this many times the output rate, its band edge aliases are then 100 dB down
+#define DDC_DESIGN_POINTS  1024    //integration points of the compensating FIR design
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int ddc_init(DDC *ddc, double sample_rate, double frequency, int decimation);
+
+void ddc_set_frequency(DDC *ddc, double frequency);
+
+int ddc_process(DDC *ddc, const fftwf_complex in[], int N, fftwf_complex out[]);
+
+int ddc_process_real(DDC *ddc, const float in[], int N, fftwf_complex out[]);
+
+void ddc_reset(DDC *ddc);
+
+void ddc_destroy(DDC *ddc);
+
+static int ddc_filter(DDC *ddc, int N, fftwf_complex out[]);
+
+static int fir_init(DDC_Fir *fir, const float h[], int L, int decimation);
+
+static int fir_process(DDC_Fir *fir, const fftwf_complex in[], int N, fftwf_complex out[]);
+
+static void fir_reset(DDC_Fir *fir);
+
+static void fir_free(DDC_Fir *fir);
+
+static void halfband_design(float h[], int L);
+
+static void compensator_design(float h[], int L, double rate, double cutoff, double cic_rate, int cic_decimation);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Splits the decimation into CIC, half-band and final FIR stages and designs their filters
+int ddc_init(DDC *ddc, double sample_rate, double frequency, int decimation){
+
+    float *h;
+    int halvings=0;
+    int odd=decimation;
+    int rest=1;
+    int last,taps,i;
+
+    memset(ddc,0,sizeof(DDC));
+    if (sample_rate<=0 || decimation<1){
+        return -1;
+    }
+    while (odd%2==0){
+        odd/=2;
+        halvings++;
+    }
+    if (odd>DDC_CIC_MAX || halvings>DDC_MAX_STAGES){
+        return -1;
+    }
+    //the CIC aliases around its own output rate, so it leaves the smallest odd factor that keeps that rate
+    //at least DDC_CIC_MIN_RATIO times the output rate for the final FIR, which can reject them
+    while (rest<odd && (odd%rest!=0 || ldexp(rest,halvings)<DDC_CIC_MIN_RATIO)){
+        rest++;
+    }
+    last= halvings>0 ? 2*rest : rest;
+    taps=DDC_CFIR_TAPS*last-1;
+    ddc->sample_rate=sample_rate;
+    ddc->decimation=decimation;
+    ddc->output_rate=sample_rate/decimation;
+    ddc->cic_decimation=odd/rest;
+    if (nco_init(&ddc->nco,NCO_POLY,sample_rate,0,0)!=0){
+        return -1;
+    }
+    ddc_set_frequency(ddc,frequency);
+
+    if (ddc->cic_decimation>1){
+        //the CIC gain is R^order, the input keeps whatever bits are left of the 64 bit integrators after that and a sign
+        int growth=DDC_CIC_ORDER*(int) ceil(log2(ddc->cic_decimation));
+        int bits= 61-growth<24 ? 61-growth : 24;
+        ddc->cic_in_scale=(float) ldexp(1,bits);
+        ddc->cic_out_scale=1/(ldexp(1,bits)*pow(ddc->cic_decimation,DDC_CIC_ORDER));
+    }
+
+    h=(float *) fftwf_malloc((size_t)(taps>DDC_HALFBAND_TAPS ? taps : DDC_HALFBAND_TAPS)*sizeof(float));
+    if (h==NULL){
+        return -1;
+    }
+    for (i=0;i<halvings-1;i++){
+        halfband_design(h,DDC_HALFBAND_TAPS);
+        if (fir_init(&ddc->fir[ddc->stages++],h,DDC_HALFBAND_TAPS,2)!=0){
+            fftwf_free(h);
+            ddc_destroy(ddc);
+            return -1;
+        }
+    }
+    //the last stage takes the odd factor the CIC left and the last factor of two, and undoes the CIC droop.
+    //Its ideal response ends midway between the edges, the window spreads that over the transition.
+    if (last>1){
+        double cutoff=0.5*(DDC_PASS_EDGE+DDC_STOP_EDGE)*ddc->output_rate;
+        compensator_design(h,taps,ddc->output_rate*last,cutoff,sample_rate,ddc->cic_decimation);
+        if (fir_init(&ddc->fir[ddc->stages++],h,taps,last)!=0){
+            fftwf_free(h);
+            ddc_destroy(ddc);
+            return -1;
+        }
+    }
+    fftwf_free(h);
+
+    ddc->work[0]=(fftwf_complex *) fftwf_malloc(DDC_CHUNK*sizeof(fftwf_complex));
+    ddc->work[1]=(fftwf_complex *) fftwf_malloc(DDC_CHUNK*sizeof(fftwf_complex));
+    if (ddc->work[0]==NULL || ddc->work[1]==NULL){
+        ddc_destroy(ddc);
+        return -1;
+    }
+    return 0;
+}
+
+//The mixer turns the wanted frequency down to 0 Hz
+void ddc_set_frequency(DDC *ddc, double frequency){
+
+    ddc->frequency=frequency;
+    nco_set_frequency(&ddc->nco,-frequency);
+}
+
+//Mixes and filters a chunk at a time so the work buffers never grow
+int ddc_process(DDC *ddc, const fftwf_complex in[], int N, fftwf_complex out[]){
+
+    int done=0;
+    int total=0;
+    while (done<N){
+        int n= N-done<DDC_CHUNK ? N-done : DDC_CHUNK;
+        nco_mix(&ddc->nco,in+done,ddc->work[0],n);
+        total+=ddc_filter(ddc,n,out+total);
+        done+=n;
+    }
+    return total;
+}
+
+//Real samples are multiplied by the complex oscillator, the image at minus the frequency is removed by the filters
+int ddc_process_real(DDC *ddc, const float in[], int N, fftwf_complex out[]){
+
+    int done=0;
+    int total=0;
+    while (done<N){
+        int n= N-done<DDC_CHUNK ? N-done : DDC_CHUNK;
+        nco_complex(&ddc->nco,ddc->work[0],n);
+        vector_multiply_real_complex(in+done,(const float (*)[2]) ddc->work[0],ddc->work[0],n);
+        total+=ddc_filter(ddc,n,out+total);
+        done+=n;
+    }
+    return total;
+}
+
+//Zeroes the filter state and restarts the mixer
+void ddc_reset(DDC *ddc){
+
+    int i;
+    ddc->nco.phase=0;
+    ddc->cic_phase=0;
+    memset(ddc->cic_state,0,sizeof(ddc->cic_state));
+    for (i=0;i<ddc->stages;i++){
+        fir_reset(&ddc->fir[i]);
+    }
+}
+
+//Frees every stage and the work buffers
+void ddc_destroy(DDC *ddc){
+
+    int i;
+    for (i=0;i<ddc->stages;i++){
+        fir_free(&ddc->fir[i]);
+    }
+    fftwf_free(ddc->work[0]);
+    fftwf_free(ddc->work[1]);
+    memset(ddc,0,sizeof(DDC));
+}
+
+//Runs a mixed chunk in work[0] through the decimators, the last stage writes straight to out
+static int ddc_filter(DDC *ddc, int N, fftwf_complex out[]){
+
+    fftwf_complex *x=ddc->work[0];
+    fftwf_complex *y=ddc->work[1];
+    int i;
+
+    if (ddc->cic_decimation>1){
+        N=vector_cic_decimate(ddc->cic_state,DDC_CIC_ORDER,ddc->cic_decimation,&ddc->cic_phase,
+                              ddc->cic_in_scale,ddc->cic_out_scale,(const float (*)[2]) x,y,N);
+        x=ddc->work[1];
+        y=ddc->work[0];
+    }
+    for (i=0;i<ddc->stages;i++){
+        fftwf_complex *target= i==ddc->stages-1 ? out : y;
+        N=fir_process(&ddc->fir[i],x,N,target);
+        y=x;
+        x=target;
+    }
+    if (x!=out){
+        memcpy(out,x,(size_t)N*sizeof(fftwf_complex));
+    }
+    return N;
+}
+
+//Splits h into polyphase branches, trims their zeros and stores them reversed for the dot products
+static int fir_init(DDC_Fir *fir, const float h[], int L, int decimation){
+
+    int r,q;
+
+    memset(fir,0,sizeof(DDC_Fir));
+    fir->decimation=decimation;
+    fir->taps=(float **) calloc(decimation,sizeof(float *));
+    fir->buffer=(fftwf_complex **) calloc(decimation,sizeof(fftwf_complex *));
+    fir->length=(int *) calloc(decimation,sizeof(int));
+    fir->delay=(int *) calloc(decimation,sizeof(int));
+    fir->fill=(int *) calloc(decimation,sizeof(int));
+    if (fir->taps==NULL || fir->buffer==NULL || fir->length==NULL || fir->delay==NULL || fir->fill==NULL){
+        fir_free(fir);
+        return -1;
+    }
+    for (r=0;r<decimation;r++){
+        int first=-1,last=-1;
+        for (q=0;q*decimation+r<L;q++){
+            if (h[q*decimation+r]!=0){
+                if (first<0){
+                    first=q;
+                }
+                last=q;
+            }
+        }
+        if (first<0){
+            continue;
+        }
+        fir->delay[r]=first;
+        fir->length[r]=last-first+1;
+        fir->taps[r]=(float *) fftwf_malloc(fir->length[r]*sizeof(float));
+        if (fir->taps[r]==NULL){
+            fir_free(fir);
+            return -1;
+        }
+        for (q=0;q<fir->length[r];q++){
+            fir->taps[r][q]=h[(last-q)*decimation+r];
+        }
+        if (last>fir->history){
+            fir->history=last;
+        }
+    }
+    for (r=0;r<decimation;r++){
+        if (fir->length[r]>0){
+            //a branch takes every decimation-th sample of a chunk, and may still hold one from before
+            fir->buffer[r]=(fftwf_complex *) fftwf_malloc((fir->history+DDC_CHUNK/decimation+2)*sizeof(fftwf_complex));
+            if (fir->buffer[r]==NULL){
+                fir_free(fir);
+                return -1;
+            }
+        }
+    }
+    fir_reset(fir);
+    return 0;
+}
+
+//Deals the samples out to the branches, then every complete output is a sum of one dot product per branch
+static int fir_process(DDC_Fir *fir, const fftwf_complex in[], int N, fftwf_complex out[]){
+
+    int i,k,r;
+    int count;
+
+    for (i=0;i<N;i++){
+        r= fir->phase==0 ? 0 : fir->decimation-fir->phase;   //sample nM-r belongs to output n
+        if (fir->buffer[r]!=NULL){
+            fir->buffer[r][fir->fill[r]][0]=in[i][0];
+            fir->buffer[r][fir->fill[r]][1]=in[i][1];
+        }
+        fir->fill[r]++;
+        fir->phase= fir->phase+1==fir->decimation ? 0 : fir->phase+1;
+    }
+
+    count=fir->fill[0]-fir->history; //an output is complete once its branch 0 sample has arrived
+    for (k=0;k<count;k++){
+        float sum[2]={0,0};
+        for (r=0;r<fir->decimation;r++){
+            if (fir->length[r]>0){
+                float part[2];
+                int start=fir->history+k-fir->delay[r]-fir->length[r]+1;
+                vector_dot_real_complex(fir->taps[r],(const float (*)[2]) (fir->buffer[r]+start),fir->length[r],part);
+                sum[0]+=part[0];
+                sum[1]+=part[1];
+            }
+        }
+        out[k][0]=sum[0];
+        out[k][1]=sum[1];
+    }
+
+    for (r=0;r<fir->decimation;r++){
+        if (fir->buffer[r]!=NULL){
+            memmove(fir->buffer[r],fir->buffer[r]+count,(size_t)(fir->fill[r]-count)*sizeof(fftwf_complex));
+        }
+        fir->fill[r]-=count;
+    }
+    return count;
+}
+
+//Fills the history with zeros
+static void fir_reset(DDC_Fir *fir){
+
+    int r;
+    for (r=0;r<fir->decimation;r++){
+        //the other branches start at output 1 with sample M-r, output 0 takes a zero from before the stream
+        fir->fill[r]= r==0 ? fir->history : fir->history+1;
+        if (fir->buffer[r]!=NULL){
+            memset(fir->buffer[r],0,fir->fill[r]*sizeof(fftwf_complex));
+        }
+    }
+    fir->phase=0;
+}
+
+static void fir_free(DDC_Fir *fir){
+
+    int r;
+    for (r=0;r<fir->decimation;r++){
+        if (fir->taps!=NULL){
+            fftwf_free(fir->taps[r]);
+        }
+        if (fir->buffer!=NULL){
+            fftwf_free(fir->buffer[r]);
+        }
+    }
+    free(fir->taps);
+    free(fir->buffer);
+    free(fir->length);
+    free(fir->delay);
+    free(fir->fill);
+    memset(fir,0,sizeof(DDC_Fir));
+}
+
+//Kaiser windowed sinc cut off at a quarter of the rate, every other tap is exactly zero
+static void halfband_design(float h[], int L){
+
+    const float *window=window_cache_get(WINDOW_KAISER,L-1,DDC_CFIR_BETA); //L points, the end points are not zero
+    int centre=(L-1)/2;
+    double sum=0;
+    int j;
+    for (j=0;j<L;j++){
+        int d=j-centre;
+        if (d==0 || d%2==0){
+            h[j]=0;
+        }
+        else{
+            h[j]=(float)(sin(M_PI*d/2)/(M_PI*d)*(window!=NULL ? window[j] : 1));
+            sum+=h[j];
+        }
+    }
+    for (j=0;j<L;j++){
+        h[j]=(float)(h[j]*0.5/sum);
+    }
+    h[centre]=0.5f;
+}
+
+//Kaiser windowed low pass whose passband is shaped by the inverse of the CIC response, found by integrating the wanted response
+static void compensator_design(float h[], int L, double rate, double cutoff, double cic_rate, int cic_decimation){
+
+    const float *window=window_cache_get(WINDOW_KAISER,L-1,DDC_CFIR_BETA); //L points, the end points are not zero
+    double response[DDC_DESIGN_POINTS];
+    double df=cutoff/DDC_DESIGN_POINTS;
+    double sum=0;
+    int centre=(L-1)/2;
+    int i,j;
+
+    for (i=0;i<DDC_DESIGN_POINTS;i++){
+        double f=(i+0.5)*df;
+        double gain=1;
+        if (cic_decimation>1){
+            double x=M_PI*f/cic_rate;
+            gain=pow(fabs(sin(cic_decimation*x)/(cic_decimation*sin(x))),DDC_CIC_ORDER);
+        }
+        response[i]= gain>1/DDC_MAX_BOOST ? 1/gain : DDC_MAX_BOOST;
+    }
+    for (j=centre;j<L;j++){ //the taps are symmetric, a large odd decimation makes them many so the cosines are rotated not called
+        double step=2*M_PI*df*(j-centre)/rate;
+        double c=cos(0.5*step),s=sin(0.5*step);
+        double dc=cos(step),ds=sin(step);
+        double tap=0;
+        for (i=0;i<DDC_DESIGN_POINTS;i++){
+            double t=c*dc-s*ds;
+            tap+=response[i]*c;
+            s=s*dc+c*ds;
+            c=t;
+        }
+        tap*=2*df/rate;
+        h[j]=(float)(tap*(window!=NULL ? window[j] : 1));
+        h[L-1-j]=h[j];
+    }
+    for (j=0;j<L;j++){
+        sum+=h[j];
+    }
+    for (j=0;j<L;j++){ //unity gain at 0 Hz, the CIC has none to undo there
+        h[j]=(float)(h[j]/sum);
+    }
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
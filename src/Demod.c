@@ -0,0 +1,288 @@
+//********************************************************************
+//*                    Demod                                         *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Streaming AM and FM demodulators from complex       *
+//*             baseband to audio                                    *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Demod.h>
+#include <../include/Vector_Ops.h>
+#include <math.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define DEMOD_CHUNK         4096    //input samples detected per pass
+#define AM_LOOP_BANDWIDTH   50.0    //Hz, Costas loop noise bandwidth
+#define AM_LOOP_DAMPING     0.707
+#define AM_DC_CORNER        20.0    //Hz, DC blocker corner at the audio rate
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int am_demod_init(AM_Demod *am, AM_Mode mode, int sample_rate, int audio_rate);
+
+int am_demod_max_output(const AM_Demod *am, int N);
+
+int am_demod_process(AM_Demod *am, const fftwf_complex in[], int N, float audio[]);
+
+void am_demod_reset(AM_Demod *am);
+
+void am_demod_destroy(AM_Demod *am);
+
+static void costas_detect(AM_Demod *am, const fftwf_complex in[], int N, float out[]);
+
+static void dc_block(AM_Demod *am, float data[], int N);
+
+int fm_demod_init(FM_Demod *fm, int sample_rate, int audio_rate, double deviation, double deemphasis);
+
+int fm_demod_max_output(const FM_Demod *fm, int N);
+
+int fm_demod_process(FM_Demod *fm, const fftwf_complex in[], int N, float audio[]);
+
+void fm_demod_reset(FM_Demod *fm);
+
+void fm_demod_destroy(FM_Demod *fm);
+
+static void deemphasise(FM_Demod *fm, float data[], int N);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Second order loop gains from the noise bandwidth, the phase detector has unit gain near lock
+int am_demod_init(AM_Demod *am, AM_Mode mode, int sample_rate, int audio_rate){
+
+    double theta,d;
+
+    memset(am,0,sizeof(AM_Demod));
+    if (sample_rate<=0 || audio_rate<=0 || audio_rate>sample_rate
+        || (mode!=AM_ENVELOPE && mode!=AM_SYNCHRONOUS)){
+        return -1;
+    }
+    am->mode=mode;
+    am->sample_rate=sample_rate;
+    am->audio_rate=audio_rate;
+    theta=AM_LOOP_BANDWIDTH/sample_rate/(AM_LOOP_DAMPING+0.25/AM_LOOP_DAMPING);
+    d=1+2*AM_LOOP_DAMPING*theta+theta*theta;
+    am->gain_p=(float)(4*AM_LOOP_DAMPING*theta/d);
+    am->gain_i=(float)(4*theta*theta/d);
+    am->dc_pole=(float)exp(-2*M_PI*AM_DC_CORNER/audio_rate);
+
+    am->work=(float *) fftwf_malloc(DEMOD_CHUNK*sizeof(float));
+    if (am->work==NULL){
+        return -1;
+    }
+    if (audio_rate!=sample_rate){
+        if (resampler_init(&am->audio,sample_rate,audio_rate)!=0){
+            am_demod_destroy(am);
+            return -1;
+        }
+        am->resample=1;
+    }
+    am_demod_reset(am);
+    return 0;
+}
+
+int am_demod_max_output(const AM_Demod *am, int N){
+
+    return am->resample ? resampler_max_output(&am->audio,N) : N;
+}
+
+//Detects a chunk at the input rate, decimates it to audio and takes the carrier's DC out
+int am_demod_process(AM_Demod *am, const fftwf_complex in[], int N, float audio[]){
+
+    int done=0;
+    int count=0;
+    while (done<N){
+        int n= N-done<DEMOD_CHUNK ? N-done : DEMOD_CHUNK;
+        float *detected= am->resample ? am->work : audio+count;
+        int made;
+        if (am->mode==AM_ENVELOPE){
+            vector_complex_magnitude((const float (*)[2]) (in+done),detected,n);
+        }
+        else {
+            costas_detect(am,in+done,n,detected);
+        }
+        made= am->resample ? resampler_process(&am->audio,am->work,n,audio+count) : n;
+        dc_block(am,audio+count,made);
+        count+=made;
+        done+=n;
+    }
+    return count;
+}
+
+void am_demod_reset(AM_Demod *am){
+
+    am->phasor[0]=1;
+    am->phasor[1]=0;
+    am->frequency=0;
+    am->dc_in=0;
+    am->dc_out=0;
+    if (am->resample){
+        resampler_reset(&am->audio);
+    }
+}
+
+void am_demod_destroy(AM_Demod *am){
+
+    fftwf_free(am->work);
+    if (am->resample){
+        resampler_destroy(&am->audio);
+    }
+    memset(am,0,sizeof(AM_Demod));
+}
+
+//Costas loop: mixes by the recovered carrier and steers it with I*Q, normalised so the
+//loop bandwidth does not depend on the signal level. The in-phase arm is the audio.
+//The phasor turns by a small angle approximation and is pulled back to unit length every sample.
+static void costas_detect(AM_Demod *am, const fftwf_complex in[], int N, float out[]){
+
+    float pr=am->phasor[0],pi=am->phasor[1];
+    float frequency=am->frequency;
+    int i;
+    for (i=0;i<N;i++){
+        float re=in[i][0]*pr-in[i][1]*pi;
+        float im=in[i][0]*pi+in[i][1]*pr;
+        float error=re*im/(re*re+im*im+1e-30f);
+        float step,c,s,nr,ni,norm;
+        out[i]=re;
+        frequency+=am->gain_i*error;
+        step=-(frequency+am->gain_p*error);
+        c=1-0.5f*step*step;
+        s=step;
+        nr=pr*c-pi*s;
+        ni=pr*s+pi*c;
+        norm=1.5f-0.5f*(nr*nr+ni*ni);
+        pr=nr*norm;
+        pi=ni*norm;
+    }
+    am->phasor[0]=pr;
+    am->phasor[1]=pi;
+    am->frequency=frequency;
+}
+
+//y[n] = x[n] - x[n-1] + pole*y[n-1], a notch at 0 Hz
+static void dc_block(AM_Demod *am, float data[], int N){
+
+    float last_in=am->dc_in,last_out=am->dc_out;
+    int i;
+    for (i=0;i<N;i++){
+        float x=data[i];
+        last_out=x-last_in+am->dc_pole*last_out;
+        last_in=x;
+        data[i]=last_out;
+    }
+    am->dc_in=last_in;
+    am->dc_out=last_out;
+}
+
+//Discriminator gain turns the phase step at full deviation into 1, the de-emphasis is
+//1/(1+s tau) by the bilinear transform, prewarped so its corner lands at 1/(2 pi tau)
+int fm_demod_init(FM_Demod *fm, int sample_rate, int audio_rate, double deviation, double deemphasis){
+
+    memset(fm,0,sizeof(FM_Demod));
+    if (sample_rate<=0 || audio_rate<=0 || audio_rate>sample_rate || deviation<=0 || deemphasis<0){
+        return -1;
+    }
+    fm->sample_rate=sample_rate;
+    fm->audio_rate=audio_rate;
+    fm->deviation=deviation;
+    fm->gain=(float)(sample_rate/(2*M_PI*deviation));
+    if (deemphasis>0){
+        double k=tan(1/(2*deemphasis*audio_rate));
+        fm->deemphasis=1;
+        fm->deemph_b=(float)(k/(1+k));
+        fm->deemph_a=(float)((k-1)/(1+k));
+    }
+
+    fm->work=(float *) fftwf_malloc(DEMOD_CHUNK*sizeof(float));
+    if (fm->work==NULL){
+        return -1;
+    }
+    if (audio_rate!=sample_rate){
+        if (resampler_init(&fm->audio,sample_rate,audio_rate)!=0){
+            fm_demod_destroy(fm);
+            return -1;
+        }
+        fm->resample=1;
+    }
+    fm_demod_reset(fm);
+    return 0;
+}
+
+int fm_demod_max_output(const FM_Demod *fm, int N){
+
+    return fm->resample ? resampler_max_output(&fm->audio,N) : N;
+}
+
+//Discriminates a chunk at the input rate, decimates it to audio and de-emphasises at the audio rate
+int fm_demod_process(FM_Demod *fm, const fftwf_complex in[], int N, float audio[]){
+
+    int done=0;
+    int count=0;
+    while (done<N){
+        int n= N-done<DEMOD_CHUNK ? N-done : DEMOD_CHUNK;
+        float *phase= fm->resample ? fm->work : audio+count;
+        int made;
+        vector_fm_discriminate((const float (*)[2]) (in+done),fm->previous,phase,n,fm->gain);
+        made= fm->resample ? resampler_process(&fm->audio,fm->work,n,audio+count) : n;
+        if (fm->deemphasis){
+            deemphasise(fm,audio+count,made);
+        }
+        count+=made;
+        done+=n;
+    }
+    return count;
+}
+
+void fm_demod_reset(FM_Demod *fm){
+
+    fm->previous[0]=0;
+    fm->previous[1]=0;
+    fm->deemph_in=0;
+    fm->deemph_out=0;
+    if (fm->resample){
+        resampler_reset(&fm->audio);
+    }
+}
+
+void fm_demod_destroy(FM_Demod *fm){
+
+    fftwf_free(fm->work);
+    if (fm->resample){
+        resampler_destroy(&fm->audio);
+    }
+    memset(fm,0,sizeof(FM_Demod));
+}
+
+//y[n] = b*(x[n]+x[n-1]) - a*y[n-1]
+static void deemphasise(FM_Demod *fm, float data[], int N){
+
+    float last_in=fm->deemph_in,last_out=fm->deemph_out;
+    int i;
+    for (i=0;i<N;i++){
+        float x=data[i];
+        last_out=fm->deemph_b*(x+last_in)-fm->deemph_a*last_out;
+        last_in=x;
+        data[i]=last_out;
+    }
+    fm->deemph_in=last_in;
+    fm->deemph_out=last_out;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,426 @@
+//********************************************************************
+//*                    FFT Plan                                      *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Cache of FFTW plans with wisdom kept on disk so     *
+//*             transforms are only measured once per host           *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/tinywav.h>
+#include <../include/FFT_Plan.h>
+#include <fftw3.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define FFT_PLAN_FLAGS FFTW_MEASURE
+#define WISDOM_PATH_LENGTH 512
+#define FFT_THREAD_THRESHOLD (1<<18) //points per execution before threading pays for its start up cost
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+typedef struct Plan_Entry {
+    int N;
+    int howmany;
+    TinyWavChannelFormat layout;
+    FFT_Kind kind;
+    int inplace;
+    int aligned;
+    int threads;
+    fftwf_plan plan;
+    struct Plan_Entry *next;
+} Plan_Entry;
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+static Plan_Entry *plan_list=NULL;
+static pthread_mutex_t planner_lock = PTHREAD_MUTEX_INITIALIZER; //FFTW's planner is not thread safe, every planner call is made under this lock
+static pthread_mutex_t plan_lock = PTHREAD_MUTEX_INITIALIZER; //guards plan_list and the thread settings, taken after planner_lock and never held while planning
+static char wisdom_file[WISDOM_PATH_LENGTH];
+static pthread_t premeasure_thread;
+static int premeasure_running=0;
+static volatile int premeasure_stop=0;
+static int fft_threads=1;
+static int fft_threads_ready=0;
+static int fft_thread_threshold=FFT_THREAD_THRESHOLD;
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int fft_plan_cache_init(const char *wisdom_path);
+
+int fft_plan_cache_save(void);
+
+void fft_plan_cache_shutdown(void);
+
+int fft_threads_init(int nthreads);
+
+void fft_threads_set_threshold(int points);
+
+fftwf_plan fft_plan_get(int N, FFT_Kind kind, const void *in, const void *out);
+
+fftwf_plan fft_plan_many(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, const void *in, const void *out);
+
+int fft_execute_many_r2c(int N, int howmany, TinyWavChannelFormat layout, float *in, fftwf_complex *out);
+
+int fft_execute_many_c2r(int N, int howmany, TinyWavChannelFormat layout, fftwf_complex *in, float *out);
+
+int fft_execute_c2c(int N, FFT_Kind kind, fftwf_complex *in, fftwf_complex *out);
+
+int fft_execute_many_c2c(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, fftwf_complex *in, fftwf_complex *out);
+
+int fft_plan_premeasure(const int sizes[], int count);
+
+void fft_plan_premeasure_wait(void);
+
+static fftwf_plan plan_lookup(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, int inplace, int aligned);
+
+static fftwf_plan plan_find(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, int inplace, int aligned, int threads);
+
+static fftwf_plan plan_create(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, int inplace, int aligned, int threads);
+
+static void *premeasure_run(void *arg);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Picks the wisdom file and imports any wisdom saved by an earlier run
+int fft_plan_cache_init(const char *wisdom_path){
+
+    int loaded;
+    if (wisdom_path!=NULL){
+        snprintf(wisdom_file,sizeof(wisdom_file),"%s",wisdom_path);
+    }
+    else{
+        char host[128];
+        const char *home=getenv("HOME");
+        if (gethostname(host,sizeof(host))!=0){
+            strcpy(host,"localhost");
+        }
+        host[sizeof(host)-1]='\0';
+        snprintf(wisdom_file,sizeof(wisdom_file),"%s/.sdr-fftwf-%s.wisdom",home!=NULL ? home : ".",host);
+    }
+
+    pthread_mutex_lock(&planner_lock);
+    loaded=fftwf_import_wisdom_from_filename(wisdom_file);
+    pthread_mutex_unlock(&planner_lock);
+    return loaded ? 0 : -1;
+}
+
+//Exports everything the planner has learnt so the next start does not measure again
+int fft_plan_cache_save(void){
+
+    int saved;
+    if (wisdom_file[0]=='\0'){
+        return -1;
+    }
+    pthread_mutex_lock(&planner_lock);
+    saved=fftwf_export_wisdom_to_filename(wisdom_file);
+    pthread_mutex_unlock(&planner_lock);
+    return saved ? 0 : -1;
+}
+
+//Saves wisdom and frees every cached plan
+void fft_plan_cache_shutdown(void){
+
+    premeasure_stop=1;
+    fft_plan_premeasure_wait();
+    premeasure_stop=0;
+    fft_plan_cache_save();
+
+    pthread_mutex_lock(&planner_lock);
+    pthread_mutex_lock(&plan_lock);
+    while (plan_list!=NULL){
+        Plan_Entry *next=plan_list->next;
+        fftwf_destroy_plan(plan_list->plan);
+        free(plan_list);
+        plan_list=next;
+    }
+    if (fft_threads_ready){
+        fftwf_cleanup_threads();
+        fft_threads_ready=0;
+        fft_threads=1;
+    }
+    pthread_mutex_unlock(&plan_lock);
+    pthread_mutex_unlock(&planner_lock);
+}
+
+//Turns on FFTW's threaded transforms, nthreads of 0 uses every online core
+int fft_threads_init(int nthreads){
+
+    if (nthreads<=0){
+        nthreads=(int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (nthreads<1){
+        nthreads=1;
+    }
+    pthread_mutex_lock(&planner_lock);
+    if (nthreads>1 && !fft_threads_ready){
+        if (!fftwf_init_threads()){
+            pthread_mutex_unlock(&planner_lock);
+            return -1;
+        }
+        fft_threads_ready=1;
+    }
+    pthread_mutex_lock(&plan_lock);
+    fft_threads=nthreads;
+    pthread_mutex_unlock(&plan_lock);
+    pthread_mutex_unlock(&planner_lock);
+    return 0;
+}
+
+//Sets how many points one execution needs before it is planned threaded
+void fft_threads_set_threshold(int points){
+
+    pthread_mutex_lock(&plan_lock);
+    fft_thread_threshold=points;
+    pthread_mutex_unlock(&plan_lock);
+}
+
+//Returns a plan matching the layout of in and out, creating it if this is the first time it is needed
+fftwf_plan fft_plan_get(int N, FFT_Kind kind, const void *in, const void *out){
+
+    return fft_plan_many(N,1,TW_INLINE,kind,in,out);
+}
+
+//Returns a plan doing howmany transforms of length N in one execution, laid out like tinywav channel buffers
+fftwf_plan fft_plan_many(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, const void *in, const void *out){
+
+    int inplace=(in==out);
+    int aligned=(fftwf_alignment_of((float *) in)==0 && fftwf_alignment_of((float *) out)==0);
+    if (N<1 || howmany<1 || layout==TW_SPLIT || (inplace && layout==TW_INTERLEAVED && howmany>1)){
+        return NULL;
+    }
+    if (howmany==1){ //a single transform has the same plan whatever the channel layout
+        layout=TW_INLINE;
+    }
+    return plan_lookup(N,howmany,layout,kind,inplace,aligned);
+}
+
+//Transforms every channel of a real multi channel block with one plan execution
+int fft_execute_many_r2c(int N, int howmany, TinyWavChannelFormat layout, float *in, fftwf_complex *out){
+
+    fftwf_plan plan=fft_plan_many(N,howmany,layout,FFT_R2C,in,out);
+    if (plan==NULL){
+        return -1;
+    }
+    fftwf_execute_dft_r2c(plan,in,out);
+    return 0;
+}
+
+//Inverse of fft_execute_many_r2c, unnormalised like FFTW
+int fft_execute_many_c2r(int N, int howmany, TinyWavChannelFormat layout, fftwf_complex *in, float *out){
+
+    fftwf_plan plan=fft_plan_many(N,howmany,layout,FFT_C2R,in,out);
+    if (plan==NULL){
+        return -1;
+    }
+    fftwf_execute_dft_c2r(plan,in,out);
+    return 0;
+}
+
+//Transforms one complex block, the baseband counterpart of an r2c plan
+int fft_execute_c2c(int N, FFT_Kind kind, fftwf_complex *in, fftwf_complex *out){
+
+    return fft_execute_many_c2c(N,1,TW_INLINE,kind,in,out);
+}
+
+//Transforms every channel of a complex multi channel block with one plan execution
+int fft_execute_many_c2c(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, fftwf_complex *in, fftwf_complex *out){
+
+    fftwf_plan plan;
+    if (kind!=FFT_FORWARD && kind!=FFT_BACKWARD){
+        return -1;
+    }
+    plan=fft_plan_many(N,howmany,layout,kind,in,out);
+    if (plan==NULL){
+        return -1;
+    }
+    fftwf_execute_dft(plan,in,out);
+    return 0;
+}
+
+//Starts planning the given sizes in the background
+int fft_plan_premeasure(const int sizes[], int count){
+
+    int *list;
+    fft_plan_premeasure_wait();
+
+    list=(int *) malloc((count+1)*sizeof(int));
+    if (list==NULL){
+        return -1;
+    }
+    list[0]=count;
+    memcpy(list+1,sizes,count*sizeof(int));
+    if (pthread_create(&premeasure_thread,NULL,premeasure_run,list)!=0){
+        free(list);
+        return -1;
+    }
+    premeasure_running=1;
+    return 0;
+}
+
+//Joins the background planner if it is running
+void fft_plan_premeasure_wait(void){
+
+    if (premeasure_running){
+        pthread_join(premeasure_thread,NULL);
+        premeasure_running=0;
+    }
+}
+
+//Looks a plan up by key, planning it when missing. Measuring can take seconds so it holds only
+//planner_lock, lookups of cached plans keep going meanwhile. The key is checked again once
+//planner_lock is held in case another thread planned it while this one waited.
+static fftwf_plan plan_lookup(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, int inplace, int aligned){
+
+    Plan_Entry *entry;
+    fftwf_plan plan;
+    int threads;
+
+    pthread_mutex_lock(&plan_lock);
+    //small transforms finish before worker threads would get going, keep them serial
+    threads=((double)N*howmany>=fft_thread_threshold) ? fft_threads : 1;
+    plan=plan_find(N,howmany,layout,kind,inplace,aligned,threads);
+    pthread_mutex_unlock(&plan_lock);
+    if (plan!=NULL){
+        return plan;
+    }
+
+    pthread_mutex_lock(&planner_lock);
+    pthread_mutex_lock(&plan_lock);
+    plan=plan_find(N,howmany,layout,kind,inplace,aligned,threads);
+    pthread_mutex_unlock(&plan_lock);
+    if (plan!=NULL){
+        pthread_mutex_unlock(&planner_lock);
+        return plan;
+    }
+
+    plan=plan_create(N,howmany,layout,kind,inplace,aligned,threads);
+    entry=(Plan_Entry *) malloc(sizeof(Plan_Entry));
+    if (plan==NULL || entry==NULL){
+        if (plan!=NULL){
+            fftwf_destroy_plan(plan);
+        }
+        free(entry);
+        pthread_mutex_unlock(&planner_lock);
+        return NULL;
+    }
+    entry->N=N;
+    entry->howmany=howmany;
+    entry->layout=layout;
+    entry->kind=kind;
+    entry->inplace=inplace;
+    entry->aligned=aligned;
+    entry->threads=threads;
+    entry->plan=plan;
+    pthread_mutex_lock(&plan_lock);
+    entry->next=plan_list;
+    plan_list=entry;
+    pthread_mutex_unlock(&plan_lock);
+    pthread_mutex_unlock(&planner_lock);
+
+    return plan;
+}
+
+//Searches the cached plans, the caller holds plan_lock
+static fftwf_plan plan_find(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, int inplace, int aligned, int threads){
+
+    Plan_Entry *entry;
+    for (entry=plan_list;entry!=NULL;entry=entry->next){
+        if (entry->N==N && entry->howmany==howmany && entry->layout==layout && entry->kind==kind
+            && entry->inplace==inplace && entry->aligned==aligned && entry->threads==threads){
+            return entry->plan;
+        }
+    }
+    return NULL;
+}
+
+//Measures a plan on scratch buffers so caller data is never overwritten by the planner
+static fftwf_plan plan_create(int N, int howmany, TinyWavChannelFormat layout, FFT_Kind kind, int inplace, int aligned, int threads){
+
+    fftwf_plan plan=NULL;
+    unsigned flags=FFT_PLAN_FLAGS | (aligned ? 0 : FFTW_UNALIGNED);
+    int complex_kind=(kind==FFT_FORWARD || kind==FFT_BACKWARD);
+    int bins=complex_kind ? N : N/2+1;
+    int real_length=inplace ? 2*bins : N;   //in place real rows are padded to the complex row length
+    size_t bytes=(size_t)howmany*bins*sizeof(fftwf_complex);
+    int real_stride,real_dist,complex_stride,complex_dist;
+    float *in,*out;
+
+    //TW_INLINE keeps each transform contiguous [LLLLRRRR], TW_INTERLEAVED steps across channels [LRLRLRLR]
+    if (layout==TW_INTERLEAVED){
+        real_stride=howmany;  real_dist=1;
+        complex_stride=howmany; complex_dist=1;
+    }
+    else{
+        real_stride=1;    real_dist=complex_kind ? N : real_length;
+        complex_stride=1; complex_dist=bins;
+    }
+
+    in=(float *) fftwf_malloc(bytes);
+    out=inplace ? in : (float *) fftwf_malloc(bytes);
+    if (in==NULL || out==NULL){
+        fftwf_free(in);
+        if (!inplace){
+            fftwf_free(out);
+        }
+        return NULL;
+    }
+
+    if (fft_threads_ready){ //only callable once fftwf_init_threads has run
+        fftwf_plan_with_nthreads(threads);
+    }
+    switch (kind){
+        case FFT_R2C:
+            plan=fftwf_plan_many_dft_r2c(1,&N,howmany,in,NULL,real_stride,real_dist,
+                                         (fftwf_complex *) out,NULL,complex_stride,complex_dist,flags);
+            break;
+        case FFT_C2R:
+            plan=fftwf_plan_many_dft_c2r(1,&N,howmany,(fftwf_complex *) in,NULL,complex_stride,complex_dist,
+                                         out,NULL,real_stride,real_dist,flags);
+            break;
+        case FFT_FORWARD:
+        case FFT_BACKWARD:
+            plan=fftwf_plan_many_dft(1,&N,howmany,(fftwf_complex *) in,NULL,complex_stride,complex_dist,
+                                     (fftwf_complex *) out,NULL,complex_stride,complex_dist,
+                                     kind==FFT_FORWARD ? FFTW_FORWARD : FFTW_BACKWARD,flags);
+            break;
+    }
+
+    fftwf_free(in);
+    if (!inplace){
+        fftwf_free(out);
+    }
+    return plan;
+}
+
+//Background thread body, plans each requested size for both real directions
+static void *premeasure_run(void *arg){
+
+    int *list=(int *) arg;
+    int i;
+    for (i=1;i<=list[0] && !premeasure_stop;i++){
+        plan_lookup(list[i],1,TW_INLINE,FFT_R2C,0,1);
+        plan_lookup(list[i],1,TW_INLINE,FFT_C2R,0,1);
+    }
+    free(list);
+    return NULL;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
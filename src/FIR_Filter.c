@@ -0,0 +1,296 @@
+//********************************************************************
+//*                    FIR Filter                                    *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Streaming FIR filter, direct form for short filters *
+//*             and partitioned overlap-save for long ones           *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/FIR_Filter.h>
+#include <../include/FFT_Plan.h>
+#include <../include/Vector_Ops.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define FIR_CHUNK           4096    //direct form samples appended to the history per pass
+#define FIR_MAX_LENGTH      (1<<20) //longest filter accepted
+#define FIR_ALIGN           8       //complex values, keeps every spectrum of the delay line 64 byte aligned
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int fir_filter_init(FIR_Filter *f, const float taps[], int length, int complex_data, FIR_Method method, int block);
+
+int fir_filter_process(FIR_Filter *f, const float in[], int N, float out[]);
+
+int fir_filter_process_c(FIR_Filter *f, const fftwf_complex in[], int N, fftwf_complex out[]);
+
+void fir_filter_reset(FIR_Filter *f);
+
+void fir_filter_destroy(FIR_Filter *f);
+
+static int direct_init(FIR_Filter *f, const float taps[]);
+
+static int partitioned_init(FIR_Filter *f, const float taps[]);
+
+static void fft_forward(FIR_Filter *f, float *in, fftwf_complex *out);
+
+static void direct_process(FIR_Filter *f, const float *in, int N, float *out);
+
+static void partitioned_process(FIR_Filter *f, const float *in, int N, float *out);
+
+static void partitioned_block(FIR_Filter *f);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Picks the method and block size then sets up the history or the spectra
+int fir_filter_init(FIR_Filter *f, const float taps[], int length, int complex_data, FIR_Method method, int block){
+
+    memset(f,0,sizeof(FIR_Filter));
+    if (taps==NULL || length<=0 || length>FIR_MAX_LENGTH || block<0){
+        return -1;
+    }
+    f->complex_data=complex_data!=0;
+    f->length=length;
+    if (method==FIR_AUTO){
+        method= length<=FIR_DIRECT_MAX ? FIR_DIRECT : FIR_OVERLAP_SAVE;
+    }
+    f->method=method;
+
+    switch (method){
+    case FIR_DIRECT:
+        return direct_init(f,taps);
+    case FIR_OVERLAP_SAVE:
+        //a power of two block that holds the whole filter, one partition
+        for (f->block=1;f->block<length;f->block*=2);
+        break;
+    case FIR_PARTITIONED:
+        f->block= block>0 ? block : FIR_DEFAULT_BLOCK;
+        break;
+    default:
+        return -1;
+    }
+    return partitioned_init(f,taps);
+}
+
+//Real samples in and out, the output lags by f->latency samples
+int fir_filter_process(FIR_Filter *f, const float in[], int N, float out[]){
+
+    if (f->complex_data || N<0){
+        return -1;
+    }
+    if (f->method==FIR_DIRECT){
+        direct_process(f,in,N,out);
+    }
+    else {
+        partitioned_process(f,in,N,out);
+    }
+    return 0;
+}
+
+//Complex samples through the same real taps
+int fir_filter_process_c(FIR_Filter *f, const fftwf_complex in[], int N, fftwf_complex out[]){
+
+    if (!f->complex_data || N<0){
+        return -1;
+    }
+    if (f->method==FIR_DIRECT){
+        direct_process(f,(const float *) in,N,(float *) out);
+    }
+    else {
+        partitioned_process(f,(const float *) in,N,(float *) out);
+    }
+    return 0;
+}
+
+//Zero history, zero spectra, and zero output until the first block is through
+void fir_filter_reset(FIR_Filter *f){
+
+    int width= f->complex_data ? 2 : 1;
+    if (f->method==FIR_DIRECT){
+        memset(f->history,0,(size_t)(f->length-1)*width*sizeof(float));
+        return;
+    }
+    memset(f->time,0,(size_t)2*f->block*width*sizeof(float));
+    memset(f->result,0,(size_t)2*f->block*width*sizeof(float));
+    memset(f->delay_line,0,(size_t)f->partitions*f->stride*sizeof(fftwf_complex));
+    f->newest=0;
+    f->fill=0;
+}
+
+void fir_filter_destroy(FIR_Filter *f){
+
+    fftwf_free(f->taps);
+    fftwf_free(f->history);
+    fftwf_free(f->spectra);
+    fftwf_free(f->delay_line);
+    fftwf_free(f->accumulator);
+    fftwf_free(f->time);
+    fftwf_free(f->result);
+    memset(f,0,sizeof(FIR_Filter));
+}
+
+//Reversed taps so each output is one dot product over the newest samples
+static int direct_init(FIR_Filter *f, const float taps[]){
+
+    int width= f->complex_data ? 2 : 1;
+    int i;
+    f->taps=(float *) fftwf_malloc((size_t)f->length*sizeof(float));
+    f->history=(float *) fftwf_malloc((size_t)(f->length-1+FIR_CHUNK)*width*sizeof(float));
+    if (f->taps==NULL || f->history==NULL){
+        fir_filter_destroy(f);
+        return -1;
+    }
+    for (i=0;i<f->length;i++){
+        f->taps[i]=taps[f->length-1-i];
+    }
+    fir_filter_reset(f);
+    return 0;
+}
+
+//Transforms each block of taps, zero padded to 2B, once; 1/2B undoes the unnormalised inverse
+static int partitioned_init(FIR_Filter *f, const float taps[]){
+
+    int width= f->complex_data ? 2 : 1;
+    int B=f->block;
+    int p,i;
+    f->partitions=(f->length+B-1)/B;
+    f->bins= f->complex_data ? 2*B : B+1;
+    f->stride=(f->bins+FIR_ALIGN-1)/FIR_ALIGN*FIR_ALIGN;
+    f->latency=B;
+    f->spectra=(fftwf_complex *) fftwf_malloc((size_t)f->partitions*f->stride*sizeof(fftwf_complex));
+    f->delay_line=(fftwf_complex *) fftwf_malloc((size_t)f->partitions*f->stride*sizeof(fftwf_complex));
+    f->accumulator=(fftwf_complex *) fftwf_malloc((size_t)f->stride*sizeof(fftwf_complex));
+    f->time=(float *) fftwf_malloc((size_t)2*B*width*sizeof(float));
+    f->result=(float *) fftwf_malloc((size_t)2*B*width*sizeof(float));
+    if (f->spectra==NULL || f->delay_line==NULL || f->accumulator==NULL || f->time==NULL || f->result==NULL){
+        fir_filter_destroy(f);
+        return -1;
+    }
+    if (f->complex_data){
+        f->forward=fft_plan_get(2*B,FFT_FORWARD,f->time,f->delay_line);
+        f->backward=fft_plan_get(2*B,FFT_BACKWARD,f->accumulator,f->result);
+    }
+    else {
+        f->forward=fft_plan_get(2*B,FFT_R2C,f->time,f->delay_line);
+        f->backward=fft_plan_get(2*B,FFT_C2R,f->accumulator,f->result);
+    }
+    if (f->forward==NULL || f->backward==NULL){
+        fir_filter_destroy(f);
+        return -1;
+    }
+
+    for (p=0;p<f->partitions;p++){
+        fftwf_complex *spectrum=f->spectra+(size_t)p*f->stride;
+        memset(f->time,0,(size_t)2*B*width*sizeof(float));
+        for (i=0;i<B && p*B+i<f->length;i++){
+            f->time[i*width]=taps[p*B+i]/(2.0f*B);
+        }
+        fft_forward(f,f->time,spectrum);
+    }
+    fir_filter_reset(f);
+    return 0;
+}
+
+static void fft_forward(FIR_Filter *f, float *in, fftwf_complex *out){
+
+    if (f->complex_data){
+        fftwf_execute_dft(f->forward,(fftwf_complex *) in,out);
+    }
+    else {
+        fftwf_execute_dft_r2c(f->forward,in,out);
+    }
+}
+
+//Appends a chunk to the history and takes one dot product per output
+static void direct_process(FIR_Filter *f, const float *in, int N, float *out){
+
+    int width= f->complex_data ? 2 : 1;
+    int keep=(f->length-1)*width;
+    int done=0;
+    while (done<N){
+        int n= N-done<FIR_CHUNK ? N-done : FIR_CHUNK;
+        int i;
+        memcpy(f->history+keep,in+(size_t)done*width,(size_t)n*width*sizeof(float));
+        if (f->complex_data){
+            for (i=0;i<n;i++){
+                vector_dot_real_complex(f->taps,(const float (*)[2]) (f->history+2*i),f->length,out+2*(size_t)(done+i));
+            }
+        }
+        else {
+            for (i=0;i<n;i++){
+                out[done+i]=vector_dot(f->taps,f->history+i,f->length);
+            }
+        }
+        memmove(f->history,f->history+(size_t)n*width,(size_t)keep*sizeof(float));
+        done+=n;
+    }
+}
+
+//Each input sample takes the place of the output of the previous block at the same position
+static void partitioned_process(FIR_Filter *f, const float *in, int N, float *out){
+
+    int width= f->complex_data ? 2 : 1;
+    int B=f->block;
+    int done=0;
+    while (done<N){
+        int n= N-done<B-f->fill ? N-done : B-f->fill;
+        //input first so out may be the same array as in
+        memcpy(f->time+(size_t)(B+f->fill)*width,in+(size_t)done*width,(size_t)n*width*sizeof(float));
+        memcpy(out+(size_t)done*width,f->result+(size_t)(B+f->fill)*width,(size_t)n*width*sizeof(float));
+        f->fill+=n;
+        done+=n;
+        if (f->fill==B){
+            partitioned_block(f);
+            f->fill=0;
+        }
+    }
+}
+
+//One FFT of the last two blocks, a multiply accumulate per partition and one inverse FFT
+static void partitioned_block(FIR_Filter *f){
+
+    int width= f->complex_data ? 2 : 1;
+    int B=f->block;
+    int P=f->partitions;
+    int p;
+    fftwf_complex *slot;
+
+    //the slot before the newest holds the oldest spectrum, slot newest+p is p blocks old
+    f->newest=(f->newest+P-1)%P;
+    slot=f->delay_line+(size_t)f->newest*f->stride;
+    fft_forward(f,f->time,slot);
+
+    vector_complex_multiply((const float (*)[2]) slot,(const float (*)[2]) f->spectra,(float (*)[2]) f->accumulator,f->bins);
+    for (p=1;p<P;p++){
+        const fftwf_complex *x=f->delay_line+(size_t)((f->newest+p)%P)*f->stride;
+        const fftwf_complex *h=f->spectra+(size_t)p*f->stride;
+        vector_complex_multiply_add((const float (*)[2]) x,(const float (*)[2]) h,(float (*)[2]) f->accumulator,f->bins);
+    }
+
+    //the first B outputs wrap around the circular convolution, the last B are the new block
+    if (f->complex_data){
+        fftwf_execute_dft(f->backward,f->accumulator,(fftwf_complex *) f->result);
+    }
+    else {
+        fftwf_execute_dft_c2r(f->backward,f->accumulator,f->result);
+    }
+    memcpy(f->time,f->time+(size_t)B*width,(size_t)B*width*sizeof(float));
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,918 @@
+//********************************************************************
+//*                    Filter Design                                 *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Windowed sinc and equiripple FIR design, Butterworth*
+//*             and Chebyshev IIR sections, and a cache of designs   *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Filter_Design.h>
+#include <../include/Window_Cache.h>
+#include <fftw3.h>
+#include <complex.h>    //after fftw3.h so fftwf_complex stays float[2]
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define FILTER_CACHE_BUCKETS    64
+#define REMEZ_GRID_DENSITY      16      //grid points per extremal frequency
+#define REMEZ_MAX_ITERATIONS    250
+#define REMEZ_TOLERANCE         1e-6    //relative spread of the extremal errors when converged
+#define REMEZ_SETTLED           1e-2    //relative spread accepted once the exchange stops moving
+#define REMEZ_SCALE_ABOVE       256     //extremal points beyond which a shorter design seeds the set
+#define REMEZ_MAX_BANDS         3
+#define REMEZ_MAX_LENGTH        2048    //taps, the exchange loses precision beyond this
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+typedef struct Design_Entry {
+    Filter_Design design;
+    struct Design_Entry *next;
+} Design_Entry;
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+static Design_Entry *design_buckets[FILTER_CACHE_BUCKETS];
+static pthread_mutex_t design_lock = PTHREAD_MUTEX_INITIALIZER; //guards design_buckets, never held while designing
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int filter_design_window(Filter_Band band, int length, double low, double high,
+                         Window_Type window, float parameter, float taps[]);
+
+int filter_design_equiripple(Filter_Band band, int length, double low, double high,
+                             double transition, double stop_weight, float taps[]);
+
+int filter_design_iir(Filter_Method method, Filter_Band band, int order, double low, double high,
+                      double ripple, Biquad sections[]);
+
+const Filter_Design *filter_design_get(const Filter_Spec *spec);
+
+void filter_design_cache_clear(void);
+
+static int band_check(Filter_Band band, double low, double high);
+
+static double band_centre(Filter_Band band, double low, double high);
+
+static double ideal_lowpass(double cutoff, double t);
+
+static int remez(int length, int bands, const double edges[], const double desired[], const double weight[],
+                 double h[], double reference[]);
+
+static int reference_spread(const double f[], const int band_start[], const int band_end[], int bands,
+                            const double from[], int from_count, int count, int extremal[]);
+
+static int extremal_merge(const double e[], const int a[], int na, const int b[], int nb, int out[]);
+
+static void cosine_split(double freq, double *high, double *low);
+
+static void barycentric_weights(const double x[], const double x_low[], int n, double w[]);
+
+static double barycentric_eval(const double x[], const double x_low[], const double w[], const double c[], int n,
+                               double at, double at_low);
+
+static void spec_key(const Filter_Spec *spec, Filter_Spec *key);
+
+static int spec_equal(const Filter_Spec *a, const Filter_Spec *b);
+
+static unsigned spec_hash(const Filter_Spec *key);
+
+static Design_Entry *design_find(const Filter_Spec *key, unsigned bucket);
+
+static int design_build(Filter_Design *design);
+
+static void design_free(Filter_Design *design);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Ideal response times the window, then scaled so the middle of the pass band has unity gain
+int filter_design_window(Filter_Band band, int length, double low, double high,
+                         Window_Type window, float parameter, float taps[]){
+
+    const float *table;
+    double centre=(length-1)/2.0;
+    double reference=band_centre(band,low,high);
+    double gain=0;
+    int i;
+
+    if (band_check(band,low,high)!=0 || length<1 || (band==FILTER_HIGHPASS && length%2==0)){
+        return -1;
+    }
+    table=window_cache_get(window,length+1,parameter); //the end points fall outside the taps
+    if (table==NULL){
+        return -1;
+    }
+    for (i=0;i<length;i++){
+        double t=i-centre;
+        double ideal;
+        switch (band){
+        case FILTER_LOWPASS:
+            ideal=ideal_lowpass(low,t);
+            break;
+        case FILTER_HIGHPASS:
+            ideal=(t==0 ? 1 : 0)-ideal_lowpass(low,t);
+            break;
+        default:
+            ideal=ideal_lowpass(high,t)-ideal_lowpass(low,t);
+            break;
+        }
+        taps[i]=(float)(ideal*table[i+1]);
+        gain+=taps[i]*cos(2*M_PI*reference*t);
+    }
+    if (fabs(gain)<1e-12){
+        return -1;
+    }
+    for (i=0;i<length;i++){
+        taps[i]=(float)(taps[i]/gain);
+    }
+    return 0;
+}
+
+//Lays out the pass and stop bands either side of each transition and runs the exchange
+int filter_design_equiripple(Filter_Band band, int length, double low, double high,
+                             double transition, double stop_weight, float taps[]){
+
+    double edges[6],desired[3],weight[3];
+    double *h;
+    double half=transition/2;
+    int bands,i;
+
+    if (band_check(band,low,high)!=0 || length<3 || length>REMEZ_MAX_LENGTH || transition<=0
+        || (band==FILTER_HIGHPASS && length%2==0)){
+        return -1;
+    }
+    if (stop_weight<=0){
+        stop_weight=1;
+    }
+    switch (band){
+    case FILTER_LOWPASS:
+    case FILTER_HIGHPASS:
+        edges[0]=0;          edges[1]=low-half;
+        edges[2]=low+half;   edges[3]=0.5;
+        desired[0]= band==FILTER_LOWPASS ? 1 : 0;
+        desired[1]=1-desired[0];
+        weight[0]= band==FILTER_LOWPASS ? 1 : stop_weight;
+        weight[1]= band==FILTER_LOWPASS ? stop_weight : 1;
+        bands=2;
+        break;
+    default:
+        edges[0]=0;          edges[1]=low-half;
+        edges[2]=low+half;   edges[3]=high-half;
+        edges[4]=high+half;  edges[5]=0.5;
+        desired[0]=0; desired[1]=1; desired[2]=0;
+        weight[0]=stop_weight; weight[1]=1; weight[2]=stop_weight;
+        bands=3;
+        break;
+    }
+    for (i=0;i<2*bands;i+=2){
+        if (edges[i]<0 || edges[i]>=edges[i+1] || edges[i+1]>0.5){
+            return -1;
+        }
+    }
+
+    h=(double *) malloc((size_t)length*sizeof(double));
+    if (h==NULL){
+        return -1;
+    }
+    if (remez(length,bands,edges,desired,weight,h,NULL)!=0){
+        free(h);
+        return -1;
+    }
+    for (i=0;i<length;i++){
+        taps[i]=(float)h[i];
+    }
+    free(h);
+    return 0;
+}
+
+//Analog prototype poles, moved to the band by a frequency transform and to z by the bilinear transform
+int filter_design_iir(Filter_Method method, Filter_Band band, int order, double low, double high,
+                      double ripple, Biquad sections[]){
+
+    double complex poles[2*FILTER_MAX_ORDER];
+    double complex reference;
+    double w1,w2,mu=0,gain=1;
+    int count=0,used=0,n=0;
+    int k,i,j;
+
+    if (band_check(band,low,high)!=0 || order<1 || order>FILTER_MAX_ORDER){
+        return -1;
+    }
+    if (method==FILTER_CHEBYSHEV){
+        double eps;
+        if (ripple<=0){
+            return -1;
+        }
+        eps=sqrt(pow(10,ripple/10)-1);
+        mu=asinh(1/eps)/order;
+        if (order%2==0){ //even orders start the ripple at its bottom
+            gain=1/sqrt(1+eps*eps);
+        }
+    }
+    else if (method!=FILTER_BUTTERWORTH){
+        return -1;
+    }
+
+    //prewarped so the edges land where asked after the bilinear transform, with T=1
+    w1=2*tan(M_PI*low);
+    w2= band==FILTER_BANDPASS ? 2*tan(M_PI*high) : 0;
+    for (k=0;k<order;k++){
+        double theta=M_PI*(2*k+1)/(2*order);
+        double complex p= method==FILTER_BUTTERWORTH ? -sin(theta)+I*cos(theta)
+                                                     : -sinh(mu)*sin(theta)+I*cosh(mu)*cos(theta);
+        double complex s[2];
+        int m=1;
+        switch (band){
+        case FILTER_LOWPASS:
+            s[0]=w1*p;
+            break;
+        case FILTER_HIGHPASS:
+            s[0]=w1/p;
+            break;
+        default:
+            { //s -> (s^2+w0^2)/(bw s), each prototype pole gives two
+                double complex d=csqrt(p*p*(w2-w1)*(w2-w1)-4*w1*w2);
+                s[0]=(p*(w2-w1)+d)/2;
+                s[1]=(p*(w2-w1)-d)/2;
+                m=2;
+            }
+            break;
+        }
+        for (i=0;i<m;i++){
+            poles[count++]=(2+s[i])/(2-s[i]);
+        }
+    }
+
+    //one section per pole above the real axis, its conjugate is the other pole; real poles pair up
+    for (i=0;i<count;i++){
+        if (cimag(poles[i])>1e-12){
+            sections[n].a1=(float)(-2*creal(poles[i]));
+            sections[n].a2=(float)(creal(poles[i])*creal(poles[i])+cimag(poles[i])*cimag(poles[i]));
+            n++;
+        }
+    }
+    for (i=0;i<count;i++){
+        if (fabs(cimag(poles[i]))<=1e-12){
+            if (used%2==0){
+                sections[n].a1=(float)(-creal(poles[i]));
+                sections[n].a2=0;
+                n++;
+            }
+            else {
+                double first=-sections[n-1].a1;
+                sections[n-1].a1=(float)(-(first+creal(poles[i])));
+                sections[n-1].a2=(float)(first*creal(poles[i]));
+            }
+            used++;
+        }
+    }
+
+    //zeros: at z=-1 for a low pass, z=1 for a high pass, one of each per band pass section
+    for (i=0;i<n;i++){
+        int first_order= band!=FILTER_BANDPASS && sections[i].a2==0 && i==n-1 && used%2==1;
+        sections[i].b0=1;
+        switch (band){
+        case FILTER_LOWPASS:
+            sections[i].b1= first_order ? 1 : 2;
+            sections[i].b2= first_order ? 0 : 1;
+            break;
+        case FILTER_HIGHPASS:
+            sections[i].b1= first_order ? -1 : -2;
+            sections[i].b2= first_order ? 0 : 1;
+            break;
+        default:
+            sections[i].b1=0;
+            sections[i].b2=-1;
+            break;
+        }
+    }
+
+    //poles nearest the unit circle last, where the signal has already been band limited
+    for (i=1;i<n;i++){
+        Biquad key=sections[i];
+        double radius=fabs(key.a2)>0 ? sqrt(fabs(key.a2)) : fabs(key.a1);
+        for (j=i-1;j>=0;j--){
+            double r=fabs(sections[j].a2)>0 ? sqrt(fabs(sections[j].a2)) : fabs(sections[j].a1);
+            if (r<=radius){
+                break;
+            }
+            sections[j+1]=sections[j];
+        }
+        sections[j+1]=key;
+    }
+
+    //unity gain per section at the reference frequency keeps the signal level even through the cascade
+    reference=cexp(I*2*M_PI*band_centre(band,low,high));
+    if (band==FILTER_BANDPASS){
+        reference=cexp(I*2*atan(sqrt(w1*w2)/2)); //the centre the transform maps 0 Hz to
+    }
+    for (i=0;i<n;i++){
+        double complex z1=1/reference;
+        double complex num=sections[i].b0+sections[i].b1*z1+sections[i].b2*z1*z1;
+        double complex den=1+sections[i].a1*z1+sections[i].a2*z1*z1;
+        double scale=cabs(den)/cabs(num);
+        if (i==0){
+            scale*=gain;
+        }
+        sections[i].b0=(float)(sections[i].b0*scale);
+        sections[i].b1=(float)(sections[i].b1*scale);
+        sections[i].b2=(float)(sections[i].b2*scale);
+    }
+    return n;
+}
+
+//Looks up a design, running the designer the first time the spec is asked for. A long design
+//can take most of a second so it runs without design_lock, lookups of cached designs keep going
+//meanwhile. The key is checked again before inserting in case another thread designed it too.
+const Filter_Design *filter_design_get(const Filter_Spec *spec){
+
+    Filter_Spec key;
+    Design_Entry *entry,*found;
+    unsigned bucket;
+
+    spec_key(spec,&key);
+    bucket=spec_hash(&key);
+
+    pthread_mutex_lock(&design_lock);
+    found=design_find(&key,bucket);
+    pthread_mutex_unlock(&design_lock);
+    if (found!=NULL){
+        return &found->design;
+    }
+
+    entry=(Design_Entry *) calloc(1,sizeof(Design_Entry));
+    if (entry==NULL){
+        return NULL;
+    }
+    entry->design.spec=key;
+    if (design_build(&entry->design)!=0){
+        design_free(&entry->design);
+        free(entry);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&design_lock);
+    found=design_find(&key,bucket);
+    if (found==NULL){
+        entry->next=design_buckets[bucket];
+        design_buckets[bucket]=entry;
+        found=entry;
+    }
+    pthread_mutex_unlock(&design_lock);
+    if (found!=entry){ //another thread got there first, every caller shares its copy
+        design_free(&entry->design);
+        free(entry);
+    }
+
+    return &found->design;
+}
+
+//Releases every cached design
+void filter_design_cache_clear(void){
+
+    int i;
+    pthread_mutex_lock(&design_lock);
+    for (i=0;i<FILTER_CACHE_BUCKETS;i++){
+        Design_Entry *entry=design_buckets[i];
+        while (entry!=NULL){
+            Design_Entry *next=entry->next;
+            design_free(&entry->design);
+            free(entry);
+            entry=next;
+        }
+        design_buckets[i]=NULL;
+    }
+    pthread_mutex_unlock(&design_lock);
+}
+
+static int band_check(Filter_Band band, double low, double high){
+
+    if (!(low>0 && low<0.5)){
+        return -1;
+    }
+    if (band==FILTER_BANDPASS && !(high>low && high<0.5)){
+        return -1;
+    }
+    return band==FILTER_LOWPASS || band==FILTER_HIGHPASS || band==FILTER_BANDPASS ? 0 : -1;
+}
+
+//Frequency the gain is normalised at
+static double band_centre(Filter_Band band, double low, double high){
+
+    switch (band){
+    case FILTER_LOWPASS:  return 0;
+    case FILTER_HIGHPASS: return 0.5;
+    default:              return (low+high)/2;
+    }
+}
+
+//Impulse response of an ideal low pass at t samples from its centre
+static double ideal_lowpass(double cutoff, double t){
+
+    return t==0 ? 2*cutoff : sin(2*M_PI*cutoff*t)/(M_PI*t);
+}
+
+//Parks-McClellan: the amplitude is a polynomial in x=cos(2 pi f), the exchange moves r+1
+//extremal points until the weighted error alternates with equal size across them.
+//Even lengths have a zero at 0.5, so cos(pi f) is factored out of the amplitude first.
+//Long filters start from the extremal frequencies of one half as long, the first steps
+//from an evenly spread set are too badly conditioned past a few hundred points.
+static int remez(int length, int bands, const double edges[], const double desired[], const double weight[],
+                 double h[], double reference[]){
+
+    int odd=length%2;
+    int r= odd ? (length+1)/2 : length/2;
+    double spacing=0.5/(REMEZ_GRID_DENSITY*r);
+    int grid=0,capacity=0;
+    int band_start[REMEZ_MAX_BANDS],band_end[REMEZ_MAX_BANDS];
+    double *f,*x,*x_low,*d,*w,*e;
+    double xe[REMEZ_MAX_LENGTH/2+2],xe_low[REMEZ_MAX_LENGTH/2+2],de[REMEZ_MAX_LENGTH/2+2],we[REMEZ_MAX_LENGTH/2+2];
+    double bary[REMEZ_MAX_LENGTH/2+2],c[REMEZ_MAX_LENGTH/2+2];
+    int extremal[REMEZ_MAX_LENGTH/2+2];
+    int *candidates,*merged;
+    double delta=0;
+    int attempt,iteration,i,k,b,scaled=0,status=-1;
+
+    for (b=0;b<bands;b++){
+        capacity+=(int)ceil((edges[2*b+1]-edges[2*b])/spacing)+1;
+    }
+    f=(double *) malloc((size_t)capacity*sizeof(double));
+    x=(double *) malloc((size_t)capacity*sizeof(double));
+    x_low=(double *) malloc((size_t)capacity*sizeof(double));
+    d=(double *) malloc((size_t)capacity*sizeof(double));
+    w=(double *) malloc((size_t)capacity*sizeof(double));
+    e=(double *) malloc((size_t)capacity*sizeof(double));
+    candidates=(int *) malloc((size_t)capacity*sizeof(int));
+    merged=(int *) malloc((size_t)capacity*sizeof(int));
+    if (f==NULL || x==NULL || x_low==NULL || d==NULL || w==NULL || e==NULL || candidates==NULL || merged==NULL){
+        goto done;
+    }
+
+    //dense grid over the bands, the transition bands are don't care
+    for (b=0;b<bands;b++){
+        double start=edges[2*b];
+        double stop=edges[2*b+1];
+        int points;
+        if (!odd && stop>0.5-spacing){
+            stop=0.5-spacing;
+        }
+        points=(int)ceil((stop-start)/spacing)+1;
+        band_start[b]=grid;
+        for (i=0;i<points;i++){
+            double freq= points>1 ? start+(stop-start)*i/(points-1) : start;
+            double factor= odd ? 1 : cos(M_PI*freq);
+            f[grid]=freq;
+            cosine_split(freq,&x[grid],&x_low[grid]);
+            d[grid]=desired[b]/factor;
+            w[grid]=weight[b]*factor;
+            grid++;
+        }
+        band_end[b]=grid;
+    }
+    if (grid<r+1){
+        goto done;
+    }
+
+    //the shorter design's extremal frequencies stretched over each band make the best start,
+    //when there isn't one or it doesn't settle the start is spread evenly over the grid
+    if (r>REMEZ_SCALE_ABOVE){
+        int half=(r+1)/2;
+        double *shorter=(double *) malloc((size_t)length*sizeof(double));
+        double *from=(double *) malloc((size_t)(half+1)*sizeof(double));
+        if (shorter!=NULL && from!=NULL
+            && remez(odd ? 2*half-1 : 2*half,bands,edges,desired,weight,shorter,from)==0){
+            scaled=reference_spread(f,band_start,band_end,bands,from,half+1,r+1,extremal)==0;
+        }
+        free(shorter);
+        free(from);
+    }
+    for (attempt= scaled ? 0 : 1;attempt<2 && status!=0;attempt++){
+        if (attempt==1){
+            for (k=0;k<=r;k++){
+                extremal[k]=(int)((long long)k*(grid-1)/r);
+            }
+        }
+        for (iteration=0;iteration<REMEZ_MAX_ITERATIONS;iteration++){
+            double numerator=0,denominator=0,worst=0;
+            int found=0,moved=0;
+            for (k=0;k<=r;k++){
+                xe[k]=x[extremal[k]];
+                xe_low[k]=x_low[extremal[k]];
+                de[k]=d[extremal[k]];
+                we[k]=w[extremal[k]];
+            }
+            barycentric_weights(xe,xe_low,r+1,bary);
+            for (k=0;k<=r;k++){
+                numerator+=bary[k]*de[k];
+                denominator+=bary[k]*(k%2==0 ? 1 : -1)/we[k];
+            }
+            delta=numerator/denominator;
+            for (k=0;k<=r;k++){
+                c[k]=de[k]-(k%2==0 ? 1 : -1)*delta/we[k];
+            }
+            //delta is what zeroes the degree r term of the interpolant through all r+1 points, so it
+            //is the amplitude itself. Leaving a point out instead means extrapolating to it.
+            for (i=0;i<grid;i++){
+                e[i]=w[i]*(d[i]-barycentric_eval(xe,xe_low,bary,c,r+1,x[i],x_low[i]));
+            }
+
+            //local extremes of the error, band edges included
+            for (i=0;i<grid;i++){
+                int left= i>0 && f[i]-f[i-1]<1.5*spacing;
+                int right= i<grid-1 && f[i+1]-f[i]<1.5*spacing;
+                if ((e[i]>0 && (!left || e[i]>=e[i-1]) && (!right || e[i]>e[i+1]))
+                    || (e[i]<0 && (!left || e[i]<=e[i-1]) && (!right || e[i]<e[i+1]))){
+                    //alternate in sign, keeping the larger of two in a row
+                    if (found>0 && (e[candidates[found-1]]>0)==(e[i]>0)){
+                        if (fabs(e[i])>fabs(e[candidates[found-1]])){
+                            candidates[found-1]=i;
+                        }
+                    }
+                    else {
+                        candidates[found++]=i;
+                    }
+                }
+            }
+            //too few when the ripple is below rounding on a long filter. The error on the last set is
+            //+-delta by construction, so merging that set back in pads out the alternation. Rounding
+            //can zero those errors when delta is that small, so they are put back exactly.
+            if (found<r+1){
+                for (k=0;k<=r;k++){
+                    e[extremal[k]]=(k%2==0 ? 1 : -1)*delta;
+                }
+                found=extremal_merge(e,candidates,found,extremal,r+1,merged);
+                memcpy(candidates,merged,(size_t)found*sizeof(int));
+            }
+            while (found>r+1){ //drop the smaller end, the rest still alternates
+                if (fabs(e[candidates[0]])<fabs(e[candidates[found-1]])){
+                    memmove(candidates,candidates+1,(size_t)(found-1)*sizeof(int));
+                }
+                found--;
+            }
+            if (found<r+1){
+                break;
+            }
+            for (k=0;k<=r;k++){
+                moved|=extremal[k]!=candidates[k];
+                extremal[k]=candidates[k];
+                if (fabs(e[candidates[k]])>worst){
+                    worst=fabs(e[candidates[k]]);
+                }
+            }
+            if (worst-fabs(delta)<=REMEZ_TOLERANCE*fabs(delta)){
+                status=0;
+                break;
+            }
+            if (!moved){ //the grid can't resolve the ripple any finer
+                break;
+            }
+        }
+        //stopped short of the tolerance, fine when the peak error over the whole grid is within
+        //a small part of delta of equal ripple
+        if (status!=0 && delta!=0){
+            double worst=0;
+            for (i=0;i<grid;i++){
+                if (fabs(e[i])>worst){
+                    worst=fabs(e[i]);
+                }
+            }
+            if (worst-fabs(delta)<=REMEZ_SETTLED*fabs(delta)){
+                status=0;
+            }
+        }
+    }
+    if (status!=0){
+        goto done;
+    }
+
+    //sample the amplitude at length points round the circle, the linear phase inverse DFT gives the taps
+    {
+        double centre=(length-1)/2.0;
+        int n;
+        for (n=0;n<length;n++){
+            h[n]=0;
+        }
+        for (k=0;k<=(length-1)/2;k++){
+            double freq=(double)k/length;
+            double at,at_low,amplitude;
+            cosine_split(freq,&at,&at_low);
+            amplitude=barycentric_eval(xe,xe_low,bary,c,r+1,at,at_low)*(odd ? 1 : cos(M_PI*freq));
+            for (n=0;n<length;n++){
+                h[n]+=(k==0 ? 1 : 2)*amplitude*cos(2*M_PI*k*(n-centre)/length);
+            }
+        }
+        for (n=0;n<length;n++){
+            h[n]/=length;
+        }
+    }
+    if (reference!=NULL){
+        for (k=0;k<=r;k++){
+            reference[k]=f[extremal[k]];
+        }
+    }
+
+done:
+    free(f);
+    free(x);
+    free(x_low);
+    free(d);
+    free(w);
+    free(e);
+    free(candidates);
+    free(merged);
+    return status;
+}
+
+//Places count grid points for a starting set. Each band gets a share in proportion to how many of
+//the sorted frequencies in from[] fall in it, at least two, and they are spaced along those
+//frequencies so the pattern they make is kept.
+static int reference_spread(const double f[], const int band_start[], const int band_end[], int bands,
+                            const double from[], int from_count, int count, int extremal[]){
+
+    int share[REMEZ_MAX_BANDS],first[REMEZ_MAX_BANDS],inside[REMEZ_MAX_BANDS];
+    int sum=0,k=0,b,i,j;
+
+    for (b=0;b<bands;b++){
+        double low=f[band_start[b]];
+        double high=f[band_end[b]-1];
+        int n=band_end[b]-band_start[b];
+        first[b]=-1;
+        inside[b]=0;
+        for (i=0;i<from_count;i++){
+            if (from[i]>=low-1e-12 && from[i]<=high+1e-12){
+                if (first[b]<0){
+                    first[b]=i;
+                }
+                inside[b]++;
+            }
+        }
+        if (inside[b]<2){
+            return -1;
+        }
+        share[b]=(int)floor((double)count*inside[b]/from_count+0.5);
+        if (share[b]<2){
+            share[b]=2;
+        }
+        if (share[b]>n){
+            share[b]=n;
+        }
+        sum+=share[b];
+    }
+    //rounding leaves the total a few out, the band with the most room takes up the difference
+    while (sum!=count){
+        int best=-1;
+        for (b=0;b<bands;b++){
+            int room= sum>count ? share[b]-2 : band_end[b]-band_start[b]-share[b];
+            if (room>0 && (best<0 || room>(sum>count ? share[best]-2 : band_end[best]-band_start[best]-share[best]))){
+                best=b;
+            }
+        }
+        if (best<0){
+            return -1;
+        }
+        share[best]+= sum>count ? -1 : 1;
+        sum+= sum>count ? -1 : 1;
+    }
+
+    for (b=0;b<bands;b++){
+        double low=f[band_start[b]];
+        double step=f[band_start[b]+1]-low;
+        int last=band_start[b]-1;
+        for (j=0;j<share[b];j++){
+            double at=(double)j*(inside[b]-1)/(share[b]-1);
+            int below=(int)at;
+            double freq= below>=inside[b]-1 ? from[first[b]+inside[b]-1]
+                : from[first[b]+below]+(at-below)*(from[first[b]+below+1]-from[first[b]+below]);
+            int index=band_start[b]+(int)floor((freq-low)/step+0.5);
+            //keep them in order and leave room for the rest of the band's share
+            if (index<=last){
+                index=last+1;
+            }
+            if (index>band_end[b]-(share[b]-j)){
+                index=band_end[b]-(share[b]-j);
+            }
+            extremal[k++]=index;
+            last=index;
+        }
+    }
+    return 0;
+}
+
+//Merges two sorted sets of grid points into one that alternates in sign, keeping the larger error
+//of two in a row. It has at least as many points as either set has sign changes plus one.
+static int extremal_merge(const double e[], const int a[], int na, const int b[], int nb, int out[]){
+
+    int i=0,j=0,n=0;
+    while (i<na || j<nb){
+        int next;
+        if (j>=nb || (i<na && a[i]<=b[j])){
+            next=a[i];
+            if (j<nb && b[j]==next){
+                j++;
+            }
+            i++;
+        }
+        else {
+            next=b[j++];
+        }
+        if (n>0 && (e[out[n-1]]>0)==(e[next]>0)){
+            if (fabs(e[next])>fabs(e[out[n-1]])){
+                out[n-1]=next;
+            }
+        }
+        else {
+            out[n++]=next;
+        }
+    }
+    return n;
+}
+
+//cos(2 pi f) as high+low. Near 1 and -1 neighbouring grid points differ by less than 1e-8,
+//so cos alone leaves their differences only 8 digits; 1-2sin^2 and 2cos^2-1 keep the part
+//a plain double rounds off.
+static void cosine_split(double freq, double *high, double *low){
+
+    if (freq<=0.25){
+        double s=sin(M_PI*freq);
+        double distance=2*s*s;        //1-x
+        *high=1-distance;
+        *low=(1-*high)-distance;
+    }
+    else {
+        double s=cos(M_PI*freq);
+        double distance=2*s*s;        //1+x
+        *high=distance-1;
+        *low=distance-(*high+1);
+    }
+}
+
+//w[k]=1/prod(x[k]-x[j]), through logs since the products overflow for long filters;
+//a common scale cancels in every use
+static void barycentric_weights(const double x[], const double x_low[], int n, double w[]){
+
+    char negative[REMEZ_MAX_LENGTH/2+2];
+    double largest=-HUGE_VAL;
+    int k,j;
+    for (k=0;k<n;k++){
+        double log_sum=0;
+        negative[k]=0;
+        for (j=0;j<n;j++){
+            if (j!=k){
+                double diff=(x[k]-x[j])+(x_low[k]-x_low[j]);
+                log_sum-=log(fabs(diff));
+                negative[k]^=diff<0;
+            }
+        }
+        w[k]=log_sum;
+        if (log_sum>largest){
+            largest=log_sum;
+        }
+    }
+    for (k=0;k<n;k++){
+        w[k]=exp(w[k]-largest)*(negative[k] ? -1 : 1);
+    }
+}
+
+//Polynomial through (x[k], c[k]) evaluated at one point
+static double barycentric_eval(const double x[], const double x_low[], const double w[], const double c[], int n,
+                               double at, double at_low){
+
+    double numerator=0,denominator=0;
+    int k;
+    for (k=0;k<n;k++){
+        double diff=(at-x[k])+(at_low-x_low[k]);
+        double term;
+        if (diff==0){
+            return c[k];
+        }
+        term=w[k]/diff;
+        numerator+=term*c[k];
+        denominator+=term;
+    }
+    return numerator/denominator;
+}
+
+//Copies the fields the method uses so unused ones can't split the cache
+static void spec_key(const Filter_Spec *spec, Filter_Spec *key){
+
+    memset(key,0,sizeof(Filter_Spec));
+    key->method=spec->method;
+    key->band=spec->band;
+    key->order=spec->order;
+    key->low=spec->low;
+    if (spec->band==FILTER_BANDPASS){
+        key->high=spec->high;
+    }
+    switch (spec->method){
+    case FILTER_WINDOWED_SINC:
+        key->window=spec->window;
+        if (spec->window==WINDOW_GAUSSIAN || spec->window==WINDOW_KAISER){
+            key->window_parameter=spec->window_parameter;
+        }
+        break;
+    case FILTER_EQUIRIPPLE:
+        key->transition=spec->transition;
+        key->stop_weight= spec->stop_weight>0 ? spec->stop_weight : 1;
+        break;
+    case FILTER_CHEBYSHEV:
+        key->ripple=spec->ripple;
+        break;
+    default:
+        break;
+    }
+}
+
+static int spec_equal(const Filter_Spec *a, const Filter_Spec *b){
+
+    return a->method==b->method && a->band==b->band && a->order==b->order
+        && a->low==b->low && a->high==b->high
+        && a->window==b->window && a->window_parameter==b->window_parameter
+        && a->transition==b->transition && a->stop_weight==b->stop_weight
+        && a->ripple==b->ripple;
+}
+
+//Spreads specs over the cache buckets, the edges are what changes while tuning
+static unsigned spec_hash(const Filter_Spec *key){
+
+    unsigned long long bits[2];
+    memcpy(&bits[0],&key->low,sizeof(double));
+    memcpy(&bits[1],&key->high,sizeof(double));
+    bits[0]^=bits[0]>>29;
+    bits[1]^=bits[1]>>29;
+    return (unsigned)(((unsigned long long)key->method*31u + (unsigned)key->band*7u + (unsigned)key->order*2654435761u
+                       + bits[0]*0x9E3779B97F4A7C15ull + bits[1]) >> 7) % FILTER_CACHE_BUCKETS;
+}
+
+//Searches one bucket of the cache, the caller holds design_lock
+static Design_Entry *design_find(const Filter_Spec *key, unsigned bucket){
+
+    Design_Entry *entry;
+    for (entry=design_buckets[bucket];entry!=NULL;entry=entry->next){
+        if (spec_equal(&entry->design.spec,key)){
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+//Runs the designer a spec asks for, without design_lock held so it only touches the new design
+static int design_build(Filter_Design *design){
+
+    const Filter_Spec *spec=&design->spec;
+    switch (spec->method){
+    case FILTER_WINDOWED_SINC:
+    case FILTER_EQUIRIPPLE:
+        if (spec->order<1){
+            return -1;
+        }
+        design->taps=(float *) fftwf_malloc((size_t)spec->order*sizeof(float));
+        if (design->taps==NULL){
+            return -1;
+        }
+        design->length=spec->order;
+        if (spec->method==FILTER_WINDOWED_SINC){
+            return filter_design_window(spec->band,spec->order,spec->low,spec->high,spec->window,spec->window_parameter,design->taps);
+        }
+        return filter_design_equiripple(spec->band,spec->order,spec->low,spec->high,spec->transition,spec->stop_weight,design->taps);
+    case FILTER_BUTTERWORTH:
+    case FILTER_CHEBYSHEV:
+        if (spec->order<1 || spec->order>FILTER_MAX_ORDER){
+            return -1;
+        }
+        design->sos=(Biquad *) malloc((size_t)spec->order*sizeof(Biquad));
+        if (design->sos==NULL){
+            return -1;
+        }
+        design->sections=filter_design_iir(spec->method,spec->band,spec->order,spec->low,spec->high,spec->ripple,design->sos);
+        return design->sections>0 ? 0 : -1;
+    default:
+        return -1;
+    }
+}
+
+static void design_free(Filter_Design *design){
+
+    fftwf_free(design->taps);
+    free(design->sos);
+    design->taps=NULL;
+    design->sos=NULL;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,682 @@
+//********************************************************************
+//*                    IQ File                                       *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Reads and writes raw interleaved IQ recordings      *
+//*             (cu8, cs8, cs16, cf32) with SigMF metadata sidecars  *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/IQ_File.h>
+#include <../include/Vector_Ops.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define IQ_CHUNK        4096      //samples converted per pass when writing
+#define IQ_WRITE_BUFFER (1<<20)   //stdio buffer so the disk sees large writes
+#define IQ_META_MAX     (1<<24)   //largest sidecar read
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+static const struct {
+    IQ_Format format;
+    const char *datatype;   //SigMF core:datatype
+    const char *extension;
+    int bytes;              //per complex sample
+} iq_formats[]={
+    {IQ_CU8,  "cu8",     ".cu8",   2},
+    {IQ_CS8,  "ci8",     ".cs8",   2},
+    {IQ_CS16, "ci16_le", ".cs16",  4},
+    {IQ_CF32, "cf32_le", ".cf32",  8},
+    {IQ_CF32, "cf32_le", ".cfile", 8},  //GNU Radio file sink
+};
+#define IQ_FORMATS ((int)(sizeof(iq_formats)/sizeof(iq_formats[0])))
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int iq_file_open(IQ_File *iq, const char *path, IQ_Format format);
+
+int iq_file_read(IQ_File *iq, fftwf_complex out[], int N);
+
+int iq_file_seek(IQ_File *iq, uint64_t sample);
+
+const fftwf_complex *iq_file_view(const IQ_File *iq, uint64_t sample, uint64_t *count);
+
+void iq_file_willneed(const IQ_File *iq, uint64_t sample, uint64_t count);
+
+void iq_file_close(IQ_File *iq);
+
+int iq_writer_open(IQ_Writer *w, const char *path, IQ_Format format, double sample_rate, double center_frequency);
+
+int iq_writer_write(IQ_Writer *w, const fftwf_complex in[], int N);
+
+int iq_writer_annotate(IQ_Writer *w, uint64_t sample_start, uint64_t sample_count,
+                       double freq_lower, double freq_upper, const char *label);
+
+int iq_writer_close(IQ_Writer *w);
+
+int iq_meta_read(IQ_Meta *meta, const char *path);
+
+int iq_meta_write(const IQ_Meta *meta, const char *path);
+
+void iq_meta_free(IQ_Meta *meta);
+
+static int format_bytes(IQ_Format format);
+
+static const char *format_datatype(IQ_Format format);
+
+static IQ_Format format_from_extension(const char *path);
+
+static char *meta_path(const char *path);
+
+static int add_annotation(IQ_Meta *meta, const IQ_Annotation *a);
+
+static int compare_annotations(const void *a, const void *b);
+
+static const char *json_skip_space(const char *p, const char *end);
+
+static const char *json_skip_value(const char *p, const char *end);
+
+static const char *json_find(const char *p, const char *end, const char *key);
+
+static int json_string(const char *p, const char *end, char *out, int size);
+
+static void json_write_string(FILE *f, const char *s);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Maps the recording and works out its format from the sidecar, the extension or the caller
+int iq_file_open(IQ_File *iq, const char *path, IQ_Format format){
+
+    char *sidecar;
+    struct stat st;
+    int fd;
+    void *base;
+
+    memset(iq,0,sizeof(IQ_File));
+    sidecar=meta_path(path);
+    if (sidecar!=NULL){
+        iq_meta_read(&iq->meta,sidecar);
+        free(sidecar);
+    }
+    if (iq->meta.format==IQ_UNKNOWN){
+        iq->meta.format=format_from_extension(path);
+    }
+    if (iq->meta.format==IQ_UNKNOWN){
+        iq->meta.format=format;
+    }
+    iq->sample_bytes=format_bytes(iq->meta.format);
+    if (iq->sample_bytes==0){
+        iq_meta_free(&iq->meta);
+        return -1;
+    }
+
+    fd=open(path,O_RDONLY);
+    if (fd<0){
+        iq_meta_free(&iq->meta);
+        return -1;
+    }
+    if (fstat(fd,&st)!=0 || st.st_size<iq->sample_bytes){
+        close(fd);
+        iq_meta_free(&iq->meta);
+        return -1;
+    }
+    base=mmap(NULL,(size_t) st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd); //the mapping keeps the file alive
+    if (base==MAP_FAILED){
+        iq_meta_free(&iq->meta);
+        return -1;
+    }
+    iq->base=base;
+    iq->length=(size_t) st.st_size;
+    iq->num_samples=iq->length/iq->sample_bytes;
+    madvise(iq->base,iq->length,MADV_SEQUENTIAL);
+    return 0;
+}
+
+//Converts straight from the mapping into the caller's buffer, no intermediate copy
+int iq_file_read(IQ_File *iq, fftwf_complex out[], int N){
+
+    const uint8_t *src;
+    uint64_t left=iq->num_samples-iq->position;
+    int n=N;
+
+    if ((uint64_t)n>left){
+        n=(int) left;
+    }
+    if (n<=0){
+        return 0;
+    }
+    src=(const uint8_t *) iq->base+iq->position*iq->sample_bytes;
+    switch (iq->meta.format){
+        case IQ_CU8:
+            vector_u8_to_float(src,(float *) out,2*n);
+            break;
+        case IQ_CS8:
+            vector_s8_to_float((const int8_t *) src,(float *) out,2*n);
+            break;
+        case IQ_CS16:
+            vector_s16_to_float((const int16_t *) src,(float *) out,2*n);
+            break;
+        case IQ_CF32:
+            memcpy(out,src,(size_t)n*sizeof(fftwf_complex));
+            break;
+        default:
+            return 0;
+    }
+    iq->position+=n;
+    return n;
+}
+
+//Moves the read position
+int iq_file_seek(IQ_File *iq, uint64_t sample){
+
+    if (sample>iq->num_samples){
+        return -1;
+    }
+    iq->position=sample;
+    return 0;
+}
+
+//Pointer into the mapping for cf32 files, which are already fftwf_complex
+const fftwf_complex *iq_file_view(const IQ_File *iq, uint64_t sample, uint64_t *count){
+
+    if (iq->meta.format!=IQ_CF32 || sample>=iq->num_samples){
+        if (count!=NULL){
+            *count=0;
+        }
+        return NULL;
+    }
+    if (count!=NULL){
+        *count=iq->num_samples-sample;
+    }
+    return (const fftwf_complex *)((const uint8_t *) iq->base+sample*iq->sample_bytes);
+}
+
+//Asks the kernel to read a range ahead
+void iq_file_willneed(const IQ_File *iq, uint64_t sample, uint64_t count){
+
+    uintptr_t page=(uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t start,stop;
+
+    if (sample>=iq->num_samples){
+        return;
+    }
+    if (count>iq->num_samples-sample){
+        count=iq->num_samples-sample;
+    }
+    start=(uintptr_t) iq->base+sample*iq->sample_bytes;
+    stop=start+count*iq->sample_bytes;
+    start&=~(page-1); //madvise wants a page aligned start
+    madvise((void *) start,stop-start,MADV_WILLNEED);
+}
+
+//Unmaps the file and frees the metadata
+void iq_file_close(IQ_File *iq){
+
+    if (iq->base!=NULL){
+        munmap(iq->base,iq->length);
+    }
+    iq_meta_free(&iq->meta);
+    memset(iq,0,sizeof(IQ_File));
+}
+
+//Opens the data file with a large stdio buffer and remembers where the sidecar goes
+int iq_writer_open(IQ_Writer *w, const char *path, IQ_Format format, double sample_rate, double center_frequency){
+
+    memset(w,0,sizeof(IQ_Writer));
+    w->sample_bytes=format_bytes(format);
+    w->meta_path=meta_path(path);
+    if (w->sample_bytes==0 || w->meta_path==NULL){
+        free(w->meta_path);
+        return -1;
+    }
+    w->f=fopen(path,"wb");
+    if (w->f==NULL){
+        free(w->meta_path);
+        return -1;
+    }
+    setvbuf(w->f,NULL,_IOFBF,IQ_WRITE_BUFFER);
+    w->meta.format=format;
+    w->meta.sample_rate=sample_rate;
+    w->meta.center_frequency=center_frequency;
+    return 0;
+}
+
+//Converts a chunk at a time on the stack and writes it, cf32 goes out untouched
+int iq_writer_write(IQ_Writer *w, const fftwf_complex in[], int N){
+
+    uint8_t raw[IQ_CHUNK*4];
+    int done=0;
+
+    if (w->meta.format==IQ_CF32){
+        done=(int) fwrite(in,sizeof(fftwf_complex),N,w->f);
+        w->samples+=done;
+        return done;
+    }
+    while (done<N){
+        int n= N-done<IQ_CHUNK ? N-done : IQ_CHUNK;
+        const float *x=(const float *)(in+done);
+        int written;
+        switch (w->meta.format){
+            case IQ_CU8:
+                vector_float_to_u8(x,raw,2*n);
+                break;
+            case IQ_CS8:
+                vector_float_to_s8(x,(int8_t *) raw,2*n);
+                break;
+            case IQ_CS16:
+                vector_float_to_s16(x,(int16_t *) raw,2*n);
+                break;
+            default:
+                return done;
+        }
+        written=(int) fwrite(raw,w->sample_bytes,n,w->f);
+        done+=written;
+        if (written<n){
+            break;
+        }
+    }
+    w->samples+=done;
+    return done;
+}
+
+//Keeps an annotation for the sidecar
+int iq_writer_annotate(IQ_Writer *w, uint64_t sample_start, uint64_t sample_count,
+                       double freq_lower, double freq_upper, const char *label){
+
+    IQ_Annotation a;
+    memset(&a,0,sizeof(IQ_Annotation));
+    a.sample_start=sample_start;
+    a.sample_count=sample_count;
+    a.freq_lower=freq_lower;
+    a.freq_upper=freq_upper;
+    if (label!=NULL){
+        strncpy(a.label,label,sizeof(a.label)-1);
+    }
+    return add_annotation(&w->meta,&a);
+}
+
+//Closes the data and writes the sidecar, annotations sorted by start sample as SigMF asks
+int iq_writer_close(IQ_Writer *w){
+
+    int error=0;
+    if (w->meta.annotation_count>1){
+        qsort(w->meta.annotations,w->meta.annotation_count,sizeof(IQ_Annotation),compare_annotations);
+    }
+    if (fclose(w->f)!=0){
+        error=-1;
+    }
+    if (iq_meta_write(&w->meta,w->meta_path)!=0){
+        error=-1;
+    }
+    free(w->meta_path);
+    iq_meta_free(&w->meta);
+    memset(w,0,sizeof(IQ_Writer));
+    return error;
+}
+
+//Pulls the datatype, sample rate, first capture frequency and annotations out of a sidecar
+int iq_meta_read(IQ_Meta *meta, const char *path){
+
+    FILE *f;
+    long size;
+    char *text;
+    const char *end,*global,*value;
+    int i;
+
+    memset(meta,0,sizeof(IQ_Meta));
+    f=fopen(path,"rb");
+    if (f==NULL){
+        return -1;
+    }
+    fseek(f,0,SEEK_END);
+    size=ftell(f);
+    fseek(f,0,SEEK_SET);
+    if (size<=0 || size>IQ_META_MAX || (text=(char *) malloc(size+1))==NULL){
+        fclose(f);
+        return -1;
+    }
+    size=(long) fread(text,1,size,f);
+    fclose(f);
+    text[size]='\0';
+    end=text+size;
+
+    global=json_find(text,end,"global");
+    if (global!=NULL && *global=='{'){
+        const char *global_end=json_skip_value(global,end);
+        char datatype[32];
+        value=json_find(global,global_end,"core:datatype");
+        if (value!=NULL && json_string(value,global_end,datatype,sizeof(datatype))==0){
+            for (i=0;i<IQ_FORMATS;i++){
+                if (strcmp(datatype,iq_formats[i].datatype)==0){
+                    meta->format=iq_formats[i].format;
+                    break;
+                }
+            }
+        }
+        value=json_find(global,global_end,"core:sample_rate");
+        if (value!=NULL){
+            meta->sample_rate=strtod(value,NULL);
+        }
+    }
+
+    value=json_find(text,end,"captures");
+    if (value!=NULL && *value=='['){
+        const char *first=json_skip_space(value+1,end);
+        if (first<end && *first=='{'){
+            const char *first_end=json_skip_value(first,end);
+            value=json_find(first,first_end,"core:frequency");
+            if (value!=NULL){
+                meta->center_frequency=strtod(value,NULL);
+            }
+        }
+    }
+
+    value=json_find(text,end,"annotations");
+    if (value!=NULL && *value=='['){
+        const char *p=json_skip_space(value+1,end);
+        while (p<end && *p=='{'){
+            const char *object_end=json_skip_value(p,end);
+            IQ_Annotation a;
+            memset(&a,0,sizeof(IQ_Annotation));
+            if ((value=json_find(p,object_end,"core:sample_start"))!=NULL){
+                a.sample_start=strtoull(value,NULL,10);
+            }
+            if ((value=json_find(p,object_end,"core:sample_count"))!=NULL){
+                a.sample_count=strtoull(value,NULL,10);
+            }
+            if ((value=json_find(p,object_end,"core:freq_lower_edge"))!=NULL){
+                a.freq_lower=strtod(value,NULL);
+            }
+            if ((value=json_find(p,object_end,"core:freq_upper_edge"))!=NULL){
+                a.freq_upper=strtod(value,NULL);
+            }
+            if ((value=json_find(p,object_end,"core:label"))!=NULL){
+                json_string(value,object_end,a.label,sizeof(a.label));
+            }
+            add_annotation(meta,&a);
+            p=json_skip_space(object_end,end);
+            if (p<end && *p==','){
+                p=json_skip_space(p+1,end);
+            }
+        }
+    }
+    free(text);
+    return 0;
+}
+
+//Writes a SigMF 1.0 sidecar
+int iq_meta_write(const IQ_Meta *meta, const char *path){
+
+    FILE *f=fopen(path,"w");
+    int i;
+    if (f==NULL){
+        return -1;
+    }
+    fprintf(f,"{\n    \"global\": {\n");
+    fprintf(f,"        \"core:datatype\": \"%s\",\n",format_datatype(meta->format));
+    fprintf(f,"        \"core:sample_rate\": %.17g,\n",meta->sample_rate);
+    fprintf(f,"        \"core:version\": \"1.0.0\"\n    },\n");
+    fprintf(f,"    \"captures\": [\n        {\n            \"core:sample_start\": 0");
+    if (meta->center_frequency!=0){
+        fprintf(f,",\n            \"core:frequency\": %.17g",meta->center_frequency);
+    }
+    fprintf(f,"\n        }\n    ],\n    \"annotations\": [");
+    for (i=0;i<meta->annotation_count;i++){
+        const IQ_Annotation *a=&meta->annotations[i];
+        fprintf(f,"%s\n        {\n",i==0 ? "" : ",");
+        fprintf(f,"            \"core:sample_start\": %llu,\n",(unsigned long long) a->sample_start);
+        fprintf(f,"            \"core:sample_count\": %llu",(unsigned long long) a->sample_count);
+        if (a->freq_lower!=0 || a->freq_upper!=0){
+            fprintf(f,",\n            \"core:freq_lower_edge\": %.17g",a->freq_lower);
+            fprintf(f,",\n            \"core:freq_upper_edge\": %.17g",a->freq_upper);
+        }
+        if (a->label[0]!='\0'){
+            fprintf(f,",\n            \"core:label\": ");
+            json_write_string(f,a->label);
+        }
+        fprintf(f,"\n        }");
+    }
+    fprintf(f,"%s]\n}\n",meta->annotation_count>0 ? "\n    " : "");
+    return fclose(f)==0 ? 0 : -1;
+}
+
+//Frees the annotation list
+void iq_meta_free(IQ_Meta *meta){
+
+    free(meta->annotations);
+    meta->annotations=NULL;
+    meta->annotation_count=0;
+    meta->annotation_capacity=0;
+}
+
+//Bytes per complex sample
+static int format_bytes(IQ_Format format){
+
+    int i;
+    for (i=0;i<IQ_FORMATS;i++){
+        if (iq_formats[i].format==format){
+            return iq_formats[i].bytes;
+        }
+    }
+    return 0;
+}
+
+//SigMF datatype name
+static const char *format_datatype(IQ_Format format){
+
+    int i;
+    for (i=0;i<IQ_FORMATS;i++){
+        if (iq_formats[i].format==format){
+            return iq_formats[i].datatype;
+        }
+    }
+    return "";
+}
+
+//Format from the usual file extensions, case insensitive
+static IQ_Format format_from_extension(const char *path){
+
+    const char *dot=strrchr(path,'.');
+    int i;
+    if (dot==NULL || strchr(dot,'/')!=NULL){
+        return IQ_UNKNOWN;
+    }
+    for (i=0;i<IQ_FORMATS;i++){
+        const char *a=dot,*b=iq_formats[i].extension;
+        while (*a!='\0' && tolower((unsigned char)*a)==*b){
+            a++;
+            b++;
+        }
+        if (*a=='\0' && *b=='\0'){
+            return iq_formats[i].format;
+        }
+    }
+    return IQ_UNKNOWN;
+}
+
+//name.sigmf-data or name.cs16 -> name.sigmf-meta, malloc'd
+static char *meta_path(const char *path){
+
+    const char *dot=strrchr(path,'.');
+    const char *slash=strrchr(path,'/');
+    size_t base=strlen(path);
+    char *out;
+
+    if (dot!=NULL && (slash==NULL || dot>slash) && dot!=path){
+        base=(size_t)(dot-path);
+    }
+    out=(char *) malloc(base+sizeof(".sigmf-meta"));
+    if (out==NULL){
+        return NULL;
+    }
+    memcpy(out,path,base);
+    strcpy(out+base,".sigmf-meta");
+    return out;
+}
+
+//Appends an annotation, growing the list by doubling
+static int add_annotation(IQ_Meta *meta, const IQ_Annotation *a){
+
+    if (meta->annotation_count==meta->annotation_capacity){
+        int capacity= meta->annotation_capacity>0 ? 2*meta->annotation_capacity : 16;
+        IQ_Annotation *grown=(IQ_Annotation *) realloc(meta->annotations,capacity*sizeof(IQ_Annotation));
+        if (grown==NULL){
+            return -1;
+        }
+        meta->annotations=grown;
+        meta->annotation_capacity=capacity;
+    }
+    meta->annotations[meta->annotation_count++]=*a;
+    return 0;
+}
+
+//qsort order for annotations
+static int compare_annotations(const void *a, const void *b){
+
+    uint64_t x=((const IQ_Annotation *) a)->sample_start;
+    uint64_t y=((const IQ_Annotation *) b)->sample_start;
+    return (x>y)-(x<y);
+}
+
+//Skips JSON white space
+static const char *json_skip_space(const char *p, const char *end){
+
+    while (p<end && isspace((unsigned char)*p)){
+        p++;
+    }
+    return p;
+}
+
+//Returns the character after the value starting at p, strings, objects and arrays included
+static const char *json_skip_value(const char *p, const char *end){
+
+    int depth=0;
+    p=json_skip_space(p,end);
+    do {
+        if (p>=end){
+            return end;
+        }
+        if (*p=='"'){
+            for (p++;p<end && *p!='"';p++){
+                if (*p=='\\'){
+                    p++;
+                }
+            }
+            p++;
+        }
+        else if (*p=='{' || *p=='['){
+            depth++;
+            p++;
+        }
+        else if (*p=='}' || *p==']'){
+            depth--;
+            p++;
+        }
+        else if (depth==0){ //number, true, false or null
+            while (p<end && *p!=',' && *p!='}' && *p!=']' && !isspace((unsigned char)*p)){
+                p++;
+            }
+        }
+        else{
+            p++;
+        }
+    } while (depth>0);
+    return p;
+}
+
+//Finds "key": at the top level of the object or array starting at p and returns its value
+static const char *json_find(const char *p, const char *end, const char *key){
+
+    size_t length=strlen(key);
+    p=json_skip_space(p,end);
+    if (p>=end || (*p!='{' && *p!='[')){
+        return NULL;
+    }
+    p++;
+    while ((p=json_skip_space(p,end))<end && *p!='}' && *p!=']'){
+        if (*p=='"'){
+            const char *name=p+1;
+            const char *after=json_skip_value(p,end);
+            const char *colon=json_skip_space(after,end);
+            if (colon<end && *colon==':'){
+                const char *value=json_skip_space(colon+1,end);
+                if ((size_t)(after-name-1)==length && strncmp(name,key,length)==0){
+                    return value;
+                }
+                p=json_skip_value(value,end);
+            }
+            else{
+                p=after;
+            }
+        }
+        else{
+            p=json_skip_value(p,end);
+        }
+        p=json_skip_space(p,end);
+        if (p<end && *p==','){
+            p++;
+        }
+    }
+    return NULL;
+}
+
+//Copies the JSON string at p into out, undoing the simple escapes
+static int json_string(const char *p, const char *end, char *out, int size){
+
+    int n=0;
+    if (p>=end || *p!='"'){
+        return -1;
+    }
+    for (p++;p<end && *p!='"';p++){
+        char c=*p;
+        if (c=='\\' && p+1<end){
+            p++;
+            c= *p=='n' ? '\n' : (*p=='t' ? '\t' : *p);
+        }
+        if (n<size-1){
+            out[n++]=c;
+        }
+    }
+    out[n]='\0';
+    return 0;
+}
+
+//Writes s as a JSON string
+static void json_write_string(FILE *f, const char *s){
+
+    fputc('"',f);
+    for (;*s!='\0';s++){
+        if (*s=='"' || *s=='\\'){
+            fputc('\\',f);
+            fputc(*s,f);
+        }
+        else if (*s=='\n'){
+            fputs("\\n",f);
+        }
+        else if ((unsigned char)*s>=0x20){
+            fputc(*s,f);
+        }
+    }
+    fputc('"',f);
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
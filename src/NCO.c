@@ -0,0 +1,234 @@
+//********************************************************************
+//*                    NCO                                           *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Numerically controlled oscillator with table,       *
+//*             rotator and SIMD polynomial modes                    *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/NCO.h>
+#include <../include/Vector_Ops.h>
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define NCO_LUT_BITS  12                        //table entries per cycle 2^12
+#define NCO_LUT_SIZE  (1<<NCO_LUT_BITS)
+#define NCO_FRACTION  (32-NCO_LUT_BITS)         //phase bits below the table index
+#define NCO_RESYNC    1024                      //rotator samples between restarts from the accumulator
+#define NCO_QUARTER   0x40000000u               //a quarter cycle, cos(x)=sin(x+quarter)
+#define NCO_CHUNK     1024                      //samples generated per pass for nco_complex
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+static float nco_table[NCO_LUT_SIZE+1];  //one cycle of sin plus a guard entry for the interpolation
+static pthread_once_t nco_table_once=PTHREAD_ONCE_INIT;
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int nco_init(NCO *nco, NCO_Mode mode, double sample_rate, double frequency, int bit);
+
+void nco_set_frequency(NCO *nco, double frequency);
+
+void nco_set_phase(NCO *nco, double cycles);
+
+void nco_sin(NCO *nco, float out[], int N);
+
+void nco_cos(NCO *nco, float out[], int N);
+
+void nco_complex(NCO *nco, float out[][2], int N);
+
+void nco_modulate(NCO *nco, const float in[], float offset, float out[], int N);
+
+void nco_mix(NCO *nco, const float in[][2], float out[][2], int N);
+
+static void nco_generate(NCO *nco, uint32_t offset, float out[], int N);
+
+static void nco_table_build(void);
+
+static void nco_lut(uint32_t phase, uint32_t step, float out[], int N);
+
+static void nco_rotator(const NCO *nco, uint32_t phase, float out[], int N);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Sets the mode, frequency and quantisation, the levels are worked out here once rather than per sample
+int nco_init(NCO *nco, NCO_Mode mode, double sample_rate, double frequency, int bit){
+
+    memset(nco,0,sizeof(NCO));
+    if (sample_rate<=0){
+        return -1;
+    }
+    nco->mode=mode;
+    nco->sample_rate=sample_rate;
+    //a float cannot resolve steps finer than 24 bits across [-1,1], so those widths are left unquantised
+    if (bit>0 && bit<24){
+        nco->levels=(float)((ldexp(1,bit)-1)/2);
+    }
+    if (mode==NCO_LUT){
+        pthread_once(&nco_table_once,nco_table_build);
+    }
+    nco_set_frequency(nco,frequency);
+    return 0;
+}
+
+//Converts the frequency to a phase step, the nearest one 2^32 steps per cycle allows
+void nco_set_frequency(NCO *nco, double frequency){
+
+    double cycles=frequency/nco->sample_rate;
+    cycles-=floor(cycles); //negative frequencies become the equivalent step below a full turn
+    nco->step=(uint32_t)(uint64_t) llround(cycles*4294967296.0);
+    nco->rotate[0]=cos(2*M_PI*nco->step/4294967296.0);
+    nco->rotate[1]=sin(2*M_PI*nco->step/4294967296.0);
+}
+
+//Moves the accumulator to a fraction of a cycle
+void nco_set_phase(NCO *nco, double cycles){
+
+    cycles-=floor(cycles);
+    nco->phase=(uint32_t)(uint64_t) llround(cycles*4294967296.0);
+}
+
+//Next block of sin
+void nco_sin(NCO *nco, float out[], int N){
+
+    nco_generate(nco,0,out,N);
+    nco->phase+=(uint32_t)N*nco->step;
+}
+
+//Next block of cos
+void nco_cos(NCO *nco, float out[], int N){
+
+    nco_generate(nco,NCO_QUARTER,out,N);
+    nco->phase+=(uint32_t)N*nco->step;
+}
+
+//Next block of cos + j sin, made a chunk at a time and interleaved
+void nco_complex(NCO *nco, float out[][2], int N){
+
+    float re[NCO_CHUNK],im[NCO_CHUNK];
+    const float *const pair[2]={re,im};
+    int done=0;
+    while (done<N){
+        int n= N-done<NCO_CHUNK ? N-done : NCO_CHUNK;
+        nco_generate(nco,NCO_QUARTER,re,n);
+        nco_generate(nco,0,im,n);
+        vector_interleave(pair,out[done],2,n);
+        nco->phase+=(uint32_t)n*nco->step;
+        done+=n;
+    }
+}
+
+//Next block of cos times the message plus offset. The table and rotator modes make the carrier a chunk at a time.
+void nco_modulate(NCO *nco, const float in[], float offset, float out[], int N){
+
+    float carrier[NCO_CHUNK];
+    float signal[NCO_CHUNK];
+    int done=0;
+    int i;
+    if (nco->mode==NCO_POLY){
+        vector_sine_mix(nco->phase+NCO_QUARTER,nco->step,nco->levels,in,offset,out,N);
+        nco->phase+=(uint32_t)N*nco->step;
+        return;
+    }
+    while (done<N){
+        int n= N-done<NCO_CHUNK ? N-done : NCO_CHUNK;
+        nco_generate(nco,NCO_QUARTER,carrier,n);
+        for (i=0;i<n;i++){
+            signal[i]=in[done+i]+offset;
+        }
+        vector_multiply(carrier,signal,out+done,n);
+        nco->phase+=(uint32_t)n*nco->step;
+        done+=n;
+    }
+}
+
+//Next block of the complex oscillator multiplied into the samples, a chunk at a time
+void nco_mix(NCO *nco, const float in[][2], float out[][2], int N){
+
+    float oscillator[NCO_CHUNK][2];
+    int done=0;
+    while (done<N){
+        int n= N-done<NCO_CHUNK ? N-done : NCO_CHUNK;
+        nco_complex(nco,oscillator,n);
+        vector_complex_multiply(in+done,(const float (*)[2]) oscillator,out+done,n);
+        done+=n;
+    }
+}
+
+//Fills out from the current phase plus offset in the chosen mode, then quantises, the phase itself is not moved
+static void nco_generate(NCO *nco, uint32_t offset, float out[], int N){
+
+    uint32_t phase=nco->phase+offset;
+    switch (nco->mode){
+        case NCO_LUT:
+            nco_lut(phase,nco->step,out,N);
+            break;
+        case NCO_ROTATOR:
+            nco_rotator(nco,phase,out,N);
+            break;
+        case NCO_POLY:
+            vector_sine_phase(phase,nco->step,out,N);
+            break;
+    }
+    if (nco->levels>0){
+        vector_quantize(out,N,nco->levels);
+    }
+}
+
+//Fills the shared sine table, runs once
+static void nco_table_build(void){
+
+    int i;
+    for (i=0;i<=NCO_LUT_SIZE;i++){
+        nco_table[i]=(float) sin(2*M_PI*i/NCO_LUT_SIZE);
+    }
+}
+
+//Top bits of the phase index the table, the rest interpolate between neighbouring entries
+static void nco_lut(uint32_t phase, uint32_t step, float out[], int N){
+
+    int i;
+    const float fraction_scale=1.0f/(1u<<NCO_FRACTION);
+    for (i=0;i<N;i++){
+        uint32_t index=phase>>NCO_FRACTION;
+        float fraction=(float)(phase&((1u<<NCO_FRACTION)-1))*fraction_scale;
+        float a=nco_table[index];
+        out[i]=a+fraction*(nco_table[index+1]-a);
+        phase+=step;
+    }
+}
+
+//z=z*e^(j*step) in double, restarted from the exact accumulator phase every NCO_RESYNC samples so rounding never builds up
+static void nco_rotator(const NCO *nco, uint32_t phase, float out[], int N){
+
+    int i=0;
+    while (i<N){
+        int stop= N-i<NCO_RESYNC ? N : i+NCO_RESYNC;
+        double angle=2*M_PI*phase/4294967296.0;
+        double re=cos(angle),im=sin(angle);
+        for (;i<stop;i++){
+            double next=re*nco->rotate[0]-im*nco->rotate[1];
+            out[i]=(float) im;
+            im=re*nco->rotate[1]+im*nco->rotate[0];
+            re=next;
+        }
+        phase+=(uint32_t)NCO_RESYNC*nco->step;
+    }
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,251 @@
+//********************************************************************
+//*                    PSD                                           *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Welch power spectral density estimate of streamed   *
+//*             data using batched FFTs and fixed memory             *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/tinywav.h>
+#include <../include/PSD.h>
+#include <../include/FFT_Plan.h>
+#include <../include/Vector_Ops.h>
+#include <fftw3.h>
+#include <stdlib.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define PSD_BATCH_POINTS 65536 //samples transformed per batched execution
+#define PSD_MAX_BATCH    64
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int psd_welch_init(PSD_Welch *w, int segment, int hop, Window_Type window, float parameter,
+                   double sample_rate, PSD_Average mode, float alpha);
+
+int psd_welch_push(PSD_Welch *w, const float samples[], int N);
+
+const float *psd_welch_result(PSD_Welch *w);
+
+void psd_welch_reset(PSD_Welch *w);
+
+void psd_welch_destroy(PSD_Welch *w);
+
+int psd_welch(const float data[], int N, int segment, int hop, Window_Type window, float parameter,
+              double sample_rate, PSD_Average mode, float psd[]);
+
+static int psd_process(PSD_Welch *w, int count);
+
+static void psd_accumulate(PSD_Welch *w, const fftwf_complex spectrum[]);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Allocates every buffer the estimate needs and works out the window power normalisation
+int psd_welch_init(PSD_Welch *w, int segment, int hop, Window_Type window, float parameter,
+                   double sample_rate, PSD_Average mode, float alpha){
+
+    int i;
+    double power=0;
+
+    memset(w,0,sizeof(PSD_Welch));
+    if (segment<2 || hop<1 || hop>segment || (mode==PSD_EXPONENTIAL && (alpha<=0 || alpha>1))){
+        return -1;
+    }
+    w->segment=segment;
+    w->hop=hop;
+    w->bins=segment/2+1;
+    w->mode=mode;
+    w->alpha=alpha;
+    w->batch=PSD_BATCH_POINTS/segment;
+    if (w->batch<1){
+        w->batch=1;
+    }
+    if (w->batch>PSD_MAX_BATCH){
+        w->batch=PSD_MAX_BATCH;
+    }
+    w->capacity=segment+(w->batch-1)*hop;
+
+    //first segment points of the cached window give the periodic form used for overlapping segments
+    w->window=window_cache_get(window,segment,parameter);
+    w->history=(float *) fftwf_malloc(w->capacity*sizeof(float));
+    w->frames=(float *) fftwf_malloc((size_t)w->batch*segment*sizeof(float));
+    w->spectra=(fftwf_complex *) fftwf_malloc((size_t)w->batch*w->bins*sizeof(fftwf_complex));
+    w->average=(double *) malloc(w->bins*sizeof(double));
+    w->psd=(float *) malloc(w->bins*sizeof(float));
+    if (w->window==NULL || w->history==NULL || w->frames==NULL || w->spectra==NULL || w->average==NULL || w->psd==NULL){
+        psd_welch_destroy(w);
+        return -1;
+    }
+    w->plan=fft_plan_many(segment,w->batch,TW_INLINE,FFT_R2C,w->frames,w->spectra);
+    if (w->plan==NULL){
+        psd_welch_destroy(w);
+        return -1;
+    }
+
+    for (i=0;i<segment;i++){
+        power+=(double)w->window[i]*w->window[i];
+    }
+    if (sample_rate<=0){
+        sample_rate=1;
+    }
+    w->scale=1/(sample_rate*power);
+
+    psd_welch_reset(w);
+    return 0;
+}
+
+//Buffers samples and averages a whole batch of segments each time the history fills
+int psd_welch_push(PSD_Welch *w, const float samples[], int N){
+
+    int processed=0;
+    while (N>0){
+        int take=w->capacity-w->filled;
+        if (take>N){
+            take=N;
+        }
+        memcpy(w->history+w->filled,samples,take*sizeof(float));
+        w->filled+=take;
+        samples+=take;
+        N-=take;
+
+        if (w->filled==w->capacity){
+            processed+=psd_process(w,w->batch);
+        }
+    }
+    return processed;
+}
+
+//Flushes complete segments still in the history and scales the average to a one sided density
+const float *psd_welch_result(PSD_Welch *w){
+
+    int k;
+    double norm;
+
+    if (w->filled>=w->segment){
+        psd_process(w,1+(w->filled-w->segment)/w->hop);
+    }
+
+    norm=w->scale;
+    if (w->mode==PSD_LINEAR && w->segments>0){
+        norm/=w->segments;
+    }
+    for (k=0;k<w->bins;k++){
+        //every bin apart from DC and Nyquist also carries the power of its negative frequency
+        double fold=(k==0 || (w->segment%2==0 && k==w->bins-1)) ? 1 : 2;
+        w->psd[k]=(float)(w->average[k]*norm*fold);
+    }
+    return w->psd;
+}
+
+//Starts a new estimate, keeps the plan and buffers
+void psd_welch_reset(PSD_Welch *w){
+
+    memset(w->average,0,w->bins*sizeof(double));
+    memset(w->psd,0,w->bins*sizeof(float));
+    w->filled=0;
+    w->segments=0;
+}
+
+//Frees the buffers made by psd_welch_init
+void psd_welch_destroy(PSD_Welch *w){
+
+    fftwf_free(w->history);
+    fftwf_free(w->frames);
+    fftwf_free(w->spectra);
+    free(w->average);
+    free(w->psd);
+    memset(w,0,sizeof(PSD_Welch));
+}
+
+//Welch estimate of a complete buffer in one call
+int psd_welch(const float data[], int N, int segment, int hop, Window_Type window, float parameter,
+              double sample_rate, PSD_Average mode, float psd[]){
+
+    PSD_Welch w;
+    int segments;
+    if (psd_welch_init(&w,segment,hop,window,parameter,sample_rate,mode,mode==PSD_EXPONENTIAL ? 0.1f : 0)!=0){
+        return -1;
+    }
+    psd_welch_push(&w,data,N);
+    memcpy(psd,psd_welch_result(&w),w.bins*sizeof(float));
+    segments=(int)w.segments;
+    psd_welch_destroy(&w);
+    return segments;
+}
+
+//Windows count segments from the history, transforms them and drops the samples no later segment needs
+static int psd_process(PSD_Welch *w, int count){
+
+    int i,used;
+    for (i=0;i<count;i++){
+        vector_multiply(w->window,w->history+i*w->hop,w->frames+(size_t)i*w->segment,w->segment);
+    }
+
+    if (count==w->batch){
+        fftwf_execute_dft_r2c(w->plan,w->frames,w->spectra);
+    }
+    else{ //a short tail at flush time, not worth a plan of its own
+        for (i=0;i<count;i++){
+            float *frame=w->frames+(size_t)i*w->segment;
+            fftwf_complex *spectrum=w->spectra+(size_t)i*w->bins;
+            fftwf_execute_dft_r2c(fft_plan_get(w->segment,FFT_R2C,frame,spectrum),frame,spectrum);
+        }
+    }
+    for (i=0;i<count;i++){
+        psd_accumulate(w,w->spectra+(size_t)i*w->bins);
+    }
+
+    used=count*w->hop;
+    if (used>w->filled){
+        used=w->filled;
+    }
+    memmove(w->history,w->history+used,(w->filled-used)*sizeof(float));
+    w->filled-=used;
+    return count;
+}
+
+//Folds one segment's magnitude squared spectrum into the running average
+static void psd_accumulate(PSD_Welch *w, const fftwf_complex spectrum[]){
+
+    int k;
+    switch (w->mode){
+        case PSD_LINEAR:
+            for (k=0;k<w->bins;k++){
+                w->average[k]+=spectrum[k][0]*spectrum[k][0]+spectrum[k][1]*spectrum[k][1];
+            }
+            break;
+        case PSD_EXPONENTIAL:
+            for (k=0;k<w->bins;k++){
+                double p=spectrum[k][0]*spectrum[k][0]+spectrum[k][1]*spectrum[k][1];
+                w->average[k]= w->segments==0 ? p : w->average[k]+w->alpha*(p-w->average[k]);
+            }
+            break;
+        case PSD_MAX_HOLD:
+            for (k=0;k<w->bins;k++){
+                double p=spectrum[k][0]*spectrum[k][0]+spectrum[k][1]*spectrum[k][1];
+                if (p>w->average[k]){
+                    w->average[k]=p;
+                }
+            }
+            break;
+    }
+    w->segments++;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,182 @@
+//********************************************************************
+//*                    Regression                                    *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Checks for bugs that have been fixed, built and run *
+//*             by make check without GTK or GLG                     *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/tinywav.h>
+#include <../include/Vector_Ops.h>
+#include <../include/Filter_Design.h>
+#include <math.h>
+#include <stdio.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define CHECK_WAV           "regression_check.wav"
+#define CHECK_TAPS          2047
+#define CHECK_TRANSITION    0.003
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int main(void);
+
+static int check_inline_read_at_end(void);
+
+static int check_pcm_round_trip(void);
+
+static int check_long_equiripple(void);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+int main(void){
+
+    int failed=0;
+    failed+=check_inline_read_at_end();
+    failed+=check_pcm_round_trip();
+    failed+=check_long_equiripple();
+    printf("%s\n",failed ? "FAILED" : "passed");
+    return failed!=0;
+}
+
+//A short read of an inlined multichannel buffer keeps len as the channel stride
+static int check_inline_read_at_end(void){
+
+    float in[2][10];
+    float *channels[2]={in[0],in[1]};
+    float out[64];
+    TinyWav tw;
+    int i,got,failed=0;
+
+    for (i=0;i<10;i++){
+        in[0][i]=(i+1)/64.0f;
+        in[1][i]=-(i+1)/64.0f;
+    }
+    if (tinywav_open_write(&tw,2,48000,TW_INT16,TW_SPLIT,CHECK_WAV)!=0){
+        printf("inline read at end: could not write %s\n",CHECK_WAV);
+        return 1;
+    }
+    tinywav_write_f(&tw,channels,10);
+    tinywav_close_write(&tw);
+
+    for (i=0;i<64;i++){
+        out[i]=99;
+    }
+    if (tinywav_open_read(&tw,CHECK_WAV,TW_INLINE,TW_FLOAT32)!=0){
+        printf("inline read at end: could not read %s\n",CHECK_WAV);
+        return 1;
+    }
+    got=tinywav_read_f(&tw,out,32);
+    tinywav_close_read(&tw);
+    remove(CHECK_WAV);
+
+    if (got!=10){
+        failed=1;
+    }
+    for (i=0;i<32;i++){
+        float left= i<10 ? in[0][i] : 99;
+        float right= i<10 ? in[1][i] : 99;
+        if (out[i]!=left || out[32+i]!=right){
+            failed=1;
+        }
+    }
+    printf("inline read at end: %s\n",failed ? "FAILED" : "passed");
+    return failed;
+}
+
+//Steps of 1/32 from -1 are exact in every signed width, so each one decodes back to itself.
+//64 samples run the vector kernels as well as their scalar tails.
+static int check_pcm_round_trip(void){
+
+    float in[64],out[64];
+    int8_t s8[64];
+    int16_t s16[64];
+    uint8_t s24[64*3];
+    int32_t s32[64];
+    int i,width,failed=0;
+
+    for (i=0;i<64;i++){
+        in[i]=i/32.0f-1.0f;
+    }
+    for (width=8;width<=32;width+=8){
+        switch (width){
+            case 8: vector_float_to_s8(in,s8,64); vector_s8_to_float(s8,out,64); break;
+            case 16: vector_float_to_s16(in,s16,64); vector_s16_to_float(s16,out,64); break;
+            case 24: vector_float_to_s24(in,s24,64); vector_s24_to_float(s24,out,64); break;
+            default: vector_float_to_s32(in,s32,64); vector_s32_to_float(s32,out,64); break;
+        }
+        for (i=0;i<64;i++){
+            if (out[i]!=in[i]){
+                printf("pcm round trip: %d bit %g came back as %g\n",width,in[i],out[i]);
+                failed=1;
+                break;
+            }
+        }
+    }
+    printf("pcm round trip: %s\n",failed ? "FAILED" : "passed");
+    return failed;
+}
+
+//Long designs whose extremal set used to come up short of r+1 points. Outside the transition
+//every sample of the response has to be within the ripple the spec reaches.
+static int check_long_equiripple(void){
+
+    static const struct { int length; double cutoff; double depth_db; } specs[]={
+        {1500,0.25,73},
+        {2047,0.1,96}
+    };
+    static float taps[CHECK_TAPS];
+    int s,i,n,failed=0;
+
+    for (s=0;s<(int)(sizeof(specs)/sizeof(specs[0]));s++){
+        int length=specs[s].length;
+        double cutoff=specs[s].cutoff;
+        double ripple=pow(10,-specs[s].depth_db/20);
+        double worst=0;
+        if (filter_design_equiripple(FILTER_LOWPASS,length,cutoff,0,CHECK_TRANSITION,1,taps)!=0){
+            printf("long equiripple: %d taps at %g did not converge\n",length,cutoff);
+            failed=1;
+            continue;
+        }
+        for (i=0;i<=2*length;i++){
+            double freq=0.25*i/length;
+            double amplitude=0;
+            if (fabs(freq-cutoff)<CHECK_TRANSITION/2){
+                continue;
+            }
+            for (n=0;n<length;n++){
+                amplitude+=taps[n]*cos(2*M_PI*freq*(n-(length-1)/2.0));
+            }
+            amplitude=fabs(amplitude-(freq<cutoff ? 1 : 0));
+            if (amplitude>worst){
+                worst=amplitude;
+            }
+        }
+        if (worst>ripple){
+            printf("long equiripple: %d taps at %g only %.1f dB, %.0f wanted\n",
+                   length,cutoff,-20*log10(worst),specs[s].depth_db);
+            failed=1;
+        }
+    }
+    printf("long equiripple: %s\n",failed ? "FAILED" : "passed");
+    return failed;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
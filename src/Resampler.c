@@ -0,0 +1,169 @@
+//********************************************************************
+//*                    Resampler                                     *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Polyphase rational resampler for moving audio       *
+//*             between the 44.1/48/88.2/96 kHz sampling rates       *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Resampler.h>
+#include <../include/Filter_Design.h>
+#include <../include/Vector_Ops.h>
+#include <fftw3.h>
+#include <math.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define RESAMPLER_CHUNK     4096    //input samples appended to the history per pass
+#define RESAMPLER_TAPS      64      //taps per phase when interpolating, more when decimating
+#define RESAMPLER_BETA      8.0     //Kaiser window shape, about 80 dB stop band
+#define RESAMPLER_PASSBAND  0.45    //of the lower rate, the pass band edge
+#define RESAMPLER_MAX_BANK  (1<<24) //largest bank L*taps, guards against rates with no common factor
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int resampler_init(Resampler *rs, int input_rate, int output_rate);
+
+int resampler_max_output(const Resampler *rs, int N);
+
+int resampler_process(Resampler *rs, const float in[], int N, float out[]);
+
+void resampler_reset(Resampler *rs);
+
+void resampler_destroy(Resampler *rs);
+
+static int gcd(int a, int b);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Reduces the rates to L/M and designs one Kaiser windowed sinc, dealt out to the L phases
+int resampler_init(Resampler *rs, int input_rate, int output_rate){
+
+    int common,length,i;
+    double low,cutoff;
+    float *prototype;
+
+    memset(rs,0,sizeof(Resampler));
+    if (input_rate<=0 || output_rate<=0){
+        return -1;
+    }
+    common=gcd(input_rate,output_rate);
+    rs->input_rate=input_rate;
+    rs->output_rate=output_rate;
+    rs->L=output_rate/common;
+    rs->M=input_rate/common;
+    //decimating needs a narrower filter in input samples, so more taps for the same transition band
+    rs->taps= rs->M>rs->L ? (int) ceil((double)RESAMPLER_TAPS*rs->M/rs->L) : RESAMPLER_TAPS;
+    if ((double)rs->L*rs->taps>RESAMPLER_MAX_BANK){
+        return -1;
+    }
+    length=rs->L*rs->taps;
+    rs->bank=(float *) fftwf_malloc((size_t)length*sizeof(float));
+    rs->buffer=(float *) fftwf_malloc((size_t)(rs->taps-1+RESAMPLER_CHUNK)*sizeof(float));
+    prototype=(float *) fftwf_malloc((size_t)length*sizeof(float));
+    if (rs->bank==NULL || rs->buffer==NULL || prototype==NULL){
+        fftwf_free(prototype);
+        resampler_destroy(rs);
+        return -1;
+    }
+
+    //cut off halfway between the pass band edge and the lower Nyquist, in cycles per upsampled sample
+    low= rs->L>rs->M ? rs->M : rs->L;
+    cutoff=(RESAMPLER_PASSBAND+0.5)/2*low/((double)rs->L*rs->M);
+    if (filter_design_window(FILTER_LOWPASS,length,cutoff,0,WINDOW_KAISER,RESAMPLER_BETA,prototype)!=0){
+        fftwf_free(prototype);
+        resampler_destroy(rs);
+        return -1;
+    }
+    for (i=0;i<length;i++){
+        //tap i belongs to phase i%L, as its (i/L)th tap counted back from the newest sample
+        int phase=i%rs->L;
+        int tap=i/rs->L;
+        rs->bank[phase*rs->taps+rs->taps-1-tap]=prototype[i]*rs->L; //L makes up for the zeros interpolation puts in
+    }
+    fftwf_free(prototype);
+    resampler_reset(rs);
+    return 0;
+}
+
+//Each input adds L upsampled steps and each output takes M
+int resampler_max_output(const Resampler *rs, int N){
+
+    return (int)(((long long)N*rs->L+rs->M-1)/rs->M)+1;
+}
+
+//Appends a chunk to the history and makes every output whose newest sample has arrived
+int resampler_process(Resampler *rs, const float in[], int N, float out[]){
+
+    int done=0;
+    int count=0;
+    while (done<N){
+        int n= N-done<RESAMPLER_CHUNK ? N-done : RESAMPLER_CHUNK;
+        int drop;
+        memcpy(rs->buffer+rs->fill,in+done,(size_t)n*sizeof(float));
+        rs->fill+=n;
+        done+=n;
+
+        while (rs->position<rs->fill){
+            out[count++]=vector_dot(rs->bank+(size_t)rs->phase*rs->taps,rs->buffer+rs->position-rs->taps+1,rs->taps);
+            rs->phase+=rs->M;
+            rs->position+=rs->phase/rs->L;
+            rs->phase%=rs->L;
+        }
+
+        //keep what the next output reaches back to, a large decimation can jump past the whole chunk
+        drop=rs->position-(rs->taps-1);
+        if (drop>rs->fill){
+            drop=rs->fill;
+        }
+        memmove(rs->buffer,rs->buffer+drop,(size_t)(rs->fill-drop)*sizeof(float));
+        rs->fill-=drop;
+        rs->position-=drop;
+    }
+    return count;
+}
+
+//Zero history, the first output lines up with the first input
+void resampler_reset(Resampler *rs){
+
+    memset(rs->buffer,0,(size_t)(rs->taps-1)*sizeof(float));
+    rs->fill=rs->taps-1;
+    rs->position=rs->taps-1;
+    rs->phase=0;
+}
+
+void resampler_destroy(Resampler *rs){
+
+    fftwf_free(rs->bank);
+    fftwf_free(rs->buffer);
+    memset(rs,0,sizeof(Resampler));
+}
+
+static int gcd(int a, int b){
+
+    while (b!=0){
+        int t=a%b;
+        a=b;
+        b=t;
+    }
+    return a;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -1,247 +1,518 @@
-//********************************************************************
-//*                    SDR                                           *
-//*==================================================================*
-//* WRITTEN BY: Liam McEvoy    	                 		             *
-//* DATE CREATED:   01/01/21                                         *
-//* MODIFIED:                                                        *
-//*==================================================================*
-//* PROGRAMMED IN: Visual Studio                                     *
-//*==================================================================*
-//* DESCRIPTION: Program to capture and process sampled data for     *
-//*             Software Defined Radio program                       *
-//********************************************************************
-// INCLUDE FILES
-//====================================================================
-
-#include <../include/Test_Data.h>
-#include <../include/tinywav.h>
-#include <fftw3.h>
-#include <math.h>
-#include <stdlib.h>
-//====================================================================
-// SYMBOLIC CONSTANTS
-//====================================================================
-#define _USE_MATH_DEFINES
-//====================================================================
-// GLOBAL VARIABLES
-//====================================================================
-
-//====================================================================
-// FUNCTION DECLARATIONS
-//====================================================================
-int triangle(int window_size, float data[]);
-
-int Welch(int window_size, float data[]);
-
-int Sine(int window_size, float data[]);
-
-int Hann(int window_size, float data[]);
-
-int Hamming(int window_size, float data[]);
-
-int Blackman(int window_size, float data[]);
-
-int Gaussian(int window_size, float data[],float delta);
-
-int multiply(float window[],float data[],int window_size, float final_data[]);
-
-int divide(float window[],float data[],int window_size, float final_data[]);
-
-int writetextc(float data[][2],int N,char *name);
-
-int writetextf(float data[],int N,char *name, bool normalised);
-
-int testsdr(void);
-
-//====================================================================
-// FUNCTION DEFINITIONS
-//====================================================================
-
-//Simple Triangle window for Signal Processing
-int triangle(int window_size, float data[]){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=1-(i*(window_size/2))/(window_size/2);
-    }
-    return 0;
-}
-
-//Simple Welch window for Signal Processing
-int Welch(int window_size, float data[]){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=1-powf(((i-(window_size/2))/(window_size/2)),2);
-    }
-    return 0;
-}
-
-//Simple Sine window for Signal Processing
-int Sine(int window_size, float data[]){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=sinf((M_PI*i)/window_size);
-    }
-    return 0;
-}
-
-//Simple Hann window for Signal Processing
-int Hann(int window_size, float data[]){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=powf(sinf((M_PI*i)/window_size),2);
-    }
-    return 0;
-}
-
-//Simple Hamming window for Signal Processing
-int Hamming(int window_size,float data[]){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=0.54 + 0.46*cosf((2*M_PI/window_size)*i);
-    }
-    return 0;
-}
-
-//Simple Blackman window for Signal Processing
-int Blackman(int window_size, float data[]){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=0.42 - 0.5*cosf((2*M_PI/window_size)*i)+  0.08*cosf((2*M_PI/window_size)*i);
-    }
-    return 0;
-}
-
-//Simple Gaussian window for Signal Processing
-int Gaussian(int window_size, float data[],float delta){
-    
-    int i;
-    for (i=0;i<=window_size;i++){
-        data[i]=expf(-0.5*powf((i-(window_size/2))/(delta*window_size/2),2));
-    }
-    return 0;
-}
-
-//Simple array multiplication for multiplying data input with a window
-int multiply( float window[],float data[],int window_size,float final_data[]){
-    
-    int i;
-    for(i=0;i<=window_size;i++){
-        final_data[i]= window[i]*data[i];
-    }
-    return 0;
-}
-
-//Simple array division for dividing data output with a window
-int divide(float window[],float data[],int window_size, float final_data[]){
-    
-    int i;
-    for(i=0;i<=window_size;i++){
-        final_data[i]= data[i]/window[i];
-    }
-    return 0;
-}
-
-//Write a float data array to a txt file with option of dividing data by its array length for normalisation
-int writetextf(float data[],int N,char *name, bool normalised){
-     
-    FILE *f = fopen(name, "w");
-    if (f == NULL){
-        printf("Error opening file!\n");
-        exit(1);
-    }
-    int i;
-    for (i=0;i<=N;i++){
-        if (normalised==0)
-            fprintf(f,"%f\n", data[i]/N);
-        else{
-            fprintf(f,"%f\n", data[i]);
-        }
-     
-        
-    }
-    
-    fclose(f);
-    return 0;
-}
-
-//Write a float data array to a txt file used for writing complex data created from FFTW3 library
-int writetextc(float data[][2],int N,char *name){
-    
-    FILE *f = fopen(name, "w");
-    if (f == NULL){
-        printf("Error opening file!\n");
-        exit(1);
-    }
-    int i;
-    for (i=0;i<=N;i++){
-        fprintf(f,"%f\n ", data[i][0]); 
-    }
-    
-    fclose(f);
-    return 0;
-}
-
-//simple test function that tests the writing of a wav file as well as testing the FFTW library by writing txt files for original data, transformed data(Frequency domain) and transformed data(Time domain)
-int testsdr(void){
-     
-    int NUM_CHANNELS,SAMPLE_RATE,BLOCK_SIZE;
-    NUM_CHANNELS=1,SAMPLE_RATE=48000,BLOCK_SIZE=48000;
-    
-    TinyWav tw;
-    char * outputPath;
-    outputPath="../data/output.wav"; 
-    tinywav_open_write(&tw, NUM_CHANNELS, SAMPLE_RATE, TW_FLOAT32, TW_INLINE, outputPath);
-    
-    
-    int Number_of_samples;
-    Number_of_samples=SAMPLE_RATE;
-    float datain[Number_of_samples];
-    double frequency;
-    frequency=1000;
-    int i;
-    for(i=0;i<10;i++){ //wav file of sinewave with increasing frequency every second
-        Create_Sine_Wave(SAMPLE_RATE,frequency,Number_of_samples,16,0, datain);
-        tinywav_write_f(&tw, datain, Number_of_samples);
-        frequency=frequency+1000;
-    }
-    tinywav_close_write(&tw);
-    
-    float datatest[Number_of_samples];
-    Create_Sine_Wave(SAMPLE_RATE,1000,Number_of_samples,16,0, datatest);
-
-    float *out;
-    fftwf_complex *out_cpx;
-
-    out = (float *) malloc(BLOCK_SIZE*sizeof(float));
-
-    fftwf_plan fft;
-    fftwf_plan ifft;
-
-    out_cpx = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex)*BLOCK_SIZE);
-
-    fft=fftwf_plan_dft_r2c_1d(BLOCK_SIZE, datatest, out_cpx, FFTW_MEASURE);
-    fftwf_execute(fft); 
-    writetextc(out_cpx,BLOCK_SIZE,"../data/Test fft");
-
-    ifft=fftwf_plan_dft_c2r_1d(BLOCK_SIZE, out_cpx,  out,FFTW_MEASURE);
-    fftwf_execute(ifft);
-    writetextf(out,BLOCK_SIZE,"../data/Test ifft",0);
-    writetextf(datatest,BLOCK_SIZE,"../data/Test data",1);
-
-    fftwf_destroy_plan(fft);
-    fftwf_destroy_plan(ifft);
-    free(out);fftwf_free(out_cpx);
-    
-    return 0;
-}
-
-
-//********************************************************************
-// END OF PROGRAM
+//********************************************************************
+//*                    SDR                                           *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   01/01/21                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Program to capture and process sampled data for     *
+//*             Software Defined Radio program                       *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/SDR.h>
+#include <../include/Test_Data.h>
+#include <../include/tinywav.h>
+#include <../include/Vector_Ops.h>
+#include <../include/FFT_Plan.h>
+#include <fftw3.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define _USE_MATH_DEFINES
+#define TEXT_BUFFER 65536     //text is formatted here and written in bulk
+#define TEXT_LINE   64        //longest line format_fixed can add
+#define DUMP_BUFFER (1<<20)   //stdio buffer of a Dump_File
+#define NPY_HEADER  128       //.npy header size, a multiple of 64 as the format asks
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int triangle(int window_size, float data[]);
+
+int Welch(int window_size, float data[]);
+
+int Sine(int window_size, float data[]);
+
+int Hann(int window_size, float data[]);
+
+int Hamming(int window_size, float data[]);
+
+int Blackman(int window_size, float data[]);
+
+int Gaussian(int window_size, float data[],float delta);
+
+int Kaiser(int window_size, float data[],float beta);
+
+double bessel_i0(double x);
+
+int multiply(float window[],float data[],int window_size, float final_data[]);
+
+int divide(float window[],float data[],int window_size, float final_data[]);
+
+int multiply_inplace(const float window[],float data[],int window_size);
+
+int divide_reciprocal(const float inverse[],float data[],int window_size, float final_data[]);
+
+int divide_reciprocal_inplace(const float inverse[],float data[],int window_size);
+
+int multiply_c(const float window[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]);
+
+int divide_c(const float window[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]);
+
+int multiply_inplace_c(const float window[],fftwf_complex data[],int window_size);
+
+int divide_reciprocal_c(const float inverse[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]);
+
+int divide_reciprocal_inplace_c(const float inverse[],fftwf_complex data[],int window_size);
+
+int writetextc(float data[][2],int N,char *name);
+
+int writetextf(float data[],int N,char *name, bool normalised);
+
+int writebinf(const float data[],int N,const char *name,Dump_Format format);
+
+int writebinc(const float data[][2],int N,const char *name,Dump_Format format);
+
+int dump_open(Dump_File *d,const char *name,Dump_Format format,bool complex_data,int frame_length);
+
+int dump_frame(Dump_File *d,const float data[]);
+
+int dump_close(Dump_File *d);
+
+int testsdr(void);
+
+static void npy_header(Dump_File *d);
+
+static int format_fixed(char *out,double x);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Simple Triangle window for Signal Processing
+int triangle(int window_size, float data[]){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=1-fabsf((i-window_size/2.0f)/(window_size/2.0f));
+    }
+    return 0;
+}
+
+//Simple Welch window for Signal Processing
+int Welch(int window_size, float data[]){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=1-powf((i-window_size/2.0f)/(window_size/2.0f),2);
+    }
+    return 0;
+}
+
+//Simple Sine window for Signal Processing
+int Sine(int window_size, float data[]){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=sinf((M_PI*i)/window_size);
+    }
+    return 0;
+}
+
+//Simple Hann window for Signal Processing
+int Hann(int window_size, float data[]){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=powf(sinf((M_PI*i)/window_size),2);
+    }
+    return 0;
+}
+
+//Simple Hamming window for Signal Processing
+int Hamming(int window_size,float data[]){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=0.54 - 0.46*cosf((2*M_PI/window_size)*i);
+    }
+    return 0;
+}
+
+//Simple Blackman window for Signal Processing
+int Blackman(int window_size, float data[]){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=0.42 - 0.5*cosf((2*M_PI/window_size)*i)+  0.08*cosf((4*M_PI/window_size)*i);
+    }
+    return 0;
+}
+
+//Simple Gaussian window for Signal Processing
+int Gaussian(int window_size, float data[],float delta){
+    
+    int i;
+    for (i=0;i<=window_size;i++){
+        data[i]=expf(-0.5*powf((i-window_size/2.0f)/(delta*window_size/2.0f),2));
+    }
+    return 0;
+}
+
+//Kaiser window for filter design, beta trades main lobe width for side lobe level
+int Kaiser(int window_size, float data[],float beta){
+    
+    int i;
+    double scale=1/bessel_i0(beta);
+    for (i=0;i<=window_size;i++){
+        double ratio=(2.0*i-window_size)/window_size;
+        data[i]=(float)(bessel_i0(beta*sqrt(fmax(0,1-ratio*ratio)))*scale);
+    }
+    return 0;
+}
+
+//Modified Bessel function of the first kind, order 0, by its power series
+double bessel_i0(double x){
+    
+    double sum=1,term=1;
+    int k;
+    for (k=1;k<50 && term>1e-12*sum;k++){
+        term*=(x/(2*k))*(x/(2*k));
+        sum+=term;
+    }
+    return sum;
+}
+
+//Simple array multiplication for multiplying data input with a window
+int multiply( float window[],float data[],int window_size,float final_data[]){
+    
+    vector_multiply(window,data,final_data,window_size+1);
+    return 0;
+}
+
+//Simple array division for dividing data output with a window
+int divide(float window[],float data[],int window_size, float final_data[]){
+    
+    vector_divide(data,window,final_data,window_size+1);
+    return 0;
+}
+
+//Applies a window to the data without a separate output array
+int multiply_inplace(const float window[],float data[],int window_size){
+    
+    vector_multiply_inplace(window,data,window_size+1);
+    return 0;
+}
+
+//Removes a window from data using a precomputed reciprocal table (see window_cache_get_inverse) so no division is done per sample
+int divide_reciprocal(const float inverse[],float data[],int window_size, float final_data[]){
+    
+    vector_multiply(inverse,data,final_data,window_size+1);
+    return 0;
+}
+
+//In place version of divide_reciprocal
+int divide_reciprocal_inplace(const float inverse[],float data[],int window_size){
+    
+    vector_multiply_inplace(inverse,data,window_size+1);
+    return 0;
+}
+
+//Complex version of multiply, windows an IQ block
+int multiply_c(const float window[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]){
+    
+    vector_multiply_real_complex(window,data,final_data,window_size+1);
+    return 0;
+}
+
+//Complex version of divide
+int divide_c(const float window[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]){
+    
+    vector_divide_real_complex(window,data,final_data,window_size+1);
+    return 0;
+}
+
+//Complex version of multiply_inplace
+int multiply_inplace_c(const float window[],fftwf_complex data[],int window_size){
+    
+    vector_multiply_real_complex(window,data,data,window_size+1);
+    return 0;
+}
+
+//Complex version of divide_reciprocal
+int divide_reciprocal_c(const float inverse[],const fftwf_complex data[],int window_size, fftwf_complex final_data[]){
+    
+    vector_multiply_real_complex(inverse,data,final_data,window_size+1);
+    return 0;
+}
+
+//Complex version of divide_reciprocal_inplace
+int divide_reciprocal_inplace_c(const float inverse[],fftwf_complex data[],int window_size){
+    
+    vector_multiply_real_complex(inverse,data,data,window_size+1);
+    return 0;
+}
+
+//Write a float data array to a txt file with option of dividing data by its array length for normalisation
+int writetextf(float data[],int N,char *name, bool normalised){
+     
+    FILE *f = fopen(name, "w");
+    if (f == NULL){
+        printf("Error opening file!\n");
+        exit(1);
+    }
+    char buffer[TEXT_BUFFER];
+    int used=0;
+    int i;
+    for (i=0;i<N;i++){
+        double x= normalised==0 ? (double)data[i]/N : data[i];
+        used+=format_fixed(buffer+used,x);
+        buffer[used++]='\n';
+        if (used>TEXT_BUFFER-TEXT_LINE){ //lines are formatted into one buffer and written in bulk
+            fwrite(buffer,1,used,f);
+            used=0;
+        }
+    }
+    fwrite(buffer,1,used,f);
+    
+    fclose(f);
+    return 0;
+}
+
+//Write a float data array to a txt file used for writing complex data created from FFTW3 library
+int writetextc(float data[][2],int N,char *name){
+    
+    FILE *f = fopen(name, "w");
+    if (f == NULL){
+        printf("Error opening file!\n");
+        exit(1);
+    }
+    char buffer[TEXT_BUFFER];
+    int used=0;
+    int i;
+    for (i=0;i<N;i++){
+        used+=format_fixed(buffer+used,data[i][0]);
+        buffer[used++]='\n';
+        buffer[used++]=' ';
+        if (used>TEXT_BUFFER-TEXT_LINE){
+            fwrite(buffer,1,used,f);
+            used=0;
+        }
+    }
+    fwrite(buffer,1,used,f);
+    
+    fclose(f);
+    return 0;
+}
+
+//Write a float data array in one bulk write as raw float32 or a NumPy .npy file (DUMP_TEXT falls back to writetextf)
+int writebinf(const float data[],int N,const char *name,Dump_Format format){
+    
+    Dump_File d;
+    if (dump_open(&d,name,format,false,N)!=0){
+        return -1;
+    }
+    dump_frame(&d,data);
+    return dump_close(&d);
+}
+
+//Write complex data from the FFTW3 library as interleaved float32 pairs, raw or .npy complex64
+int writebinc(const float data[][2],int N,const char *name,Dump_Format format){
+    
+    Dump_File d;
+    if (dump_open(&d,name,format,true,N)!=0){
+        return -1;
+    }
+    dump_frame(&d,(const float *) data);
+    return dump_close(&d);
+}
+
+//Opens a file that frames of a fixed length are appended to, .npy files get their shape when closed
+int dump_open(Dump_File *d,const char *name,Dump_Format format,bool complex_data,int frame_length){
+    
+    memset(d,0,sizeof(Dump_File));
+    if (frame_length<1){ //checked before fopen so a bad call leaves an existing file alone
+        return -1;
+    }
+    d->f=fopen(name,format==DUMP_TEXT ? "w" : "wb");
+    if (d->f==NULL){
+        return -1;
+    }
+    d->buffer=(char *) malloc(DUMP_BUFFER);
+    if (d->buffer!=NULL){
+        setvbuf(d->f,d->buffer,_IOFBF,DUMP_BUFFER); //frames go to the disk in large writes
+    }
+    d->format=format;
+    d->complex_data=complex_data;
+    d->frame_length=frame_length;
+    if (format==DUMP_NPY){
+        npy_header(d); //placeholder of the final size, rewritten by dump_close
+    }
+    return 0;
+}
+
+//Appends one frame, frame_length floats or frame_length complex pairs
+int dump_frame(Dump_File *d,const float data[]){
+    
+    int values=d->complex_data ? 2*d->frame_length : d->frame_length;
+    if (d->format==DUMP_TEXT){
+        char buffer[TEXT_BUFFER];
+        int used=0;
+        int i;
+        for (i=0;i<values;i++){
+            used+=format_fixed(buffer+used,data[i]);
+            //complex values are written "re im" one per line
+            buffer[used++]= (d->complex_data && (i&1)==0) ? ' ' : '\n';
+            if (used>TEXT_BUFFER-TEXT_LINE){
+                fwrite(buffer,1,used,d->f);
+                used=0;
+            }
+        }
+        fwrite(buffer,1,used,d->f);
+    }
+    else if (fwrite(data,sizeof(float),values,d->f)!=(size_t)values){
+        return -1;
+    }
+    d->frames++;
+    return 0;
+}
+
+//Flushes the buffered frames and completes the .npy header
+int dump_close(Dump_File *d){
+    
+    int error=0;
+    if (d->format==DUMP_NPY){
+        fseek(d->f,0,SEEK_SET);
+        npy_header(d);
+    }
+    if (fclose(d->f)!=0){
+        error=-1;
+    }
+    free(d->buffer);
+    memset(d,0,sizeof(Dump_File));
+    return error;
+}
+
+//Writes the NumPy format 1.0 header, padded to NPY_HEADER bytes so the final shape always fits in the placeholder
+static void npy_header(Dump_File *d){
+    
+    char header[NPY_HEADER];
+    int length;
+    memset(header,' ',NPY_HEADER);
+    memcpy(header,"\x93NUMPY\x01\x00",8);
+    header[8]=(char)((NPY_HEADER-10)&0xff);
+    header[9]=(char)((NPY_HEADER-10)>>8);
+    if (d->frames==1){ //a single frame is written as a 1D array
+        length=snprintf(header+10,NPY_HEADER-10,"{'descr': '%s', 'fortran_order': False, 'shape': (%d,), }",
+                        d->complex_data ? "<c8" : "<f4",d->frame_length);
+    }
+    else{
+        length=snprintf(header+10,NPY_HEADER-10,"{'descr': '%s', 'fortran_order': False, 'shape': (%ld, %d), }",
+                        d->complex_data ? "<c8" : "<f4",d->frames,d->frame_length);
+    }
+    header[10+length]=' '; //snprintf's terminator becomes padding
+    header[NPY_HEADER-1]='\n';
+    fwrite(header,1,NPY_HEADER,d->f);
+}
+
+//Formats x like printf("%f") without the cost of printf, returns the characters written
+static int format_fixed(char *out,double x){
+    
+    char digits[24];
+    int n=0,length=0;
+    uint64_t scaled,whole;
+    uint32_t fraction;
+    int i;
+
+    if (!isfinite(x) || fabs(x)>=1e12){ //x*1e6 must stay below UINT64_MAX
+        return sprintf(out,"%f",x);
+    }
+    if (signbit(x)){
+        out[length++]='-';
+        x=-x;
+    }
+    scaled=(uint64_t) nearbyint(x*1e6); //exact for float data, ties to even like printf
+    whole=scaled/1000000;
+    fraction=(uint32_t)(scaled%1000000);
+    do {
+        digits[n++]=(char)('0'+whole%10);
+        whole/=10;
+    } while (whole>0);
+    while (n>0){
+        out[length++]=digits[--n];
+    }
+    out[length++]='.';
+    for (i=5;i>=0;i--){
+        out[length+i]=(char)('0'+fraction%10);
+        fraction/=10;
+    }
+    return length+6;
+}
+
+//simple test function that tests the writing of a wav file as well as testing the FFTW library by writing txt files for original data, transformed data(Frequency domain) and transformed data(Time domain)
+int testsdr(void){
+     
+    int NUM_CHANNELS,SAMPLE_RATE,BLOCK_SIZE;
+    NUM_CHANNELS=1,SAMPLE_RATE=48000,BLOCK_SIZE=48000;
+    
+    TinyWav tw;
+    char * outputPath;
+    outputPath="../data/output.wav"; 
+    tinywav_open_write(&tw, NUM_CHANNELS, SAMPLE_RATE, TW_FLOAT32, TW_INLINE, outputPath);
+    
+    
+    int Number_of_samples;
+    Number_of_samples=SAMPLE_RATE;
+    float datain[Number_of_samples];
+    double frequency;
+    frequency=1000;
+    int i;
+    for(i=0;i<10;i++){ //wav file of sinewave with increasing frequency every second
+        Create_Sine_Wave(SAMPLE_RATE,frequency,Number_of_samples,16,0, datain);
+        tinywav_write_f(&tw, datain, Number_of_samples);
+        frequency=frequency+1000;
+    }
+    tinywav_close_write(&tw);
+    
+    float datatest[Number_of_samples];
+    Create_Sine_Wave(SAMPLE_RATE,1000,Number_of_samples,16,0, datatest);
+
+    float *out;
+    fftwf_complex *out_cpx;
+
+    out = (float *) malloc(BLOCK_SIZE*sizeof(float));
+
+    fftwf_plan fft;
+    fftwf_plan ifft;
+
+    out_cpx = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex)*BLOCK_SIZE);
+
+    fft=fft_plan_get(BLOCK_SIZE,FFT_R2C,datatest,out_cpx); //measured once per host then read back from wisdom
+    fftwf_execute_dft_r2c(fft,datatest,out_cpx); 
+    writetextc(out_cpx,BLOCK_SIZE,"../data/Test fft");
+
+    ifft=fft_plan_get(BLOCK_SIZE,FFT_C2R,out_cpx,out);
+    fftwf_execute_dft_c2r(ifft,out_cpx,out);
+    writetextf(out,BLOCK_SIZE,"../data/Test ifft",0);
+    writetextf(datatest,BLOCK_SIZE,"../data/Test data",1);
+
+    free(out);fftwf_free(out_cpx);
+    
+    return 0;
+}
+
+
+//********************************************************************
+// END OF PROGRAM
 //********************************************************************
\ No newline at end of file
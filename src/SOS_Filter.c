@@ -0,0 +1,161 @@
+//********************************************************************
+//*                    SOS Filter                                    *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Cascaded biquad IIR filter for many channels, one   *
+//*             channel per SIMD lane                                *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/SOS_Filter.h>
+#include <../include/Vector_Ops.h>
+#include <fftw3.h>
+#include <math.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define SOS_CHUNK           256     //frames per pass, a group of them stays in L1 through every section
+#define SOS_DENORMAL        1e-30f  //state below this is flushed to zero after each chunk
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int sos_filter_init(SOS_Filter *f, const Biquad sections[], int count, int channels);
+
+int sos_filter_set_channel(SOS_Filter *f, int channel, const Biquad sections[]);
+
+int sos_filter_process(SOS_Filter *f, const float in[], float out[], int frames);
+
+void sos_filter_reset(SOS_Filter *f);
+
+void sos_filter_destroy(SOS_Filter *f);
+
+static void flush_denormals(float state[], int N);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Lays the sections out lane by lane, padding lanes get the same sections and are fed zeros
+int sos_filter_init(SOS_Filter *f, const Biquad sections[], int count, int channels){
+
+    int lanes,channel;
+
+    memset(f,0,sizeof(SOS_Filter));
+    if (sections==NULL || count<1 || channels<1){
+        return -1;
+    }
+    f->channels=channels;
+    f->sections=count;
+    f->groups=(channels+SOS_LANES-1)/SOS_LANES;
+    lanes=f->groups*SOS_LANES;
+    f->coefficients=(float *) fftwf_malloc((size_t)f->groups*count*5*SOS_LANES*sizeof(float));
+    f->state=(float *) fftwf_malloc((size_t)f->groups*count*2*SOS_LANES*sizeof(float));
+    if (lanes!=channels){
+        f->work=(float *) fftwf_malloc((size_t)SOS_CHUNK*lanes*sizeof(float));
+    }
+    if (f->coefficients==NULL || f->state==NULL || (lanes!=channels && f->work==NULL)){
+        sos_filter_destroy(f);
+        return -1;
+    }
+    if (f->work!=NULL){
+        memset(f->work,0,(size_t)SOS_CHUNK*lanes*sizeof(float));
+    }
+    for (channel=0;channel<lanes;channel++){
+        sos_filter_set_channel(f,channel,sections);
+    }
+    sos_filter_reset(f);
+    return 0;
+}
+
+//Writes a channel's lane of every section
+int sos_filter_set_channel(SOS_Filter *f, int channel, const Biquad sections[]){
+
+    int group=channel/SOS_LANES;
+    int lane=channel%SOS_LANES;
+    int j;
+    if (sections==NULL || channel<0 || group>=f->groups){
+        return -1;
+    }
+    for (j=0;j<f->sections;j++){
+        float *c=f->coefficients+(size_t)(group*f->sections+j)*5*SOS_LANES+lane;
+        c[0]=sections[j].b0;
+        c[SOS_LANES]=sections[j].b1;
+        c[2*SOS_LANES]=sections[j].b2;
+        c[3*SOS_LANES]=sections[j].a1;
+        c[4*SOS_LANES]=sections[j].a2;
+    }
+    return 0;
+}
+
+//Frames whose channels fill whole groups are filtered in place in out, others go through the padded work buffer
+int sos_filter_process(SOS_Filter *f, const float in[], float out[], int frames){
+
+    int lanes=f->groups*SOS_LANES;
+    int done=0;
+    if (frames<0){
+        return -1;
+    }
+    while (done<frames){
+        int n= frames-done<SOS_CHUNK ? frames-done : SOS_CHUNK;
+        const float *src=in+(size_t)done*f->channels;
+        float *dst=out+(size_t)done*f->channels;
+        int i;
+        if (f->work==NULL){
+            if (dst!=src){
+                memcpy(dst,src,(size_t)n*lanes*sizeof(float));
+            }
+            vector_sos_lanes(f->coefficients,f->state,f->sections,f->groups,dst,n);
+        }
+        else {
+            for (i=0;i<n;i++){
+                memcpy(f->work+(size_t)i*lanes,src+(size_t)i*f->channels,(size_t)f->channels*sizeof(float));
+            }
+            vector_sos_lanes(f->coefficients,f->state,f->sections,f->groups,f->work,n);
+            for (i=0;i<n;i++){
+                memcpy(dst+(size_t)i*f->channels,f->work+(size_t)i*lanes,(size_t)f->channels*sizeof(float));
+            }
+        }
+        flush_denormals(f->state,f->groups*f->sections*2*SOS_LANES);
+        done+=n;
+    }
+    return 0;
+}
+
+void sos_filter_reset(SOS_Filter *f){
+
+    memset(f->state,0,(size_t)f->groups*f->sections*2*SOS_LANES*sizeof(float));
+}
+
+void sos_filter_destroy(SOS_Filter *f){
+
+    fftwf_free(f->coefficients);
+    fftwf_free(f->state);
+    fftwf_free(f->work);
+    memset(f,0,sizeof(SOS_Filter));
+}
+
+//A decaying tail left in the state would otherwise run on denormals where the CPU does not flush them
+static void flush_denormals(float state[], int N){
+
+    int i;
+    for (i=0;i<N;i++){
+        if (fabsf(state[i])<SOS_DENORMAL){
+            state[i]=0;
+        }
+    }
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,132 @@
+//********************************************************************
+//*                    STFT                                          *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Streaming short time Fourier transform with overlap *
+//*             that keeps one FFTW plan for its whole life          *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/STFT.h>
+#include <../include/FFT_Plan.h>
+#include <../include/Vector_Ops.h>
+#include <fftw3.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int stft_init(STFT *st, int frame_size, int hop, Window_Type window, float parameter);
+
+int stft_push(STFT *st, const float samples[], int N, STFT_Callback callback, void *user);
+
+int stft_set_window(STFT *st, Window_Type window, float parameter);
+
+void stft_reset(STFT *st);
+
+void stft_destroy(STFT *st);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Allocates the frame buffers and fetches the transform plan once
+int stft_init(STFT *st, int frame_size, int hop, Window_Type window, float parameter){
+
+    memset(st,0,sizeof(STFT));
+    if (frame_size<2 || hop<1 || hop>frame_size){
+        return -1;
+    }
+    st->frame_size=frame_size;
+    st->hop=hop;
+    st->bins=frame_size/2+1;
+
+    //the cached windows hold frame_size+1 points, using the first frame_size gives the periodic form wanted for overlapping frames
+    st->window=window_cache_get(window,frame_size,parameter);
+    st->history=(float *) fftwf_malloc(frame_size*sizeof(float));
+    st->frame=(float *) fftwf_malloc(frame_size*sizeof(float));
+    st->spectrum=(fftwf_complex *) fftwf_malloc(st->bins*sizeof(fftwf_complex));
+    if (st->window==NULL || st->history==NULL || st->frame==NULL || st->spectrum==NULL){
+        stft_destroy(st);
+        return -1;
+    }
+
+    st->plan=fft_plan_get(frame_size,FFT_R2C,st->frame,st->spectrum);
+    if (st->plan==NULL){
+        stft_destroy(st);
+        return -1;
+    }
+    return 0;
+}
+
+//Buffers incoming samples and transforms a frame every hop samples
+int stft_push(STFT *st, const float samples[], int N, STFT_Callback callback, void *user){
+
+    int produced=0;
+    while (N>0){
+        int take=st->frame_size-st->filled;
+        if (take>N){
+            take=N;
+        }
+        memcpy(st->history+st->filled,samples,take*sizeof(float));
+        st->filled+=take;
+        samples+=take;
+        N-=take;
+
+        if (st->filled==st->frame_size){
+            vector_multiply(st->window,st->history,st->frame,st->frame_size);
+            fftwf_execute_dft_r2c(st->plan,st->frame,st->spectrum);
+            st->frames++;
+            produced++;
+            if (callback!=NULL){
+                callback(st->spectrum,st->bins,user);
+            }
+            //keep the overlapping tail for the next frame
+            memmove(st->history,st->history+st->hop,(st->frame_size-st->hop)*sizeof(float));
+            st->filled=st->frame_size-st->hop;
+        }
+    }
+    return produced;
+}
+
+//Takes another table from the window cache, the frame size and plan are unchanged
+int stft_set_window(STFT *st, Window_Type window, float parameter){
+
+    const float *table=window_cache_get(window,st->frame_size,parameter);
+    if (table==NULL){
+        return -1;
+    }
+    st->window=table;
+    return 0;
+}
+
+//Forgets buffered input without touching the plan
+void stft_reset(STFT *st){
+    st->filled=0;
+    st->frames=0;
+}
+
+//Frees everything created by stft_init, the plan stays in the plan cache
+void stft_destroy(STFT *st){
+    fftwf_free(st->history);
+    fftwf_free(st->frame);
+    fftwf_free(st->spectrum);
+    memset(st,0,sizeof(STFT));
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
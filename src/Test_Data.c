@@ -1,99 +1,127 @@
-//********************************************************************
-//*                    Test Data                                     *
-//*==================================================================*
-//* WRITTEN BY: Liam McEvoy    	                 		             *
-//* DATE CREATED:   15/12/20                                         *
-//* MODIFIED:                                                        *
-//*==================================================================*
-//* PROGRAMMED IN: Visual Studio                                     *
-//*==================================================================*
-//* DESCRIPTION: Creates sampled data for use in testing Software    *
-//*              Defined Radio program                               *
-//********************************************************************
-// INCLUDE FILES
-//====================================================================
-#include <stdio.h>
-#include <math.h>
-#include <../include/tinywav.h>
-#define _USE_MATH_DEFINES
-#include <../include/Test_Data.h>
-//====================================================================
-// SYMBOLIC CONSTANTS
-//====================================================================
-
-//====================================================================
-// GLOBAL VARIABLES
-//====================================================================
-
-//====================================================================
-// FUNCTION DECLARATIONS
-//====================================================================
-void Create_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]); //creates a sampled sinewave of length N
-
-void DSB_SC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]);//short carrier modulator samples of length N
-
-void DSB_LC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit, int A,double t_start,float  dataout[]);//Large carrier modulatorsamples of length N
-
-//====================================================================
-// FUNCTION DEFINITIONS
-//====================================================================
-
-//Creates a simple sinewave where you can designate the frequency,sample rate, number of samples, bit level and what time it should start at.
-void Create_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]){
-    
-    int i;
-    double w,t;
-    w=2*M_PI*frequency;
-    t=1/sample_rate;
-    for (i=0;i<Number_of_samples;i++){
-        double data;
-        t_start = t_start + t;
-        data=sin(w*t_start)+1;
-        data=round(((pow(2,bit)-1)*data)/2);
-        data=(2*data)/(pow(2,bit)-1)-1;
-        dataout[i]=(float)data;
-        
-        
-    }
-}
-
-// Simple Double Sideband Short Carrier Modulation implementation
-void DSB_SC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]){
-
-    int i;
-    double w,t;
-    w=2*M_PI*frequency;
-    t=1/sample_rate;
-    for (i=0;i<Number_of_samples;i++){
-        double data;
-        t_start = t_start + t;
-        data=cos(w*t_start)+1;
-        data=round(((pow(2,bit)-1)*data)/2);
-        data=(2*data)/(pow(2,bit)-1)-1;
-        dataout[i]=(float)(data*dataout[i]);
-        
-        
-    }
-}
-
-// Simple Double Sideband Large Carrier Modulation implementation
-void DSB_LC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit, int A,double t_start,float dataout[]){
-     
-    int i;
-    double w,t;
-    w=2*M_PI*frequency;
-    t=1/sample_rate;
-    for (i=0;i<Number_of_samples;i++){
-        double data;
-        t_start = t_start + t;
-        data=cos(w*t_start)+1;
-        data=round(((pow(2,bit)-1)*data)/2);
-        data=(2*data)/(pow(2,bit)-1)-1;
-        dataout[i]=(float)(data*(dataout[i]+A));
-        
-        
-    }
-}
-//********************************************************************
-// END OF PROGRAM
-//********************************************************************
+//********************************************************************
+//*                    Test Data                                     *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   15/12/20                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Creates sampled data for use in testing Software    *
+//*              Defined Radio program                               *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+#include <stdio.h>
+#include <math.h>
+#include <../include/tinywav.h>
+#define _USE_MATH_DEFINES
+#include <../include/Test_Data.h>
+#include <../include/NCO.h>
+#include <../include/Vector_Ops.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define DSB_CHUNK 1024 //message samples offset per pass by DSB_Modulate_c
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+void Create_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]); //creates a sampled sinewave of length N
+
+void Create_Complex_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,fftwf_complex dataout[]); //creates a sampled complex exponential of length N
+
+void DSB_SC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]);//short carrier modulator samples of length N
+
+void DSB_LC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit, int A,double t_start,float  dataout[]);//Large carrier modulatorsamples of length N
+
+int DSB_Modulator_Init(DSB_Modulator *mod, double sample_rate, double frequency, int bit, float A, double t_start);//stateful modulator for consecutive blocks
+
+void DSB_Modulate(DSB_Modulator *mod, const float datain[], float dataout[], int Number_of_samples);
+
+void DSB_Modulate_c(DSB_Modulator *mod, const float datain[], fftwf_complex dataout[], int Number_of_samples);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Creates a simple sinewave where you can designate the frequency,sample rate, number of samples, bit level and what time it should start at.
+void Create_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]){
+    
+    NCO nco;
+    if (nco_init(&nco,NCO_POLY,sample_rate,frequency,bit)!=0){
+        return;
+    }
+    //the first sample is one period after t_start, only the fraction of a cycle matters so long starts keep their precision
+    nco_set_phase(&nco,fmod(frequency*t_start,1.0)+frequency/sample_rate);
+    nco_sin(&nco,dataout,Number_of_samples);
+}
+
+//Complex sinewave for baseband testing, starts at the same phase as Create_Sine_Wave whose output is its imaginary part
+void Create_Complex_Sine_Wave(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,fftwf_complex dataout[]){
+    
+    NCO nco;
+    if (nco_init(&nco,NCO_POLY,sample_rate,frequency,bit)!=0){
+        return;
+    }
+    nco_set_phase(&nco,fmod(frequency*t_start,1.0)+frequency/sample_rate);
+    nco_complex(&nco,dataout,Number_of_samples);
+}
+
+// Simple Double Sideband Short Carrier Modulation implementation
+void DSB_SC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit,double t_start,float dataout[]){
+
+    DSB_Modulator mod;
+    if (DSB_Modulator_Init(&mod,sample_rate,frequency,bit,0,t_start)==0){
+        DSB_Modulate(&mod,dataout,dataout,Number_of_samples);
+    }
+}
+
+// Simple Double Sideband Large Carrier Modulation implementation
+void DSB_LC_MOD(double sample_rate, double frequency, int Number_of_samples,int bit, int A,double t_start,float dataout[]){
+
+    DSB_Modulator mod;
+    if (DSB_Modulator_Init(&mod,sample_rate,frequency,bit,(float)A,t_start)==0){
+        DSB_Modulate(&mod,dataout,dataout,Number_of_samples);
+    }
+}
+
+//Sets the carrier phase from t_start once, after that every block carries on from the last
+int DSB_Modulator_Init(DSB_Modulator *mod, double sample_rate, double frequency, int bit, float A, double t_start){
+
+    if (nco_init(&mod->carrier,NCO_POLY,sample_rate,frequency,bit)!=0){
+        return -1;
+    }
+    nco_set_phase(&mod->carrier,fmod(frequency*t_start,1.0)+frequency/sample_rate);
+    mod->A=A;
+    return 0;
+}
+
+//carrier*(message+A), generated, quantised and multiplied in one pass
+void DSB_Modulate(DSB_Modulator *mod, const float datain[], float dataout[], int Number_of_samples){
+
+    nco_modulate(&mod->carrier,datain,mod->A,dataout,Number_of_samples);
+}
+//(message+A) times the complex carrier, shares its phase with DSB_Modulate so the two can be mixed block by block
+void DSB_Modulate_c(DSB_Modulator *mod, const float datain[], fftwf_complex dataout[], int Number_of_samples){
+
+    float signal[DSB_CHUNK];
+    int done=0;
+    int i;
+    while (done<Number_of_samples){
+        int n= Number_of_samples-done<DSB_CHUNK ? Number_of_samples-done : DSB_CHUNK;
+        for (i=0;i<n;i++){
+            signal[i]=datain[done+i]+mod->A;
+        }
+        nco_complex(&mod->carrier,dataout+done,n);
+        vector_multiply_real_complex(signal,(const float (*)[2]) (dataout+done),dataout+done,n);
+        done+=n;
+    }
+}
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,2031 @@
+//********************************************************************
+//*                    Vector Ops                                    *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: SSE2/AVX2/NEON array kernels used on the hot path   *
+//*             with the instruction set chosen at runtime           *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Vector_Ops.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTOR_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VECTOR_ARM 1
+#endif
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define S16_SCALE (1.0f/32768.0f)
+#define S24_SCALE (1.0f/8388608.0f)
+#define S32_SCALE (1.0f/2147483648.0f)
+#define S32_MAX_FLOAT 2147483520.0f //largest float below 2^31, converts without overflowing
+//Signed PCM of every width encodes x*2^(n-1) clipped to 2^(n-1)-1 and decodes by 2^-(n-1)
+#define S16_FULL  32768.0f
+#define S24_FULL  8388608.0f
+#define S32_FULL  2147483648.0f
+#define U8_SCALE  (1.0f/127.5f)
+#define U8_OFFSET (-1.0f)  //offset binary 0..255 centred on 127.5, as RTL-SDR dongles produce
+#define S8_SCALE  (1.0f/128.0f)
+#define PHASE_SCALE (1.0f/4294967296.0f)  //32 bit phase to cycles
+#define TWO_PI 6.28318530717958647692f
+//Taylor coefficients of sin(y) for |y|<=pi/2, the next term is below 6e-8
+#define SIN_C3  (-1.0f/6.0f)
+#define SIN_C5  (1.0f/120.0f)
+#define SIN_C7  (-1.0f/5040.0f)
+#define SIN_C9  (1.0f/362880.0f)
+#define SIN_C11 (-1.0f/39916800.0f)
+#define CIC_MAX_ORDER 8
+#define HALF_PI 1.57079632679489661923f
+#define PI_F    3.14159265358979323846f
+//atan(a) for 0<=a<=1 as a*(A1+A3 a^2+...), Abramowitz and Stegun 4.4.49, error below 1e-5 rad
+#define ATAN_A1 0.9998660f
+#define ATAN_A3 (-0.3302995f)
+#define ATAN_A5 0.1801410f
+#define ATAN_A7 (-0.0851330f)
+#define ATAN_A9 0.0208351f
+#define ATAN_TINY 1e-30f  //keeps 0/0 at the origin finite
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+typedef void (*Binary_Kernel)(const float *a, const float *b, float *out, int N);
+
+typedef void (*Unary_Kernel)(const float *in, float *out, int N);
+
+typedef struct Vector_Kernels {
+    Vector_Isa isa;
+    Binary_Kernel multiply;
+    Binary_Kernel divide;
+    Unary_Kernel reciprocal;
+    void (*s16_to_float)(const int16_t *in, float *out, int N);
+    void (*u8_to_float)(const uint8_t *in, float *out, int N);
+    void (*s8_to_float)(const int8_t *in, float *out, int N);
+    void (*s24_to_float)(const uint8_t *in, float *out, int N);
+    void (*s32_to_float)(const int32_t *in, float *out, int N);
+    void (*float_to_s16)(const float *in, int16_t *out, int N);
+    void (*float_to_s24)(const float *in, uint8_t *out, int N);
+    void (*float_to_s32)(const float *in, int32_t *out, int N);
+    void (*deinterleave2)(const float *in, float *left, float *right, int frames);
+    void (*interleave2)(const float *left, const float *right, float *out, int frames);
+    void (*sine_phase)(uint32_t phase, uint32_t step, float *out, int N);
+    void (*quantize)(float *data, int N, float levels);
+    void (*sine_mix)(uint32_t phase, uint32_t step, float levels, const float *in, float offset, float *out, int N);
+    Binary_Kernel real_complex_multiply;
+    Binary_Kernel real_complex_divide;
+    Binary_Kernel complex_multiply;
+    Binary_Kernel complex_multiply_add;
+    float (*dot)(const float *a, const float *b, int N);
+    void (*dot_real_complex)(const float *taps, const float *x, int N, float out[2]);
+    int (*cic_decimate)(uint64_t *state, int order, int decimation, int *phase, float in_scale, double out_scale,
+                        const float *in, float *out, int N);
+    void (*sos_lanes)(const float *coefficients, float *state, int sections, int groups, float *data, int frames);
+    Unary_Kernel complex_magnitude;
+    void (*fm_discriminate)(const float *in, float *previous, float *out, int N, float gain);
+} Vector_Kernels;
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+static const Vector_Kernels *vector_kernels(void);
+
+static void multiply_scalar(const float *a, const float *b, float *out, int N);
+
+static void divide_scalar(const float *a, const float *b, float *out, int N);
+
+static void reciprocal_scalar(const float *in, float *out, int N);
+
+static void s16_to_float_scalar(const int16_t *in, float *out, int N);
+
+static void u8_to_float_scalar(const uint8_t *in, float *out, int N);
+
+static void s8_to_float_scalar(const int8_t *in, float *out, int N);
+
+static void s24_to_float_scalar(const uint8_t *in, float *out, int N);
+
+static void s32_to_float_scalar(const int32_t *in, float *out, int N);
+
+static void float_to_s16_scalar(const float *in, int16_t *out, int N);
+
+static void float_to_s24_scalar(const float *in, uint8_t *out, int N);
+
+static void float_to_s32_scalar(const float *in, int32_t *out, int N);
+
+static void deinterleave2_scalar(const float *in, float *left, float *right, int frames);
+
+static void interleave2_scalar(const float *left, const float *right, float *out, int frames);
+
+static void real_complex_multiply_scalar(const float *a, const float *in, float *out, int N);
+
+static void real_complex_divide_scalar(const float *a, const float *in, float *out, int N);
+
+static void complex_multiply_scalar(const float *a, const float *b, float *out, int N);
+
+static void complex_multiply_add_scalar(const float *a, const float *b, float *acc, int N);
+
+static void complex_magnitude_scalar(const float *in, float *out, int N);
+
+static float dot_scalar(const float *a, const float *b, int N);
+
+static void dot_real_complex_scalar(const float *taps, const float *x, int N, float out[2]);
+
+static int cic_decimate_scalar(uint64_t *state, int order, int decimation, int *phase, float in_scale, double out_scale,
+                               const float *in, float *out, int N);
+
+static void sos_lanes_scalar(const float *coefficients, float *state, int sections, int groups, float *data, int frames);
+
+static void sine_phase_scalar(uint32_t phase, uint32_t step, float *out, int N);
+
+static void quantize_scalar(float *data, int N, float levels);
+
+static void sine_mix_scalar(uint32_t phase, uint32_t step, float levels, const float *in, float offset, float *out, int N);
+
+static void fm_discriminate_scalar(const float *in, float *previous, float *out, int N, float gain);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Plain C kernels, also used for the tail of every vector loop
+static void multiply_scalar(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=a[i]*b[i];
+    }
+}
+
+static void divide_scalar(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=a[i]/b[i];
+    }
+}
+
+static void reciprocal_scalar(const float *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]= in[i]!=0 ? 1/in[i] : 0;
+    }
+}
+
+static void u8_to_float_scalar(const uint8_t *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=in[i]*U8_SCALE+U8_OFFSET;
+    }
+}
+
+static void s8_to_float_scalar(const int8_t *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=in[i]*S8_SCALE;
+    }
+}
+
+static void s16_to_float_scalar(const int16_t *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=in[i]*S16_SCALE;
+    }
+}
+
+//Assembles each sample in the top three bytes so the arithmetic shift sign extends it
+static void s24_to_float_scalar(const uint8_t *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        int32_t x=(int32_t)((uint32_t)in[3*i]<<8 | (uint32_t)in[3*i+1]<<16 | (uint32_t)in[3*i+2]<<24)>>8;
+        out[i]=x*S24_SCALE;
+    }
+}
+
+static void s32_to_float_scalar(const int32_t *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=(float)in[i]*S32_SCALE;
+    }
+}
+
+//PCM encoders clip to full scale and round to nearest like the vector versions
+static void float_to_s16_scalar(const float *in, int16_t *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        float x=in[i]*S16_FULL;
+        x= x>32767.0f ? 32767.0f : (x<-32768.0f ? -32768.0f : x);
+        out[i]=(int16_t) lrintf(x);
+    }
+}
+
+static void float_to_s24_scalar(const float *in, uint8_t *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        float x=in[i]*S24_FULL;
+        int32_t v;
+        x= x>8388607.0f ? 8388607.0f : (x<-8388608.0f ? -8388608.0f : x);
+        v=(int32_t) lrintf(x);
+        out[3*i]=(uint8_t) v;
+        out[3*i+1]=(uint8_t)(v>>8);
+        out[3*i+2]=(uint8_t)(v>>16);
+    }
+}
+
+static void float_to_s32_scalar(const float *in, int32_t *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        float x=in[i]*S32_FULL;
+        x= x>S32_MAX_FLOAT ? S32_MAX_FLOAT : (x<-2147483648.0f ? -2147483648.0f : x);
+        out[i]=(int32_t) lrintf(x);
+    }
+}
+
+static void deinterleave2_scalar(const float *in, float *left, float *right, int frames){
+    int i;
+    for (i=0;i<frames;i++){
+        left[i]=in[2*i];
+        right[i]=in[2*i+1];
+    }
+}
+
+static void interleave2_scalar(const float *left, const float *right, float *out, int frames){
+    int i;
+    for (i=0;i<frames;i++){
+        out[2*i]=left[i];
+        out[2*i+1]=right[i];
+    }
+}
+
+//Complex samples are interleaved re,im pairs like fftwf_complex
+static void real_complex_multiply_scalar(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[2*i]=a[i]*in[2*i];
+        out[2*i+1]=a[i]*in[2*i+1];
+    }
+}
+
+static void real_complex_divide_scalar(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[2*i]=in[2*i]/a[i];
+        out[2*i+1]=in[2*i+1]/a[i];
+    }
+}
+
+static void complex_multiply_scalar(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        float re=a[2*i]*b[2*i]-a[2*i+1]*b[2*i+1];
+        float im=a[2*i]*b[2*i+1]+a[2*i+1]*b[2*i];
+        out[2*i]=re;
+        out[2*i+1]=im;
+    }
+}
+
+static void complex_multiply_add_scalar(const float *a, const float *b, float *acc, int N){
+    int i;
+    for (i=0;i<N;i++){
+        acc[2*i]+=a[2*i]*b[2*i]-a[2*i+1]*b[2*i+1];
+        acc[2*i+1]+=a[2*i]*b[2*i+1]+a[2*i+1]*b[2*i];
+    }
+}
+
+static void complex_magnitude_scalar(const float *in, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=sqrtf(in[2*i]*in[2*i]+in[2*i+1]*in[2*i+1]);
+    }
+}
+
+//Sum of products, one output of an FIR
+static float dot_scalar(const float *a, const float *b, int N){
+    int i;
+    float sum=0;
+    for (i=0;i<N;i++){
+        sum+=a[i]*b[i];
+    }
+    return sum;
+}
+
+//Real taps against complex samples, the re and im sums are kept apart
+static void dot_real_complex_scalar(const float *taps, const float *x, int N, float out[2]){
+    int i;
+    float re=0,im=0;
+    for (i=0;i<N;i++){
+        re+=taps[i]*x[2*i];
+        im+=taps[i]*x[2*i+1];
+    }
+    out[0]=re;
+    out[1]=im;
+}
+
+//CIC decimator on complex samples. state holds order integrator pairs then order comb delay pairs.
+//Integer arithmetic wraps modulo 2^64, which the combs undo exactly as long as the output fits.
+static int cic_decimate_scalar(uint64_t *state, int order, int decimation, int *phase, float in_scale, double out_scale,
+                               const float *in, float *out, int N){
+    uint64_t *integrator=state;
+    uint64_t *comb=state+2*order;
+    int i,j;
+    int count=0;
+    for (i=0;i<N;i++){
+        uint64_t re=(uint64_t)(int64_t) lrintf(in[2*i]*in_scale);
+        uint64_t im=(uint64_t)(int64_t) lrintf(in[2*i+1]*in_scale);
+        for (j=0;j<order;j++){
+            integrator[2*j]+=re;
+            integrator[2*j+1]+=im;
+            re=integrator[2*j];
+            im=integrator[2*j+1];
+        }
+        if (++*phase==decimation){
+            *phase=0;
+            for (j=0;j<order;j++){
+                uint64_t delay_re=comb[2*j],delay_im=comb[2*j+1];
+                comb[2*j]=re;
+                comb[2*j+1]=im;
+                re-=delay_re;
+                im-=delay_im;
+            }
+            out[2*count]=(float)((double)(int64_t)re*out_scale);
+            out[2*count+1]=(float)((double)(int64_t)im*out_scale);
+            count++;
+        }
+    }
+    return count;
+}
+
+//Cascaded biquads in transposed direct form II, one channel per lane. data holds frames of
+//groups*SOS_LANES samples; for each group and section coefficients hold b0,b1,b2,a1,a2 and
+//state holds s1,s2, each SOS_LANES wide. A section runs over every frame before the next one
+//so its coefficients and state stay in registers.
+static void sos_lanes_scalar(const float *coefficients, float *state, int sections, int groups, float *data, int frames){
+    int g,j,lane,n;
+    int stride=groups*SOS_LANES;
+    for (g=0;g<groups;g++){
+        for (j=0;j<sections;j++){
+            const float *c=coefficients+(size_t)(g*sections+j)*5*SOS_LANES;
+            float *st=state+(size_t)(g*sections+j)*2*SOS_LANES;
+            for (lane=0;lane<SOS_LANES;lane++){
+                float b0=c[lane],b1=c[SOS_LANES+lane],b2=c[2*SOS_LANES+lane];
+                float a1=c[3*SOS_LANES+lane],a2=c[4*SOS_LANES+lane];
+                float s1=st[lane],s2=st[SOS_LANES+lane];
+                float *x=data+g*SOS_LANES+lane;
+                for (n=0;n<frames;n++){
+                    float in=x[(size_t)n*stride];
+                    float y=b0*in+s1;
+                    s1=b1*in-a1*y+s2;
+                    s2=b2*in-a2*y;
+                    x[(size_t)n*stride]=y;
+                }
+                st[lane]=s1;
+                st[SOS_LANES+lane]=s2;
+            }
+        }
+    }
+}
+
+//atan2 folded to the first octant, the polynomial there, then unfolded. The vector versions do the same steps.
+static inline float atan2_poly_scalar(float y, float x){
+    float ax=fabsf(x),ay=fabsf(y);
+    float a=fminf(ax,ay)/fmaxf(fmaxf(ax,ay),ATAN_TINY);
+    float s=a*a;
+    float r=a*(ATAN_A1+s*(ATAN_A3+s*(ATAN_A5+s*(ATAN_A7+s*ATAN_A9))));
+    if (ay>ax){
+        r=HALF_PI-r;
+    }
+    if (signbit(x)){
+        r=PI_F-r;
+    }
+    return signbit(y) ? -r : r;
+}
+
+//Phase step between samples, the angle of x[i]*conj(x[i-1]), times gain. previous holds x[-1] and is left holding x[N-1].
+static void fm_discriminate_scalar(const float *in, float *previous, float *out, int N, float gain){
+    float pr=previous[0],pi=previous[1];
+    int i;
+    for (i=0;i<N;i++){
+        float re=in[2*i]*pr+in[2*i+1]*pi;
+        float im=in[2*i+1]*pr-in[2*i]*pi;
+        out[i]=atan2_poly_scalar(im,re)*gain;
+        pr=in[2*i];
+        pi=in[2*i+1];
+    }
+    previous[0]=pr;
+    previous[1]=pi;
+}
+
+//Polynomial sine of a 32 bit phase, folded to a quarter cycle. The vector versions do exactly the same steps.
+static inline float sine_poly_scalar(uint32_t phase){
+    float x=(float)(int32_t)phase*PHASE_SCALE; //[-0.5,0.5) cycles
+    float a=fabsf(x);
+    float y,y2;
+    a= a<0.5f-a ? a : 0.5f-a;                    //sin(2pi(0.5-a))=sin(2pi a)
+    y=a*TWO_PI;
+    y2=y*y;
+    y=y+y*y2*(SIN_C3+y2*(SIN_C5+y2*(SIN_C7+y2*(SIN_C9+y2*SIN_C11))));
+    return x<0 ? -y : y;
+}
+
+static void sine_phase_scalar(uint32_t phase, uint32_t step, float *out, int N){
+    int i;
+    for (i=0;i<N;i++){
+        out[i]=sine_poly_scalar(phase);
+        phase+=step;
+    }
+}
+
+//Carrier times (in+offset) in one pass, the carrier quantised first when levels is set. in may be out.
+static void sine_mix_scalar(uint32_t phase, uint32_t step, float levels, const float *in, float offset, float *out, int N){
+    int i;
+    float inverse= levels>0 ? 1/levels : 0;
+    for (i=0;i<N;i++){
+        float carrier=sine_poly_scalar(phase);
+        if (levels>0){
+            carrier=nearbyintf((carrier+1)*levels)*inverse-1;
+        }
+        out[i]=carrier*(in[i]+offset);
+        phase+=step;
+    }
+}
+
+//Rounds [-1,1] data to the nearest of 2*levels+1 evenly spaced values
+static void quantize_scalar(float *data, int N, float levels){
+    int i;
+    float inverse=1/levels;
+    for (i=0;i<N;i++){
+        data[i]=nearbyintf((data[i]+1)*levels)*inverse-1;
+    }
+}
+
+#if VECTOR_X86
+//SSE2 kernels, four samples per instruction
+__attribute__((target("sse2")))
+static void multiply_sse2(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        __m128 x0=_mm_mul_ps(_mm_loadu_ps(a+i),_mm_loadu_ps(b+i));
+        __m128 x1=_mm_mul_ps(_mm_loadu_ps(a+i+4),_mm_loadu_ps(b+i+4));
+        _mm_storeu_ps(out+i,x0);
+        _mm_storeu_ps(out+i+4,x1);
+    }
+    multiply_scalar(a+i,b+i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void divide_sse2(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        _mm_storeu_ps(out+i,_mm_div_ps(_mm_loadu_ps(a+i),_mm_loadu_ps(b+i)));
+    }
+    divide_scalar(a+i,b+i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void reciprocal_sse2(const float *in, float *out, int N){
+    int i;
+    const __m128 one=_mm_set1_ps(1.0f);
+    const __m128 zero=_mm_setzero_ps();
+    for (i=0;i+4<=N;i+=4){
+        __m128 x=_mm_loadu_ps(in+i);
+        __m128 r=_mm_div_ps(one,x);
+        _mm_storeu_ps(out+i,_mm_andnot_ps(_mm_cmpeq_ps(x,zero),r));
+    }
+    reciprocal_scalar(in+i,out+i,N-i);
+}
+
+//Each real coefficient is duplicated across the re,im pair it scales
+__attribute__((target("sse2")))
+static void real_complex_multiply_sse2(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        __m128 w=_mm_loadu_ps(a+i);
+        __m128 lo=_mm_mul_ps(_mm_unpacklo_ps(w,w),_mm_loadu_ps(in+2*i));
+        __m128 hi=_mm_mul_ps(_mm_unpackhi_ps(w,w),_mm_loadu_ps(in+2*i+4));
+        _mm_storeu_ps(out+2*i,lo);
+        _mm_storeu_ps(out+2*i+4,hi);
+    }
+    real_complex_multiply_scalar(a+i,in+2*i,out+2*i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void real_complex_divide_sse2(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        __m128 w=_mm_loadu_ps(a+i);
+        _mm_storeu_ps(out+2*i,_mm_div_ps(_mm_loadu_ps(in+2*i),_mm_unpacklo_ps(w,w)));
+        _mm_storeu_ps(out+2*i+4,_mm_div_ps(_mm_loadu_ps(in+2*i+4),_mm_unpackhi_ps(w,w)));
+    }
+    real_complex_divide_scalar(a+i,in+2*i,out+2*i,N-i);
+}
+
+//(ar*br-ai*bi, ar*bi+ai*br) from a duplicated, b swapped and the sign of the real lane flipped, SSE2 has no addsub
+__attribute__((target("sse2")))
+static void complex_multiply_sse2(const float *a, const float *b, float *out, int N){
+    int i;
+    const __m128 negate_re=_mm_setr_ps(-0.0f,0.0f,-0.0f,0.0f);
+    for (i=0;i+2<=N;i+=2){
+        __m128 x=_mm_loadu_ps(a+2*i);
+        __m128 y=_mm_loadu_ps(b+2*i);
+        __m128 re=_mm_mul_ps(_mm_shuffle_ps(x,x,_MM_SHUFFLE(2,2,0,0)),y);
+        __m128 im=_mm_mul_ps(_mm_shuffle_ps(x,x,_MM_SHUFFLE(3,3,1,1)),_mm_shuffle_ps(y,y,_MM_SHUFFLE(2,3,0,1)));
+        _mm_storeu_ps(out+2*i,_mm_add_ps(re,_mm_xor_ps(im,negate_re)));
+    }
+    complex_multiply_scalar(a+2*i,b+2*i,out+2*i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void complex_multiply_add_sse2(const float *a, const float *b, float *acc, int N){
+    int i;
+    const __m128 negate_re=_mm_setr_ps(-0.0f,0.0f,-0.0f,0.0f);
+    for (i=0;i+2<=N;i+=2){
+        __m128 x=_mm_loadu_ps(a+2*i);
+        __m128 y=_mm_loadu_ps(b+2*i);
+        __m128 re=_mm_mul_ps(_mm_shuffle_ps(x,x,_MM_SHUFFLE(2,2,0,0)),y);
+        __m128 im=_mm_mul_ps(_mm_shuffle_ps(x,x,_MM_SHUFFLE(3,3,1,1)),_mm_shuffle_ps(y,y,_MM_SHUFFLE(2,3,0,1)));
+        _mm_storeu_ps(acc+2*i,_mm_add_ps(_mm_loadu_ps(acc+2*i),_mm_add_ps(re,_mm_xor_ps(im,negate_re))));
+    }
+    complex_multiply_add_scalar(a+2*i,b+2*i,acc+2*i,N-i);
+}
+
+//Squares summed pairwise after splitting the re and im lanes apart
+__attribute__((target("sse2")))
+static void complex_magnitude_sse2(const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        __m128 a=_mm_loadu_ps(in+2*i);
+        __m128 b=_mm_loadu_ps(in+2*i+4);
+        __m128 re=_mm_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0));
+        __m128 im=_mm_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1));
+        _mm_storeu_ps(out+i,_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re,re),_mm_mul_ps(im,im))));
+    }
+    complex_magnitude_scalar(in+2*i,out+i,N-i);
+}
+
+//Two accumulators hide the add latency
+__attribute__((target("sse2")))
+static float dot_sse2(const float *a, const float *b, int N){
+    int i;
+    __m128 acc0=_mm_setzero_ps();
+    __m128 acc1=_mm_setzero_ps();
+    __m128 sum;
+    for (i=0;i+8<=N;i+=8){
+        acc0=_mm_add_ps(acc0,_mm_mul_ps(_mm_loadu_ps(a+i),_mm_loadu_ps(b+i)));
+        acc1=_mm_add_ps(acc1,_mm_mul_ps(_mm_loadu_ps(a+i+4),_mm_loadu_ps(b+i+4)));
+    }
+    sum=_mm_add_ps(acc0,acc1);
+    sum=_mm_add_ps(sum,_mm_movehl_ps(sum,sum));
+    sum=_mm_add_ss(sum,_mm_shuffle_ps(sum,sum,_MM_SHUFFLE(1,1,1,1)));
+    return _mm_cvtss_f32(sum)+dot_scalar(a+i,b+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void dot_real_complex_sse2(const float *taps, const float *x, int N, float out[2]){
+    int i;
+    __m128 lo=_mm_setzero_ps();
+    __m128 hi=_mm_setzero_ps();
+    __m128 sum;
+    float tail[2];
+    for (i=0;i+4<=N;i+=4){
+        __m128 w=_mm_loadu_ps(taps+i);
+        lo=_mm_add_ps(lo,_mm_mul_ps(_mm_unpacklo_ps(w,w),_mm_loadu_ps(x+2*i)));
+        hi=_mm_add_ps(hi,_mm_mul_ps(_mm_unpackhi_ps(w,w),_mm_loadu_ps(x+2*i+4)));
+    }
+    sum=_mm_add_ps(lo,hi);
+    sum=_mm_add_ps(sum,_mm_movehl_ps(sum,sum)); //re,im of both pairs added
+    dot_real_complex_scalar(taps+i,x+2*i,N-i,tail);
+    out[0]=_mm_cvtss_f32(sum)+tail[0];
+    out[1]=_mm_cvtss_f32(_mm_shuffle_ps(sum,sum,_MM_SHUFFLE(1,1,1,1)))+tail[1];
+}
+
+//re and im run side by side in the two 64 bit lanes, only the comb output is converted back one lane at a time
+__attribute__((target("sse2")))
+static int cic_decimate_sse2(uint64_t *state, int order, int decimation, int *phase, float in_scale, double out_scale,
+                             const float *in, float *out, int N){
+    __m128i integrator[CIC_MAX_ORDER];
+    __m128i comb[CIC_MAX_ORDER];
+    const __m128 scale=_mm_set1_ps(in_scale);
+    int i,j;
+    int count=0;
+    for (j=0;j<order;j++){
+        integrator[j]=_mm_loadu_si128((const __m128i *)(state+2*j));
+        comb[j]=_mm_loadu_si128((const __m128i *)(state+2*order+2*j));
+    }
+    for (i=0;i<N;i++){
+        __m128i v=_mm_cvtps_epi32(_mm_mul_ps(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i *)(in+2*i))),scale));
+        v=_mm_unpacklo_epi32(v,_mm_srai_epi32(v,31)); //sign extend to 64 bits
+        for (j=0;j<order;j++){
+            integrator[j]=_mm_add_epi64(integrator[j],v);
+            v=integrator[j];
+        }
+        if (++*phase==decimation){
+            uint64_t pair[2];
+            *phase=0;
+            for (j=0;j<order;j++){
+                __m128i delay=comb[j];
+                comb[j]=v;
+                v=_mm_sub_epi64(v,delay);
+            }
+            _mm_storeu_si128((__m128i *) pair,v);
+            out[2*count]=(float)((double)(int64_t)pair[0]*out_scale);
+            out[2*count+1]=(float)((double)(int64_t)pair[1]*out_scale);
+            count++;
+        }
+    }
+    for (j=0;j<order;j++){
+        _mm_storeu_si128((__m128i *)(state+2*j),integrator[j]);
+        _mm_storeu_si128((__m128i *)(state+2*order+2*j),comb[j]);
+    }
+    return count;
+}
+
+//Four lanes per vector, so two passes per group. Flush to zero and denormals are zero
+//stop a decaying tail from slowing the recursion down.
+__attribute__((target("sse2")))
+static void sos_lanes_sse2(const float *coefficients, float *state, int sections, int groups, float *data, int frames){
+    unsigned int csr=_mm_getcsr();
+    int stride=groups*SOS_LANES;
+    int g,j,half,n;
+    _mm_setcsr(csr|0x8040);
+    for (g=0;g<groups;g++){
+        for (j=0;j<sections;j++){
+            const float *c=coefficients+(size_t)(g*sections+j)*5*SOS_LANES;
+            float *st=state+(size_t)(g*sections+j)*2*SOS_LANES;
+            for (half=0;half<SOS_LANES;half+=4){
+                __m128 b0=_mm_loadu_ps(c+half),b1=_mm_loadu_ps(c+SOS_LANES+half),b2=_mm_loadu_ps(c+2*SOS_LANES+half);
+                __m128 a1=_mm_loadu_ps(c+3*SOS_LANES+half),a2=_mm_loadu_ps(c+4*SOS_LANES+half);
+                __m128 s1=_mm_loadu_ps(st+half),s2=_mm_loadu_ps(st+SOS_LANES+half);
+                float *x=data+g*SOS_LANES+half;
+                for (n=0;n<frames;n++){
+                    __m128 in=_mm_loadu_ps(x+(size_t)n*stride);
+                    __m128 y=_mm_add_ps(_mm_mul_ps(b0,in),s1);
+                    s1=_mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1,in),_mm_mul_ps(a1,y)),s2);
+                    s2=_mm_sub_ps(_mm_mul_ps(b2,in),_mm_mul_ps(a2,y));
+                    _mm_storeu_ps(x+(size_t)n*stride,y);
+                }
+                _mm_storeu_ps(st+half,s1);
+                _mm_storeu_ps(st+SOS_LANES+half,s2);
+            }
+        }
+    }
+    _mm_setcsr(csr);
+}
+
+//AVX2 kernels, eight samples per instruction
+__attribute__((target("avx2")))
+static void multiply_avx2(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+16<=N;i+=16){
+        __m256 x0=_mm256_mul_ps(_mm256_loadu_ps(a+i),_mm256_loadu_ps(b+i));
+        __m256 x1=_mm256_mul_ps(_mm256_loadu_ps(a+i+8),_mm256_loadu_ps(b+i+8));
+        _mm256_storeu_ps(out+i,x0);
+        _mm256_storeu_ps(out+i+8,x1);
+    }
+    multiply_scalar(a+i,b+i,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void divide_avx2(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        _mm256_storeu_ps(out+i,_mm256_div_ps(_mm256_loadu_ps(a+i),_mm256_loadu_ps(b+i)));
+    }
+    divide_scalar(a+i,b+i,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void reciprocal_avx2(const float *in, float *out, int N){
+    int i;
+    const __m256 one=_mm256_set1_ps(1.0f);
+    const __m256 zero=_mm256_setzero_ps();
+    for (i=0;i+8<=N;i+=8){
+        __m256 x=_mm256_loadu_ps(in+i);
+        __m256 r=_mm256_div_ps(one,x);
+        _mm256_storeu_ps(out+i,_mm256_andnot_ps(_mm256_cmp_ps(x,zero,_CMP_EQ_OQ),r));
+    }
+    reciprocal_scalar(in+i,out+i,N-i);
+}
+__attribute__((target("avx2")))
+static void real_complex_multiply_avx2(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        __m256 w=_mm256_loadu_ps(a+i);
+        __m256 lo=_mm256_unpacklo_ps(w,w); //w0 w0 w1 w1 | w4 w4 w5 w5
+        __m256 hi=_mm256_unpackhi_ps(w,w); //w2 w2 w3 w3 | w6 w6 w7 w7
+        _mm256_storeu_ps(out+2*i,_mm256_mul_ps(_mm256_permute2f128_ps(lo,hi,0x20),_mm256_loadu_ps(in+2*i)));
+        _mm256_storeu_ps(out+2*i+8,_mm256_mul_ps(_mm256_permute2f128_ps(lo,hi,0x31),_mm256_loadu_ps(in+2*i+8)));
+    }
+    real_complex_multiply_scalar(a+i,in+2*i,out+2*i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void real_complex_divide_avx2(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        __m256 w=_mm256_loadu_ps(a+i);
+        __m256 lo=_mm256_unpacklo_ps(w,w);
+        __m256 hi=_mm256_unpackhi_ps(w,w);
+        _mm256_storeu_ps(out+2*i,_mm256_div_ps(_mm256_loadu_ps(in+2*i),_mm256_permute2f128_ps(lo,hi,0x20)));
+        _mm256_storeu_ps(out+2*i+8,_mm256_div_ps(_mm256_loadu_ps(in+2*i+8),_mm256_permute2f128_ps(lo,hi,0x31)));
+    }
+    real_complex_divide_scalar(a+i,in+2*i,out+2*i,N-i);
+}
+
+__attribute__((target("avx2,fma")))
+static void complex_multiply_avx2(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        __m256 x=_mm256_loadu_ps(a+2*i);
+        __m256 y=_mm256_loadu_ps(b+2*i);
+        __m256 im=_mm256_mul_ps(_mm256_movehdup_ps(x),_mm256_permute_ps(y,_MM_SHUFFLE(2,3,0,1)));
+        _mm256_storeu_ps(out+2*i,_mm256_fmaddsub_ps(_mm256_moveldup_ps(x),y,im)); //even lanes subtract, odd lanes add
+    }
+    complex_multiply_scalar(a+2*i,b+2*i,out+2*i,N-i);
+}
+
+__attribute__((target("avx2,fma")))
+static void complex_multiply_add_avx2(const float *a, const float *b, float *acc, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        __m256 x=_mm256_loadu_ps(a+2*i);
+        __m256 y=_mm256_loadu_ps(b+2*i);
+        __m256 im=_mm256_mul_ps(_mm256_movehdup_ps(x),_mm256_permute_ps(y,_MM_SHUFFLE(2,3,0,1)));
+        __m256 product=_mm256_fmaddsub_ps(_mm256_moveldup_ps(x),y,im);
+        _mm256_storeu_ps(acc+2*i,_mm256_add_ps(_mm256_loadu_ps(acc+2*i),product));
+    }
+    complex_multiply_add_scalar(a+2*i,b+2*i,acc+2*i,N-i);
+}
+
+//The in-lane shuffle leaves samples in 0,1,4,5,2,3,6,7 order, the permute puts them back
+__attribute__((target("avx2,fma")))
+static void complex_magnitude_avx2(const float *in, float *out, int N){
+    int i;
+    const __m256i order=_mm256_setr_epi32(0,1,4,5,2,3,6,7);
+    for (i=0;i+8<=N;i+=8){
+        __m256 a=_mm256_loadu_ps(in+2*i);
+        __m256 b=_mm256_loadu_ps(in+2*i+8);
+        __m256 re=_mm256_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0));
+        __m256 im=_mm256_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1));
+        __m256 power=_mm256_fmadd_ps(re,re,_mm256_mul_ps(im,im));
+        _mm256_storeu_ps(out+i,_mm256_permutevar8x32_ps(_mm256_sqrt_ps(power),order));
+    }
+    complex_magnitude_scalar(in+2*i,out+i,N-i);
+}
+
+__attribute__((target("avx2,fma")))
+static float dot_avx2(const float *a, const float *b, int N){
+    int i;
+    __m256 acc0=_mm256_setzero_ps();
+    __m256 acc1=_mm256_setzero_ps();
+    __m128 sum;
+    for (i=0;i+16<=N;i+=16){
+        acc0=_mm256_fmadd_ps(_mm256_loadu_ps(a+i),_mm256_loadu_ps(b+i),acc0);
+        acc1=_mm256_fmadd_ps(_mm256_loadu_ps(a+i+8),_mm256_loadu_ps(b+i+8),acc1);
+    }
+    acc0=_mm256_add_ps(acc0,acc1);
+    sum=_mm_add_ps(_mm256_castps256_ps128(acc0),_mm256_extractf128_ps(acc0,1));
+    sum=_mm_add_ps(sum,_mm_movehl_ps(sum,sum));
+    sum=_mm_add_ss(sum,_mm_shuffle_ps(sum,sum,_MM_SHUFFLE(1,1,1,1)));
+    return _mm_cvtss_f32(sum)+dot_scalar(a+i,b+i,N-i);
+}
+
+__attribute__((target("avx2,fma")))
+static void dot_real_complex_avx2(const float *taps, const float *x, int N, float out[2]){
+    int i;
+    __m256 acc0=_mm256_setzero_ps();
+    __m256 acc1=_mm256_setzero_ps();
+    __m128 sum;
+    float tail[2];
+    for (i=0;i+8<=N;i+=8){
+        __m256 w=_mm256_loadu_ps(taps+i);
+        __m256 lo=_mm256_unpacklo_ps(w,w);
+        __m256 hi=_mm256_unpackhi_ps(w,w);
+        acc0=_mm256_fmadd_ps(_mm256_permute2f128_ps(lo,hi,0x20),_mm256_loadu_ps(x+2*i),acc0);
+        acc1=_mm256_fmadd_ps(_mm256_permute2f128_ps(lo,hi,0x31),_mm256_loadu_ps(x+2*i+8),acc1);
+    }
+    acc0=_mm256_add_ps(acc0,acc1);
+    sum=_mm_add_ps(_mm256_castps256_ps128(acc0),_mm256_extractf128_ps(acc0,1));
+    sum=_mm_add_ps(sum,_mm_movehl_ps(sum,sum));
+    dot_real_complex_scalar(taps+i,x+2*i,N-i,tail);
+    out[0]=_mm_cvtss_f32(sum)+tail[0];
+    out[1]=_mm_cvtss_f32(_mm_shuffle_ps(sum,sum,_MM_SHUFFLE(1,1,1,1)))+tail[1];
+}
+
+//A whole group of lanes per vector
+__attribute__((target("avx2,fma")))
+static void sos_lanes_avx2(const float *coefficients, float *state, int sections, int groups, float *data, int frames){
+    unsigned int csr=_mm_getcsr();
+    int stride=groups*SOS_LANES;
+    int g,j,n;
+    _mm_setcsr(csr|0x8040);
+    for (g=0;g<groups;g++){
+        for (j=0;j<sections;j++){
+            const float *c=coefficients+(size_t)(g*sections+j)*5*SOS_LANES;
+            float *st=state+(size_t)(g*sections+j)*2*SOS_LANES;
+            __m256 b0=_mm256_loadu_ps(c),b1=_mm256_loadu_ps(c+SOS_LANES),b2=_mm256_loadu_ps(c+2*SOS_LANES);
+            __m256 a1=_mm256_loadu_ps(c+3*SOS_LANES),a2=_mm256_loadu_ps(c+4*SOS_LANES);
+            __m256 s1=_mm256_loadu_ps(st),s2=_mm256_loadu_ps(st+SOS_LANES);
+            float *x=data+g*SOS_LANES;
+            for (n=0;n<frames;n++){
+                __m256 in=_mm256_loadu_ps(x+(size_t)n*stride);
+                __m256 y=_mm256_fmadd_ps(b0,in,s1);
+                s1=_mm256_fmadd_ps(b1,in,_mm256_fnmadd_ps(a1,y,s2));
+                s2=_mm256_fnmadd_ps(a2,y,_mm256_mul_ps(b2,in));
+                _mm256_storeu_ps(x+(size_t)n*stride,y);
+            }
+            _mm256_storeu_ps(st,s1);
+            _mm256_storeu_ps(st+SOS_LANES,s2);
+        }
+    }
+    _mm_setcsr(csr);
+}
+
+//SSE2 PCM conversion and stereo (de)interleave
+//SSE2 8 bit IQ conversion, 16 bytes widened to four vectors of 32 bit integers
+__attribute__((target("sse2")))
+static void u8_to_float_sse2(const uint8_t *in, float *out, int N){
+    int i;
+    const __m128i zero=_mm_setzero_si128();
+    const __m128 scale=_mm_set1_ps(U8_SCALE);
+    const __m128 offset=_mm_set1_ps(U8_OFFSET);
+    for (i=0;i+16<=N;i+=16){
+        __m128i x=_mm_loadu_si128((const __m128i *)(in+i));
+        __m128i lo=_mm_unpacklo_epi8(x,zero);
+        __m128i hi=_mm_unpackhi_epi8(x,zero);
+        _mm_storeu_ps(out+i,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo,zero)),scale),offset));
+        _mm_storeu_ps(out+i+4,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo,zero)),scale),offset));
+        _mm_storeu_ps(out+i+8,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi,zero)),scale),offset));
+        _mm_storeu_ps(out+i+12,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi,zero)),scale),offset));
+    }
+    u8_to_float_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void s8_to_float_sse2(const int8_t *in, float *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S8_SCALE);
+    for (i=0;i+16<=N;i+=16){
+        __m128i x=_mm_loadu_si128((const __m128i *)(in+i));
+        __m128i lo=_mm_srai_epi16(_mm_unpacklo_epi8(x,x),8); //sign extend by shifting the duplicated byte down
+        __m128i hi=_mm_srai_epi16(_mm_unpackhi_epi8(x,x),8);
+        _mm_storeu_ps(out+i,_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo,lo),16)),scale));
+        _mm_storeu_ps(out+i+4,_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo,lo),16)),scale));
+        _mm_storeu_ps(out+i+8,_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi,hi),16)),scale));
+        _mm_storeu_ps(out+i+12,_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi,hi),16)),scale));
+    }
+    s8_to_float_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void s16_to_float_sse2(const int16_t *in, float *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S16_SCALE);
+    for (i=0;i+8<=N;i+=8){
+        __m128i x=_mm_loadu_si128((const __m128i *)(in+i));
+        __m128i lo=_mm_srai_epi32(_mm_unpacklo_epi16(x,x),16); //sign extend by shifting the duplicated half down
+        __m128i hi=_mm_srai_epi32(_mm_unpackhi_epi16(x,x),16);
+        _mm_storeu_ps(out+i,_mm_mul_ps(_mm_cvtepi32_ps(lo),scale));
+        _mm_storeu_ps(out+i+4,_mm_mul_ps(_mm_cvtepi32_ps(hi),scale));
+    }
+    s16_to_float_scalar(in+i,out+i,N-i);
+}
+
+//Shifts byte 3k of a 16 byte load into lane k and keeps that lane, without SSSE3's byte shuffle.
+//A load reads 13 bytes past the 4 samples' first, so the loop stops 6 samples from the end.
+__attribute__((target("sse2")))
+static void s24_to_float_sse2(const uint8_t *in, float *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S24_SCALE);
+    const __m128i lane0=_mm_setr_epi32(-1,0,0,0);
+    const __m128i lane1=_mm_setr_epi32(0,-1,0,0);
+    const __m128i lane2=_mm_setr_epi32(0,0,-1,0);
+    const __m128i lane3=_mm_setr_epi32(0,0,0,-1);
+    for (i=0;i+6<=N;i+=4){
+        __m128i v=_mm_loadu_si128((const __m128i *)(in+3*i));
+        __m128i x=_mm_or_si128(_mm_and_si128(v,lane0),_mm_and_si128(_mm_slli_si128(v,1),lane1));
+        x=_mm_or_si128(x,_mm_or_si128(_mm_and_si128(_mm_slli_si128(v,2),lane2),_mm_and_si128(_mm_slli_si128(v,3),lane3)));
+        x=_mm_srai_epi32(_mm_slli_epi32(x,8),8);
+        _mm_storeu_ps(out+i,_mm_mul_ps(_mm_cvtepi32_ps(x),scale));
+    }
+    s24_to_float_scalar(in+3*i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void s32_to_float_sse2(const int32_t *in, float *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S32_SCALE);
+    for (i=0;i+4<=N;i+=4){
+        __m128i x=_mm_loadu_si128((const __m128i *)(in+i));
+        _mm_storeu_ps(out+i,_mm_mul_ps(_mm_cvtepi32_ps(x),scale));
+    }
+    s32_to_float_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void float_to_s16_sse2(const float *in, int16_t *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S16_FULL);
+    for (i=0;i+8<=N;i+=8){
+        __m128i lo=_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in+i),scale));
+        __m128i hi=_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in+i+4),scale));
+        _mm_storeu_si128((__m128i *)(out+i),_mm_packs_epi32(lo,hi)); //packs saturates to int16
+    }
+    float_to_s16_scalar(in+i,out+i,N-i);
+}
+
+//Packs pairs of samples into 6 bytes per 64 bit half and stores each half as 8 bytes, the
+//2 byte overlap is rewritten by the next store so the loop stops 5 samples from the end
+__attribute__((target("sse2")))
+static void float_to_s24_sse2(const float *in, uint8_t *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S24_FULL);
+    const __m128 top=_mm_set1_ps(8388607.0f);
+    const __m128 bottom=_mm_set1_ps(-8388608.0f);
+    const __m128i even=_mm_setr_epi32(0xFFFFFF,0,0xFFFFFF,0);
+    const __m128i odd=_mm_setr_epi32(0,0xFFFFFF,0,0xFFFFFF);
+    for (i=0;i+5<=N;i+=4){
+        __m128 x=_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(in+i),scale),top),bottom);
+        __m128i v=_mm_cvtps_epi32(x);
+        __m128i packed=_mm_or_si128(_mm_and_si128(v,even),_mm_srli_epi64(_mm_and_si128(v,odd),8));
+        _mm_storel_epi64((__m128i *)(out+3*i),packed);
+        _mm_storel_epi64((__m128i *)(out+3*i+6),_mm_unpackhi_epi64(packed,packed));
+    }
+    float_to_s24_scalar(in+i,out+3*i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void float_to_s32_sse2(const float *in, int32_t *out, int N){
+    int i;
+    const __m128 scale=_mm_set1_ps(S32_FULL);
+    const __m128 top=_mm_set1_ps(S32_MAX_FLOAT);
+    const __m128 bottom=_mm_set1_ps(-2147483648.0f);
+    for (i=0;i+4<=N;i+=4){
+        __m128 x=_mm_mul_ps(_mm_loadu_ps(in+i),scale);
+        x=_mm_max_ps(_mm_min_ps(x,top),bottom);
+        _mm_storeu_si128((__m128i *)(out+i),_mm_cvtps_epi32(x));
+    }
+    float_to_s32_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void deinterleave2_sse2(const float *in, float *left, float *right, int frames){
+    int i;
+    for (i=0;i+4<=frames;i+=4){
+        __m128 a=_mm_loadu_ps(in+2*i);
+        __m128 b=_mm_loadu_ps(in+2*i+4);
+        _mm_storeu_ps(left+i,_mm_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0)));
+        _mm_storeu_ps(right+i,_mm_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1)));
+    }
+    deinterleave2_scalar(in+2*i,left+i,right+i,frames-i);
+}
+
+__attribute__((target("sse2")))
+static void interleave2_sse2(const float *left, const float *right, float *out, int frames){
+    int i;
+    for (i=0;i+4<=frames;i+=4){
+        __m128 l=_mm_loadu_ps(left+i);
+        __m128 r=_mm_loadu_ps(right+i);
+        _mm_storeu_ps(out+2*i,_mm_unpacklo_ps(l,r));
+        _mm_storeu_ps(out+2*i+4,_mm_unpackhi_ps(l,r));
+    }
+    interleave2_scalar(left+i,right+i,out+2*i,frames-i);
+}
+
+//SSE2 polynomial atan2 and FM discriminator, four samples per vector
+__attribute__((target("sse2")))
+static inline __m128 atan2_poly_sse2(__m128 y, __m128 x){
+    const __m128 sign=_mm_set1_ps(-0.0f);
+    __m128 ax=_mm_andnot_ps(sign,x),ay=_mm_andnot_ps(sign,y);
+    __m128 a=_mm_div_ps(_mm_min_ps(ax,ay),_mm_max_ps(_mm_max_ps(ax,ay),_mm_set1_ps(ATAN_TINY)));
+    __m128 s=_mm_mul_ps(a,a);
+    __m128 r=_mm_add_ps(_mm_set1_ps(ATAN_A7),_mm_mul_ps(s,_mm_set1_ps(ATAN_A9)));
+    __m128 steep=_mm_cmpgt_ps(ay,ax);
+    __m128 behind=_mm_and_ps(x,sign);
+    r=_mm_add_ps(_mm_set1_ps(ATAN_A5),_mm_mul_ps(s,r));
+    r=_mm_add_ps(_mm_set1_ps(ATAN_A3),_mm_mul_ps(s,r));
+    r=_mm_mul_ps(a,_mm_add_ps(_mm_set1_ps(ATAN_A1),_mm_mul_ps(s,r)));
+    r=_mm_or_ps(_mm_and_ps(steep,_mm_sub_ps(_mm_set1_ps(HALF_PI),r)),_mm_andnot_ps(steep,r));
+    //pi-r where x<0: r with its sign flipped plus pi, both picked by the sign bit of x
+    r=_mm_add_ps(_mm_xor_ps(r,behind),_mm_and_ps(_mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x),31)),_mm_set1_ps(PI_F)));
+    return _mm_xor_ps(r,_mm_and_ps(y,sign));
+}
+
+//Each sample pairs with the one before it, loaded one complex sample back
+__attribute__((target("sse2")))
+static void fm_discriminate_sse2(const float *in, float *previous, float *out, int N, float gain){
+    int i;
+    if (N<1){
+        return;
+    }
+    fm_discriminate_scalar(in,previous,out,1,gain);
+    for (i=1;i+4<=N;i+=4){
+        __m128 a=_mm_loadu_ps(in+2*i),b=_mm_loadu_ps(in+2*i+4);
+        __m128 c=_mm_loadu_ps(in+2*i-2),d=_mm_loadu_ps(in+2*i+2);
+        __m128 re=_mm_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0)),im=_mm_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1));
+        __m128 pr=_mm_shuffle_ps(c,d,_MM_SHUFFLE(2,0,2,0)),pi=_mm_shuffle_ps(c,d,_MM_SHUFFLE(3,1,3,1));
+        __m128 x=_mm_add_ps(_mm_mul_ps(re,pr),_mm_mul_ps(im,pi));
+        __m128 y=_mm_sub_ps(_mm_mul_ps(im,pr),_mm_mul_ps(re,pi));
+        _mm_storeu_ps(out+i,_mm_mul_ps(atan2_poly_sse2(y,x),_mm_set1_ps(gain)));
+    }
+    previous[0]=in[2*i-2];
+    previous[1]=in[2*i-1];
+    fm_discriminate_scalar(in+2*i,previous,out+i,N-i,gain);
+}
+
+//SSE2 polynomial sine, four phases per vector
+__attribute__((target("sse2")))
+static inline __m128 sine_poly_sse2(__m128i p){
+    const __m128 sign=_mm_set1_ps(-0.0f);
+    __m128 x=_mm_mul_ps(_mm_cvtepi32_ps(p),_mm_set1_ps(PHASE_SCALE));
+    __m128 a=_mm_andnot_ps(sign,x);
+    __m128 y,y2,poly;
+    a=_mm_min_ps(a,_mm_sub_ps(_mm_set1_ps(0.5f),a));
+    y=_mm_mul_ps(a,_mm_set1_ps(TWO_PI));
+    y2=_mm_mul_ps(y,y);
+    poly=_mm_add_ps(_mm_set1_ps(SIN_C9),_mm_mul_ps(y2,_mm_set1_ps(SIN_C11)));
+    poly=_mm_add_ps(_mm_set1_ps(SIN_C7),_mm_mul_ps(y2,poly));
+    poly=_mm_add_ps(_mm_set1_ps(SIN_C5),_mm_mul_ps(y2,poly));
+    poly=_mm_add_ps(_mm_set1_ps(SIN_C3),_mm_mul_ps(y2,poly));
+    y=_mm_add_ps(y,_mm_mul_ps(_mm_mul_ps(y,y2),poly));
+    return _mm_or_ps(y,_mm_and_ps(sign,x)); //odd function, put the sign back
+}
+
+__attribute__((target("sse2")))
+static void sine_phase_sse2(uint32_t phase, uint32_t step, float *out, int N){
+    int i;
+    __m128i p=_mm_add_epi32(_mm_set1_epi32((int32_t)phase),_mm_setr_epi32(0,(int32_t)step,(int32_t)(2*step),(int32_t)(3*step)));
+    const __m128i advance=_mm_set1_epi32((int32_t)(step*4));
+    for (i=0;i+4<=N;i+=4){
+        _mm_storeu_ps(out+i,sine_poly_sse2(p));
+        p=_mm_add_epi32(p,advance);
+    }
+    sine_phase_scalar(phase+(uint32_t)i*step,step,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void sine_mix_sse2(uint32_t phase, uint32_t step, float levels, const float *in, float offset, float *out, int N){
+    int i;
+    __m128i p=_mm_add_epi32(_mm_set1_epi32((int32_t)phase),_mm_setr_epi32(0,(int32_t)step,(int32_t)(2*step),(int32_t)(3*step)));
+    const __m128i advance=_mm_set1_epi32((int32_t)(step*4));
+    const __m128 one=_mm_set1_ps(1.0f);
+    const __m128 scale=_mm_set1_ps(levels);
+    const __m128 inverse=_mm_set1_ps(levels>0 ? 1/levels : 0);
+    const __m128 add=_mm_set1_ps(offset);
+    for (i=0;i+4<=N;i+=4){
+        __m128 carrier=sine_poly_sse2(p);
+        if (levels>0){
+            __m128i r=_mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(carrier,one),scale));
+            carrier=_mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(r),inverse),one);
+        }
+        _mm_storeu_ps(out+i,_mm_mul_ps(carrier,_mm_add_ps(_mm_loadu_ps(in+i),add)));
+        p=_mm_add_epi32(p,advance);
+    }
+    sine_mix_scalar(phase+(uint32_t)i*step,step,levels,in+i,offset,out+i,N-i);
+}
+
+__attribute__((target("sse2")))
+static void quantize_sse2(float *data, int N, float levels){
+    int i;
+    const __m128 one=_mm_set1_ps(1.0f);
+    const __m128 scale=_mm_set1_ps(levels);
+    const __m128 inverse=_mm_set1_ps(1/levels);
+    for (i=0;i+4<=N;i+=4){
+        __m128i r=_mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(data+i),one),scale)); //rounds to nearest
+        _mm_storeu_ps(data+i,_mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(r),inverse),one));
+    }
+    quantize_scalar(data+i,N-i,levels);
+}
+
+//AVX2 polynomial atan2 and FM discriminator, eight samples per vector
+__attribute__((target("avx2,fma")))
+static inline __m256 atan2_poly_avx2(__m256 y, __m256 x){
+    const __m256 sign=_mm256_set1_ps(-0.0f);
+    __m256 ax=_mm256_andnot_ps(sign,x),ay=_mm256_andnot_ps(sign,y);
+    __m256 a=_mm256_div_ps(_mm256_min_ps(ax,ay),_mm256_max_ps(_mm256_max_ps(ax,ay),_mm256_set1_ps(ATAN_TINY)));
+    __m256 s=_mm256_mul_ps(a,a);
+    __m256 r=_mm256_fmadd_ps(s,_mm256_set1_ps(ATAN_A9),_mm256_set1_ps(ATAN_A7));
+    r=_mm256_fmadd_ps(s,r,_mm256_set1_ps(ATAN_A5));
+    r=_mm256_fmadd_ps(s,r,_mm256_set1_ps(ATAN_A3));
+    r=_mm256_mul_ps(a,_mm256_fmadd_ps(s,r,_mm256_set1_ps(ATAN_A1)));
+    r=_mm256_blendv_ps(r,_mm256_sub_ps(_mm256_set1_ps(HALF_PI),r),_mm256_cmp_ps(ay,ax,_CMP_GT_OQ));
+    r=_mm256_blendv_ps(r,_mm256_sub_ps(_mm256_set1_ps(PI_F),r),x);
+    return _mm256_xor_ps(r,_mm256_and_ps(y,sign));
+}
+
+//Samples come out of the in-lane shuffles as 0,1,4,5,2,3,6,7, the permute puts them back
+__attribute__((target("avx2,fma")))
+static void fm_discriminate_avx2(const float *in, float *previous, float *out, int N, float gain){
+    const __m256i order=_mm256_setr_epi32(0,1,4,5,2,3,6,7);
+    int i;
+    if (N<1){
+        return;
+    }
+    fm_discriminate_scalar(in,previous,out,1,gain);
+    for (i=1;i+8<=N;i+=8){
+        __m256 a=_mm256_loadu_ps(in+2*i),b=_mm256_loadu_ps(in+2*i+8);
+        __m256 c=_mm256_loadu_ps(in+2*i-2),d=_mm256_loadu_ps(in+2*i+6);
+        __m256 re=_mm256_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0)),im=_mm256_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1));
+        __m256 pr=_mm256_shuffle_ps(c,d,_MM_SHUFFLE(2,0,2,0)),pi=_mm256_shuffle_ps(c,d,_MM_SHUFFLE(3,1,3,1));
+        __m256 x=_mm256_fmadd_ps(re,pr,_mm256_mul_ps(im,pi));
+        __m256 y=_mm256_fmsub_ps(im,pr,_mm256_mul_ps(re,pi));
+        __m256 phase=_mm256_mul_ps(atan2_poly_avx2(y,x),_mm256_set1_ps(gain));
+        _mm256_storeu_ps(out+i,_mm256_permutevar8x32_ps(phase,order));
+    }
+    previous[0]=in[2*i-2];
+    previous[1]=in[2*i-1];
+    fm_discriminate_scalar(in+2*i,previous,out+i,N-i,gain);
+}
+
+//AVX2 polynomial sine, eight phases per vector with fused multiply adds
+__attribute__((target("avx2,fma")))
+static inline __m256 sine_poly_avx2(__m256i p){
+    const __m256 sign=_mm256_set1_ps(-0.0f);
+    __m256 x=_mm256_mul_ps(_mm256_cvtepi32_ps(p),_mm256_set1_ps(PHASE_SCALE));
+    __m256 a=_mm256_andnot_ps(sign,x);
+    __m256 y,y2,poly;
+    a=_mm256_min_ps(a,_mm256_sub_ps(_mm256_set1_ps(0.5f),a));
+    y=_mm256_mul_ps(a,_mm256_set1_ps(TWO_PI));
+    y2=_mm256_mul_ps(y,y);
+    poly=_mm256_fmadd_ps(y2,_mm256_set1_ps(SIN_C11),_mm256_set1_ps(SIN_C9));
+    poly=_mm256_fmadd_ps(y2,poly,_mm256_set1_ps(SIN_C7));
+    poly=_mm256_fmadd_ps(y2,poly,_mm256_set1_ps(SIN_C5));
+    poly=_mm256_fmadd_ps(y2,poly,_mm256_set1_ps(SIN_C3));
+    y=_mm256_fmadd_ps(_mm256_mul_ps(y,y2),poly,y);
+    return _mm256_or_ps(y,_mm256_and_ps(sign,x));
+}
+
+__attribute__((target("avx2,fma")))
+static void sine_phase_avx2(uint32_t phase, uint32_t step, float *out, int N){
+    int i;
+    __m256i p=_mm256_add_epi32(_mm256_set1_epi32((int32_t)phase),
+                               _mm256_mullo_epi32(_mm256_set1_epi32((int32_t)step),_mm256_setr_epi32(0,1,2,3,4,5,6,7)));
+    const __m256i advance=_mm256_set1_epi32((int32_t)(step*8));
+    for (i=0;i+8<=N;i+=8){
+        _mm256_storeu_ps(out+i,sine_poly_avx2(p));
+        p=_mm256_add_epi32(p,advance);
+    }
+    sine_phase_scalar(phase+(uint32_t)i*step,step,out+i,N-i);
+}
+
+__attribute__((target("avx2,fma")))
+static void sine_mix_avx2(uint32_t phase, uint32_t step, float levels, const float *in, float offset, float *out, int N){
+    int i;
+    __m256i p=_mm256_add_epi32(_mm256_set1_epi32((int32_t)phase),
+                               _mm256_mullo_epi32(_mm256_set1_epi32((int32_t)step),_mm256_setr_epi32(0,1,2,3,4,5,6,7)));
+    const __m256i advance=_mm256_set1_epi32((int32_t)(step*8));
+    const __m256 one=_mm256_set1_ps(1.0f);
+    const __m256 scale=_mm256_set1_ps(levels);
+    const __m256 inverse=_mm256_set1_ps(levels>0 ? 1/levels : 0);
+    const __m256 add=_mm256_set1_ps(offset);
+    for (i=0;i+8<=N;i+=8){
+        __m256 carrier=sine_poly_avx2(p);
+        if (levels>0){
+            __m256i r=_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_add_ps(carrier,one),scale)); //same steps as quantize_avx2
+            carrier=_mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(r),inverse),one);
+        }
+        _mm256_storeu_ps(out+i,_mm256_mul_ps(carrier,_mm256_add_ps(_mm256_loadu_ps(in+i),add)));
+        p=_mm256_add_epi32(p,advance);
+    }
+    sine_mix_scalar(phase+(uint32_t)i*step,step,levels,in+i,offset,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void quantize_avx2(float *data, int N, float levels){
+    int i;
+    const __m256 one=_mm256_set1_ps(1.0f);
+    const __m256 scale=_mm256_set1_ps(levels);
+    const __m256 inverse=_mm256_set1_ps(1/levels);
+    for (i=0;i+8<=N;i+=8){
+        __m256i r=_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(data+i),one),scale));
+        _mm256_storeu_ps(data+i,_mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(r),inverse),one));
+    }
+    quantize_scalar(data+i,N-i,levels);
+}
+
+//AVX2 8 bit IQ and PCM conversion
+__attribute__((target("avx2")))
+static void u8_to_float_avx2(const uint8_t *in, float *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(U8_SCALE);
+    const __m256 offset=_mm256_set1_ps(U8_OFFSET);
+    for (i=0;i+8<=N;i+=8){
+        __m256i x=_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(in+i)));
+        _mm256_storeu_ps(out+i,_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(x),scale),offset));
+    }
+    u8_to_float_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void s8_to_float_avx2(const int8_t *in, float *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S8_SCALE);
+    for (i=0;i+8<=N;i+=8){
+        __m256i x=_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(in+i)));
+        _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(x),scale));
+    }
+    s8_to_float_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void s16_to_float_avx2(const int16_t *in, float *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S16_SCALE);
+    for (i=0;i+8<=N;i+=8){
+        __m256i x=_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(in+i)));
+        _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(x),scale));
+    }
+    s16_to_float_scalar(in+i,out+i,N-i);
+}
+
+//Byte shuffles 4 samples per 128 bit lane into the top of each 32 bit word, the second
+//lane's load reads 16 bytes from sample i+4 so the loop stops 10 samples from the end
+__attribute__((target("avx2")))
+static void s24_to_float_avx2(const uint8_t *in, float *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S24_SCALE);
+    const __m256i spread=_mm256_setr_epi8(-1,0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11,
+                                          -1,0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11);
+    for (i=0;i+10<=N;i+=8){
+        __m256i v=_mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(in+3*i))),
+                                          _mm_loadu_si128((const __m128i *)(in+3*i+12)),1);
+        __m256i x=_mm256_srai_epi32(_mm256_shuffle_epi8(v,spread),8);
+        _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(x),scale));
+    }
+    s24_to_float_scalar(in+3*i,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void s32_to_float_avx2(const int32_t *in, float *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S32_SCALE);
+    for (i=0;i+8<=N;i+=8){
+        __m256i x=_mm256_loadu_si256((const __m256i *)(in+i));
+        _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(x),scale));
+    }
+    s32_to_float_scalar(in+i,out+i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void float_to_s16_avx2(const float *in, int16_t *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S16_FULL);
+    for (i=0;i+16<=N;i+=16){
+        __m256i lo=_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in+i),scale));
+        __m256i hi=_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in+i+8),scale));
+        __m256i packed=_mm256_packs_epi32(lo,hi); //packs works per 128 bit lane, put the quarters back in order
+        _mm256_storeu_si256((__m256i *)(out+i),_mm256_permute4x64_epi64(packed,_MM_SHUFFLE(3,1,2,0)));
+    }
+    float_to_s16_scalar(in+i,out+i,N-i);
+}
+
+//Packs each 128 bit lane's 4 samples into its low 12 bytes and stores the lanes 12 bytes apart,
+//the second store writes 16 bytes from sample i+4 so the loop stops 10 samples from the end
+__attribute__((target("avx2")))
+static void float_to_s24_avx2(const float *in, uint8_t *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S24_FULL);
+    const __m256 top=_mm256_set1_ps(8388607.0f);
+    const __m256 bottom=_mm256_set1_ps(-8388608.0f);
+    const __m256i pack=_mm256_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1,
+                                        0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+    for (i=0;i+10<=N;i+=8){
+        __m256 x=_mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(in+i),scale),top),bottom);
+        __m256i v=_mm256_shuffle_epi8(_mm256_cvtps_epi32(x),pack);
+        _mm_storeu_si128((__m128i *)(out+3*i),_mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i *)(out+3*i+12),_mm256_extracti128_si256(v,1));
+    }
+    float_to_s24_scalar(in+i,out+3*i,N-i);
+}
+
+__attribute__((target("avx2")))
+static void float_to_s32_avx2(const float *in, int32_t *out, int N){
+    int i;
+    const __m256 scale=_mm256_set1_ps(S32_FULL);
+    const __m256 top=_mm256_set1_ps(S32_MAX_FLOAT);
+    const __m256 bottom=_mm256_set1_ps(-2147483648.0f);
+    for (i=0;i+8<=N;i+=8){
+        __m256 x=_mm256_mul_ps(_mm256_loadu_ps(in+i),scale);
+        x=_mm256_max_ps(_mm256_min_ps(x,top),bottom);
+        _mm256_storeu_si256((__m256i *)(out+i),_mm256_cvtps_epi32(x));
+    }
+    float_to_s32_scalar(in+i,out+i,N-i);
+}
+#endif
+
+#if VECTOR_ARM
+//NEON kernels, four samples per instruction
+static void multiply_neon(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        float32x4_t x0=vmulq_f32(vld1q_f32(a+i),vld1q_f32(b+i));
+        float32x4_t x1=vmulq_f32(vld1q_f32(a+i+4),vld1q_f32(b+i+4));
+        vst1q_f32(out+i,x0);
+        vst1q_f32(out+i+4,x1);
+    }
+    multiply_scalar(a+i,b+i,out+i,N-i);
+}
+
+//32 bit NEON has no vector divide, refine the reciprocal estimate twice with Newton-Raphson
+static float32x4_t reciprocal_q(float32x4_t x){
+    float32x4_t r=vrecpeq_f32(x);
+    r=vmulq_f32(vrecpsq_f32(x,r),r);
+    r=vmulq_f32(vrecpsq_f32(x,r),r);
+    return r;
+}
+
+static void divide_neon(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+#if defined(__aarch64__)
+        vst1q_f32(out+i,vdivq_f32(vld1q_f32(a+i),vld1q_f32(b+i)));
+#else
+        vst1q_f32(out+i,vmulq_f32(vld1q_f32(a+i),reciprocal_q(vld1q_f32(b+i))));
+#endif
+    }
+    divide_scalar(a+i,b+i,out+i,N-i);
+}
+
+static void reciprocal_neon(const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        float32x4_t x=vld1q_f32(in+i);
+        uint32x4_t nonzero=vmvnq_u32(vceqq_f32(x,vdupq_n_f32(0)));
+        uint32x4_t r=vandq_u32(vreinterpretq_u32_f32(reciprocal_q(x)),nonzero);
+        vst1q_f32(out+i,vreinterpretq_f32_u32(r));
+    }
+    reciprocal_scalar(in+i,out+i,N-i);
+}
+//vld2 splits the pairs into re and im vectors so no shuffles are needed
+static void real_complex_multiply_neon(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        float32x4_t w=vld1q_f32(a+i);
+        float32x4x2_t z=vld2q_f32(in+2*i);
+        z.val[0]=vmulq_f32(z.val[0],w);
+        z.val[1]=vmulq_f32(z.val[1],w);
+        vst2q_f32(out+2*i,z);
+    }
+    real_complex_multiply_scalar(a+i,in+2*i,out+2*i,N-i);
+}
+
+static void real_complex_divide_neon(const float *a, const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        float32x4x2_t z=vld2q_f32(in+2*i);
+#if defined(__aarch64__)
+        float32x4_t w=vld1q_f32(a+i);
+        z.val[0]=vdivq_f32(z.val[0],w);
+        z.val[1]=vdivq_f32(z.val[1],w);
+#else
+        float32x4_t r=reciprocal_q(vld1q_f32(a+i));
+        z.val[0]=vmulq_f32(z.val[0],r);
+        z.val[1]=vmulq_f32(z.val[1],r);
+#endif
+        vst2q_f32(out+2*i,z);
+    }
+    real_complex_divide_scalar(a+i,in+2*i,out+2*i,N-i);
+}
+
+static void complex_multiply_neon(const float *a, const float *b, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        float32x4x2_t x=vld2q_f32(a+2*i);
+        float32x4x2_t y=vld2q_f32(b+2*i);
+        float32x4x2_t z;
+        z.val[0]=vmlsq_f32(vmulq_f32(x.val[0],y.val[0]),x.val[1],y.val[1]);
+        z.val[1]=vmlaq_f32(vmulq_f32(x.val[0],y.val[1]),x.val[1],y.val[0]);
+        vst2q_f32(out+2*i,z);
+    }
+    complex_multiply_scalar(a+2*i,b+2*i,out+2*i,N-i);
+}
+
+static void complex_multiply_add_neon(const float *a, const float *b, float *acc, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        float32x4x2_t x=vld2q_f32(a+2*i);
+        float32x4x2_t y=vld2q_f32(b+2*i);
+        float32x4x2_t z=vld2q_f32(acc+2*i);
+        z.val[0]=vmlsq_f32(vmlaq_f32(z.val[0],x.val[0],y.val[0]),x.val[1],y.val[1]);
+        z.val[1]=vmlaq_f32(vmlaq_f32(z.val[1],x.val[0],y.val[1]),x.val[1],y.val[0]);
+        vst2q_f32(acc+2*i,z);
+    }
+    complex_multiply_add_scalar(a+2*i,b+2*i,acc+2*i,N-i);
+}
+
+//ARMv7 has no vector square root, x*rsqrt(x) with two Newton steps and 0 kept at 0
+static void complex_magnitude_neon(const float *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        float32x4x2_t x=vld2q_f32(in+2*i);
+        float32x4_t power=vmlaq_f32(vmulq_f32(x.val[0],x.val[0]),x.val[1],x.val[1]);
+#if defined(__aarch64__)
+        vst1q_f32(out+i,vsqrtq_f32(power));
+#else
+        float32x4_t r=vrsqrteq_f32(power);
+        r=vmulq_f32(r,vrsqrtsq_f32(vmulq_f32(power,r),r));
+        r=vmulq_f32(r,vrsqrtsq_f32(vmulq_f32(power,r),r));
+        vst1q_f32(out+i,vbslq_f32(vceqq_f32(power,vdupq_n_f32(0)),power,vmulq_f32(power,r)));
+#endif
+    }
+    complex_magnitude_scalar(in+2*i,out+i,N-i);
+}
+
+static float dot_neon(const float *a, const float *b, int N){
+    int i;
+    float32x4_t acc0=vdupq_n_f32(0);
+    float32x4_t acc1=vdupq_n_f32(0);
+    float32x2_t sum;
+    for (i=0;i+8<=N;i+=8){
+        acc0=vmlaq_f32(acc0,vld1q_f32(a+i),vld1q_f32(b+i));
+        acc1=vmlaq_f32(acc1,vld1q_f32(a+i+4),vld1q_f32(b+i+4));
+    }
+    acc0=vaddq_f32(acc0,acc1);
+    sum=vadd_f32(vget_low_f32(acc0),vget_high_f32(acc0));
+    sum=vpadd_f32(sum,sum);
+    return vget_lane_f32(sum,0)+dot_scalar(a+i,b+i,N-i);
+}
+
+static void dot_real_complex_neon(const float *taps, const float *x, int N, float out[2]){
+    int i;
+    float32x4_t re=vdupq_n_f32(0);
+    float32x4_t im=vdupq_n_f32(0);
+    float32x2_t sum;
+    float tail[2];
+    for (i=0;i+4<=N;i+=4){
+        float32x4_t w=vld1q_f32(taps+i);
+        float32x4x2_t z=vld2q_f32(x+2*i);
+        re=vmlaq_f32(re,w,z.val[0]);
+        im=vmlaq_f32(im,w,z.val[1]);
+    }
+    //pairwise adds leave the re total in lane 0 and the im total in lane 1
+    sum=vpadd_f32(vadd_f32(vget_low_f32(re),vget_high_f32(re)),vadd_f32(vget_low_f32(im),vget_high_f32(im)));
+    dot_real_complex_scalar(taps+i,x+2*i,N-i,tail);
+    out[0]=vget_lane_f32(sum,0)+tail[0];
+    out[1]=vget_lane_f32(sum,1)+tail[1];
+}
+
+static int cic_decimate_neon(uint64_t *state, int order, int decimation, int *phase, float in_scale, double out_scale,
+                             const float *in, float *out, int N){
+    uint64x2_t integrator[CIC_MAX_ORDER];
+    uint64x2_t comb[CIC_MAX_ORDER];
+    int i,j;
+    int count=0;
+    for (j=0;j<order;j++){
+        integrator[j]=vld1q_u64(state+2*j);
+        comb[j]=vld1q_u64(state+2*order+2*j);
+    }
+    for (i=0;i<N;i++){
+        float32x2_t x=vmul_n_f32(vld1_f32(in+2*i),in_scale);
+        //round half away from zero, 32 bit NEON only truncates
+        x=vadd_f32(x,vbsl_f32(vdup_n_u32(0x80000000u),x,vdup_n_f32(0.5f)));
+        uint64x2_t v=vreinterpretq_u64_s64(vmovl_s32(vcvt_s32_f32(x)));
+        for (j=0;j<order;j++){
+            integrator[j]=vaddq_u64(integrator[j],v);
+            v=integrator[j];
+        }
+        if (++*phase==decimation){
+            *phase=0;
+            for (j=0;j<order;j++){
+                uint64x2_t delay=comb[j];
+                comb[j]=v;
+                v=vsubq_u64(v,delay);
+            }
+            out[2*count]=(float)((double)(int64_t)vgetq_lane_u64(v,0)*out_scale);
+            out[2*count+1]=(float)((double)(int64_t)vgetq_lane_u64(v,1)*out_scale);
+            count++;
+        }
+    }
+    for (j=0;j<order;j++){
+        vst1q_u64(state+2*j,integrator[j]);
+        vst1q_u64(state+2*order+2*j,comb[j]);
+    }
+    return count;
+}
+
+//Four lanes per vector, two passes per group. The state is flushed to zero by the caller
+//after each block, AArch32 NEON already treats denormals as zero.
+static void sos_lanes_neon(const float *coefficients, float *state, int sections, int groups, float *data, int frames){
+    int stride=groups*SOS_LANES;
+    int g,j,half,n;
+    for (g=0;g<groups;g++){
+        for (j=0;j<sections;j++){
+            const float *c=coefficients+(size_t)(g*sections+j)*5*SOS_LANES;
+            float *st=state+(size_t)(g*sections+j)*2*SOS_LANES;
+            for (half=0;half<SOS_LANES;half+=4){
+                float32x4_t b0=vld1q_f32(c+half),b1=vld1q_f32(c+SOS_LANES+half),b2=vld1q_f32(c+2*SOS_LANES+half);
+                float32x4_t a1=vld1q_f32(c+3*SOS_LANES+half),a2=vld1q_f32(c+4*SOS_LANES+half);
+                float32x4_t s1=vld1q_f32(st+half),s2=vld1q_f32(st+SOS_LANES+half);
+                float *x=data+g*SOS_LANES+half;
+                for (n=0;n<frames;n++){
+                    float32x4_t in=vld1q_f32(x+(size_t)n*stride);
+                    float32x4_t y=vmlaq_f32(s1,b0,in);
+                    s1=vmlsq_f32(vmlaq_f32(s2,b1,in),a1,y);
+                    s2=vmlsq_f32(vmulq_f32(b2,in),a2,y);
+                    vst1q_f32(x+(size_t)n*stride,y);
+                }
+                vst1q_f32(st+half,s1);
+                vst1q_f32(st+SOS_LANES+half,s2);
+            }
+        }
+    }
+}
+
+//NEON polynomial atan2 and FM discriminator
+static inline float32x4_t atan2_poly_neon(float32x4_t y, float32x4_t x){
+    float32x4_t ax=vabsq_f32(x),ay=vabsq_f32(y);
+    float32x4_t top=vmaxq_f32(vmaxq_f32(ax,ay),vdupq_n_f32(ATAN_TINY));
+#if defined(__aarch64__)
+    float32x4_t a=vdivq_f32(vminq_f32(ax,ay),top);
+#else
+    float32x4_t a=vmulq_f32(vminq_f32(ax,ay),reciprocal_q(top));
+#endif
+    float32x4_t s=vmulq_f32(a,a);
+    float32x4_t r=vmlaq_n_f32(vdupq_n_f32(ATAN_A7),s,ATAN_A9);
+    uint32x4_t sign=vdupq_n_u32(0x80000000u);
+    r=vmlaq_f32(vdupq_n_f32(ATAN_A5),s,r);
+    r=vmlaq_f32(vdupq_n_f32(ATAN_A3),s,r);
+    r=vmulq_f32(a,vmlaq_f32(vdupq_n_f32(ATAN_A1),s,r));
+    r=vbslq_f32(vcgtq_f32(ay,ax),vsubq_f32(vdupq_n_f32(HALF_PI),r),r);
+    r=vbslq_f32(vcltq_s32(vreinterpretq_s32_f32(x),vdupq_n_s32(0)),vsubq_f32(vdupq_n_f32(PI_F),r),r);
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(r),vandq_u32(vreinterpretq_u32_f32(y),sign)));
+}
+
+static void fm_discriminate_neon(const float *in, float *previous, float *out, int N, float gain){
+    int i;
+    if (N<1){
+        return;
+    }
+    fm_discriminate_scalar(in,previous,out,1,gain);
+    for (i=1;i+4<=N;i+=4){
+        float32x4x2_t x=vld2q_f32(in+2*i);
+        float32x4x2_t p=vld2q_f32(in+2*i-2);
+        float32x4_t re=vmlaq_f32(vmulq_f32(x.val[0],p.val[0]),x.val[1],p.val[1]);
+        float32x4_t im=vmlsq_f32(vmulq_f32(x.val[1],p.val[0]),x.val[0],p.val[1]);
+        vst1q_f32(out+i,vmulq_n_f32(atan2_poly_neon(im,re),gain));
+    }
+    previous[0]=in[2*i-2];
+    previous[1]=in[2*i-1];
+    fm_discriminate_scalar(in+2*i,previous,out+i,N-i,gain);
+}
+
+//NEON polynomial sine
+static inline float32x4_t sine_poly_neon(uint32x4_t p){
+    float32x4_t x=vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(p)),PHASE_SCALE);
+    float32x4_t a=vabsq_f32(x);
+    float32x4_t y,y2,poly;
+    a=vminq_f32(a,vsubq_f32(vdupq_n_f32(0.5f),a));
+    y=vmulq_n_f32(a,TWO_PI);
+    y2=vmulq_f32(y,y);
+    poly=vmlaq_n_f32(vdupq_n_f32(SIN_C9),y2,SIN_C11);
+    poly=vmlaq_f32(vdupq_n_f32(SIN_C7),y2,poly);
+    poly=vmlaq_f32(vdupq_n_f32(SIN_C5),y2,poly);
+    poly=vmlaq_f32(vdupq_n_f32(SIN_C3),y2,poly);
+    y=vmlaq_f32(y,vmulq_f32(y,y2),poly);
+    //copy the sign bit of x onto the result
+    return vbslq_f32(vdupq_n_u32(0x80000000u),x,y);
+}
+
+static void sine_phase_neon(uint32_t phase, uint32_t step, float *out, int N){
+    int i;
+    static const uint32_t lanes[4]={0,1,2,3};
+    uint32x4_t p=vmlaq_n_u32(vdupq_n_u32(phase),vld1q_u32(lanes),step);
+    const uint32x4_t advance=vdupq_n_u32(step*4);
+    for (i=0;i+4<=N;i+=4){
+        vst1q_f32(out+i,sine_poly_neon(p));
+        p=vaddq_u32(p,advance);
+    }
+    sine_phase_scalar(phase+(uint32_t)i*step,step,out+i,N-i);
+}
+
+//ARMv7 NEON has no round to nearest conversion, so a quantised carrier goes through the scalar kernel like vector_quantize does
+static void sine_mix_neon(uint32_t phase, uint32_t step, float levels, const float *in, float offset, float *out, int N){
+    int i;
+    static const uint32_t lanes[4]={0,1,2,3};
+    uint32x4_t p=vmlaq_n_u32(vdupq_n_u32(phase),vld1q_u32(lanes),step);
+    const uint32x4_t advance=vdupq_n_u32(step*4);
+    if (levels>0){
+        sine_mix_scalar(phase,step,levels,in,offset,out,N);
+        return;
+    }
+    for (i=0;i+4<=N;i+=4){
+        float32x4_t signal=vaddq_f32(vld1q_f32(in+i),vdupq_n_f32(offset));
+        vst1q_f32(out+i,vmulq_f32(sine_poly_neon(p),signal));
+        p=vaddq_u32(p,advance);
+    }
+    sine_mix_scalar(phase+(uint32_t)i*step,step,levels,in+i,offset,out+i,N-i);
+}
+
+//NEON 8 bit IQ and PCM conversion and stereo (de)interleave
+static void u8_to_float_neon(const uint8_t *in, float *out, int N){
+    int i;
+    const float32x4_t offset=vdupq_n_f32(U8_OFFSET);
+    for (i=0;i+8<=N;i+=8){
+        uint16x8_t x=vmovl_u8(vld1_u8(in+i));
+        vst1q_f32(out+i,vmlaq_n_f32(offset,vcvtq_f32_u32(vmovl_u16(vget_low_u16(x))),U8_SCALE));
+        vst1q_f32(out+i+4,vmlaq_n_f32(offset,vcvtq_f32_u32(vmovl_u16(vget_high_u16(x))),U8_SCALE));
+    }
+    u8_to_float_scalar(in+i,out+i,N-i);
+}
+
+static void s8_to_float_neon(const int8_t *in, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        int16x8_t x=vmovl_s8(vld1_s8(in+i));
+        vst1q_f32(out+i,vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))),S8_SCALE));
+        vst1q_f32(out+i+4,vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))),S8_SCALE));
+    }
+    s8_to_float_scalar(in+i,out+i,N-i);
+}
+
+static void s16_to_float_neon(const int16_t *in, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        int16x8_t x=vld1q_s16(in+i);
+        vst1q_f32(out+i,vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))),S16_SCALE));
+        vst1q_f32(out+i+4,vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))),S16_SCALE));
+    }
+    s16_to_float_scalar(in+i,out+i,N-i);
+}
+
+//vld3 splits 8 samples into their low, middle and high bytes, the high byte carries the sign
+static void s24_to_float_neon(const uint8_t *in, float *out, int N){
+    int i;
+    for (i=0;i+8<=N;i+=8){
+        uint8x8x3_t b=vld3_u8(in+3*i);
+        int16x8_t top=vreinterpretq_s16_u16(vorrq_u16(vshll_n_u8(b.val[2],8),vmovl_u8(b.val[1])));
+        uint16x8_t low=vmovl_u8(b.val[0]);
+        int32x4_t lo=vorrq_s32(vshll_n_s16(vget_low_s16(top),8),vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+        int32x4_t hi=vorrq_s32(vshll_n_s16(vget_high_s16(top),8),vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))));
+        vst1q_f32(out+i,vmulq_n_f32(vcvtq_f32_s32(lo),S24_SCALE));
+        vst1q_f32(out+i+4,vmulq_n_f32(vcvtq_f32_s32(hi),S24_SCALE));
+    }
+    s24_to_float_scalar(in+3*i,out+i,N-i);
+}
+
+static void s32_to_float_neon(const int32_t *in, float *out, int N){
+    int i;
+    for (i=0;i+4<=N;i+=4){
+        vst1q_f32(out+i,vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(in+i)),S32_SCALE));
+    }
+    s32_to_float_scalar(in+i,out+i,N-i);
+}
+
+static void deinterleave2_neon(const float *in, float *left, float *right, int frames){
+    int i;
+    for (i=0;i+4<=frames;i+=4){
+        float32x4x2_t x=vld2q_f32(in+2*i);
+        vst1q_f32(left+i,x.val[0]);
+        vst1q_f32(right+i,x.val[1]);
+    }
+    deinterleave2_scalar(in+2*i,left+i,right+i,frames-i);
+}
+
+static void interleave2_neon(const float *left, const float *right, float *out, int frames){
+    int i;
+    for (i=0;i+4<=frames;i+=4){
+        float32x4x2_t x;
+        x.val[0]=vld1q_f32(left+i);
+        x.val[1]=vld1q_f32(right+i);
+        vst2q_f32(out+2*i,x);
+    }
+    interleave2_scalar(left+i,right+i,out+2*i,frames-i);
+}
+#endif
+
+//Chooses the widest kernel set the CPU supports, checked once on first use
+static const Vector_Kernels *vector_kernels(void){
+
+    static const Vector_Kernels *selected=NULL;
+    static const Vector_Kernels scalar={
+        .isa=VECTOR_SCALAR, .multiply=multiply_scalar, .divide=divide_scalar, .reciprocal=reciprocal_scalar,
+        .u8_to_float=u8_to_float_scalar, .s8_to_float=s8_to_float_scalar,
+        .s16_to_float=s16_to_float_scalar, .s24_to_float=s24_to_float_scalar, .s32_to_float=s32_to_float_scalar,
+        .float_to_s16=float_to_s16_scalar, .float_to_s24=float_to_s24_scalar, .float_to_s32=float_to_s32_scalar,
+        .deinterleave2=deinterleave2_scalar, .interleave2=interleave2_scalar,
+        .sine_phase=sine_phase_scalar, .quantize=quantize_scalar, .sine_mix=sine_mix_scalar,
+        .real_complex_multiply=real_complex_multiply_scalar, .real_complex_divide=real_complex_divide_scalar,
+        .complex_multiply=complex_multiply_scalar, .complex_multiply_add=complex_multiply_add_scalar,
+        .dot=dot_scalar, .dot_real_complex=dot_real_complex_scalar, .cic_decimate=cic_decimate_scalar,
+        .sos_lanes=sos_lanes_scalar, .complex_magnitude=complex_magnitude_scalar,
+        .fm_discriminate=fm_discriminate_scalar};
+#if VECTOR_X86
+    static const Vector_Kernels sse2={
+        .isa=VECTOR_SSE2, .multiply=multiply_sse2, .divide=divide_sse2, .reciprocal=reciprocal_sse2,
+        .u8_to_float=u8_to_float_sse2, .s8_to_float=s8_to_float_sse2,
+        .s16_to_float=s16_to_float_sse2, .s24_to_float=s24_to_float_sse2, .s32_to_float=s32_to_float_sse2,
+        .float_to_s16=float_to_s16_sse2, .float_to_s24=float_to_s24_sse2, .float_to_s32=float_to_s32_sse2,
+        .deinterleave2=deinterleave2_sse2, .interleave2=interleave2_sse2,
+        .sine_phase=sine_phase_sse2, .quantize=quantize_sse2, .sine_mix=sine_mix_sse2,
+        .real_complex_multiply=real_complex_multiply_sse2, .real_complex_divide=real_complex_divide_sse2,
+        .complex_multiply=complex_multiply_sse2, .complex_multiply_add=complex_multiply_add_sse2,
+        .dot=dot_sse2, .dot_real_complex=dot_real_complex_sse2, .cic_decimate=cic_decimate_sse2,
+        .sos_lanes=sos_lanes_sse2, .complex_magnitude=complex_magnitude_sse2,
+        .fm_discriminate=fm_discriminate_sse2};
+    static const Vector_Kernels avx2={
+        .isa=VECTOR_AVX2, .multiply=multiply_avx2, .divide=divide_avx2, .reciprocal=reciprocal_avx2,
+        .u8_to_float=u8_to_float_avx2, .s8_to_float=s8_to_float_avx2,
+        .s16_to_float=s16_to_float_avx2, .s24_to_float=s24_to_float_avx2, .s32_to_float=s32_to_float_avx2,
+        .float_to_s16=float_to_s16_avx2, .float_to_s24=float_to_s24_avx2, .float_to_s32=float_to_s32_avx2,
+        .deinterleave2=deinterleave2_sse2, .interleave2=interleave2_sse2,
+        .sine_phase=sine_phase_avx2, .quantize=quantize_avx2, .sine_mix=sine_mix_avx2,
+        .real_complex_multiply=real_complex_multiply_avx2, .real_complex_divide=real_complex_divide_avx2,
+        .complex_multiply=complex_multiply_avx2, .complex_multiply_add=complex_multiply_add_avx2,
+        .dot=dot_avx2, .dot_real_complex=dot_real_complex_avx2, .cic_decimate=cic_decimate_sse2,
+        .sos_lanes=sos_lanes_avx2, .complex_magnitude=complex_magnitude_avx2,
+        .fm_discriminate=fm_discriminate_avx2};
+#elif VECTOR_ARM
+    static const Vector_Kernels neon={
+        .isa=VECTOR_NEON, .multiply=multiply_neon, .divide=divide_neon, .reciprocal=reciprocal_neon,
+        .u8_to_float=u8_to_float_neon, .s8_to_float=s8_to_float_neon,
+        .s16_to_float=s16_to_float_neon, .s24_to_float=s24_to_float_neon, .s32_to_float=s32_to_float_neon,
+        .float_to_s16=float_to_s16_scalar, .float_to_s24=float_to_s24_scalar, .float_to_s32=float_to_s32_scalar,
+        .deinterleave2=deinterleave2_neon, .interleave2=interleave2_neon,
+        .sine_phase=sine_phase_neon, .quantize=quantize_scalar, .sine_mix=sine_mix_neon,
+        .real_complex_multiply=real_complex_multiply_neon, .real_complex_divide=real_complex_divide_neon,
+        .complex_multiply=complex_multiply_neon, .complex_multiply_add=complex_multiply_add_neon,
+        .dot=dot_neon, .dot_real_complex=dot_real_complex_neon, .cic_decimate=cic_decimate_neon,
+        .sos_lanes=sos_lanes_neon, .complex_magnitude=complex_magnitude_neon,
+        .fm_discriminate=fm_discriminate_neon};
+#endif
+
+    if (selected==NULL){ //racing threads all pick the same table so no lock is needed
+        const Vector_Kernels *best=&scalar;
+#if VECTOR_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){ //the avx2 table also uses FMA
+            best=&avx2;
+        }
+        else if (__builtin_cpu_supports("sse2")){
+            best=&sse2;
+        }
+#elif VECTOR_ARM
+        best=&neon;
+#endif
+        selected=best;
+    }
+    return selected;
+}
+
+//Returns the instruction set the kernels are running with
+Vector_Isa vector_isa(void){
+    return vector_kernels()->isa;
+}
+
+//Returns a printable name of the instruction set in use
+const char *vector_isa_name(void){
+    switch (vector_isa()){
+        case VECTOR_SSE2: return "SSE2";
+        case VECTOR_AVX2: return "AVX2";
+        case VECTOR_NEON: return "NEON";
+        default:          return "scalar";
+    }
+}
+
+//Element wise product of two arrays
+void vector_multiply(const float a[], const float b[], float out[], int N){
+    if (N>0){
+        vector_kernels()->multiply(a,b,out,N);
+    }
+}
+
+//Applies a window to data in place
+void vector_multiply_inplace(const float window[], float data[], int N){
+    if (N>0){
+        vector_kernels()->multiply(window,data,data,N);
+    }
+}
+
+//Element wise division of two arrays
+void vector_divide(const float a[], const float b[], float out[], int N){
+    if (N>0){
+        vector_kernels()->divide(a,b,out,N);
+    }
+}
+
+//Scales complex samples by real coefficients, e.g. windows an IQ block
+void vector_multiply_real_complex(const float a[], const float in[][2], float out[][2], int N){
+    if (N>0){
+        vector_kernels()->real_complex_multiply(a,in[0],out[0],N);
+    }
+}
+
+//Divides complex samples by real coefficients, e.g. removes a window from an IQ block
+void vector_divide_real_complex(const float a[], const float in[][2], float out[][2], int N){
+    if (N>0){
+        vector_kernels()->real_complex_divide(a,in[0],out[0],N);
+    }
+}
+
+//Element wise complex product, e.g. mixes an IQ block with an oscillator
+void vector_complex_multiply(const float a[][2], const float b[][2], float out[][2], int N){
+    if (N>0){
+        vector_kernels()->complex_multiply(a[0],b[0],out[0],N);
+    }
+}
+
+//Complex multiply accumulate, e.g. sums spectra of a partitioned convolution
+void vector_complex_multiply_add(const float a[][2], const float b[][2], float acc[][2], int N){
+    if (N>0){
+        vector_kernels()->complex_multiply_add(a[0],b[0],acc[0],N);
+    }
+}
+
+//Envelope of an IQ block, sqrt(re^2+im^2) per sample
+void vector_complex_magnitude(const float in[][2], float out[], int N){
+    if (N>0){
+        vector_kernels()->complex_magnitude(in[0],out,N);
+    }
+}
+
+//FM discriminator, the phase step from each sample to the next
+void vector_fm_discriminate(const float in[][2], float previous[2], float out[], int N, float gain){
+    if (N>0){
+        vector_kernels()->fm_discriminate(in[0],previous,out,N,gain);
+    }
+}
+
+//Sum of a[i]*b[i], one output of an FIR
+float vector_dot(const float a[], const float b[], int N){
+    if (N>0){
+        return vector_kernels()->dot(a,b,N);
+    }
+    return 0;
+}
+
+//One output of an FIR with real taps on complex samples
+void vector_dot_real_complex(const float taps[], const float x[][2], int N, float out[2]){
+    if (N>0){
+        vector_kernels()->dot_real_complex(taps,x[0],N,out);
+    }
+    else{
+        out[0]=out[1]=0;
+    }
+}
+
+//Filters interleaved frames of channels through cascaded biquads, one channel per lane
+void vector_sos_lanes(const float coefficients[], float state[], int sections, int groups, float data[], int frames){
+    if (frames>0 && sections>0 && groups>0){
+        vector_kernels()->sos_lanes(coefficients,state,sections,groups,data,frames);
+    }
+}
+
+//Runs complex samples through a CIC decimator, returns the number of outputs
+int vector_cic_decimate(uint64_t state[], int order, int decimation, int *phase, float in_scale, double out_scale,
+                        const float in[][2], float out[][2], int N){
+    if (N<=0 || order<1 || order>CIC_MAX_ORDER){
+        return 0;
+    }
+    return vector_kernels()->cic_decimate(state,order,decimation,phase,in_scale,out_scale,in[0],out[0],N);
+}
+
+//Builds a reciprocal table so later divisions become multiplications
+void vector_reciprocal(const float in[], float out[], int N){
+    if (N>0){
+        vector_kernels()->reciprocal(in,out,N);
+    }
+}
+
+//out[i] = sin(2*pi*(phase+i*step)/2^32), a 32 bit phase accumulator evaluated with a polynomial
+void vector_sine_phase(uint32_t phase, uint32_t step, float out[], int N){
+    if (N>0){
+        vector_kernels()->sine_phase(phase,step,out,N);
+    }
+}
+
+//Rounds [-1,1] data to 2*levels+1 evenly spaced values, levels=(2^bits-1)/2 mimics a bits wide converter
+void vector_quantize(float data[], int N, float levels){
+    if (N>0 && levels>0){
+        vector_kernels()->quantize(data,N,levels);
+    }
+}
+
+//out[i] = sin(2*pi*(phase+i*step)/2^32)*(in[i]+offset) in one pass, the sine quantised first when levels>0
+void vector_sine_mix(uint32_t phase, uint32_t step, float levels, const float in[], float offset, float out[], int N){
+    if (N>0){
+        vector_kernels()->sine_mix(phase,step,levels,in,offset,out,N);
+    }
+}
+
+//Converts offset binary 8 bit samples (cu8) to float in [-1,1]
+void vector_u8_to_float(const uint8_t in[], float out[], int N){
+    if (N>0){
+        vector_kernels()->u8_to_float(in,out,N);
+    }
+}
+
+//Converts signed 8 bit samples (cs8) to float in [-1,1)
+void vector_s8_to_float(const int8_t in[], float out[], int N){
+    if (N>0){
+        vector_kernels()->s8_to_float(in,out,N);
+    }
+}
+
+//Converts float to offset binary 8 bit samples, clipping at full scale
+void vector_float_to_u8(const float in[], uint8_t out[], int N){
+    int i;
+    for (i=0;i<N;i++){
+        float x=(in[i]+1.0f)*127.5f;
+        x= x>255.0f ? 255.0f : (x<0.0f ? 0.0f : x);
+        out[i]=(uint8_t) lrintf(x);
+    }
+}
+
+//Converts float to signed 8 bit samples, clipping at full scale
+void vector_float_to_s8(const float in[], int8_t out[], int N){
+    int i;
+    for (i=0;i<N;i++){
+        float x=in[i]*128.0f;
+        x= x>127.0f ? 127.0f : (x<-128.0f ? -128.0f : x);
+        out[i]=(int8_t) lrintf(x);
+    }
+}
+
+//Converts signed 16 bit PCM to float in [-1,1)
+void vector_s16_to_float(const int16_t in[], float out[], int N){
+    if (N>0){
+        vector_kernels()->s16_to_float(in,out,N);
+    }
+}
+
+//Converts packed little endian signed 24 bit PCM to float in [-1,1)
+void vector_s24_to_float(const uint8_t in[], float out[], int N){
+    if (N>0){
+        vector_kernels()->s24_to_float(in,out,N);
+    }
+}
+
+//Converts signed 32 bit PCM to float in [-1,1]
+void vector_s32_to_float(const int32_t in[], float out[], int N){
+    if (N>0){
+        vector_kernels()->s32_to_float(in,out,N);
+    }
+}
+
+//Converts float to signed 16 bit PCM, clipping at full scale
+void vector_float_to_s16(const float in[], int16_t out[], int N){
+    if (N>0){
+        vector_kernels()->float_to_s16(in,out,N);
+    }
+}
+
+//Converts float to packed little endian signed 24 bit PCM, clipping at full scale
+void vector_float_to_s24(const float in[], uint8_t out[], int N){
+    if (N>0){
+        vector_kernels()->float_to_s24(in,out,N);
+    }
+}
+
+//Converts float to signed 32 bit PCM, clipping at full scale
+void vector_float_to_s32(const float in[], int32_t out[], int N){
+    if (N>0){
+        vector_kernels()->float_to_s32(in,out,N);
+    }
+}
+
+//Splits interleaved frames [LRLR] into one array per channel
+void vector_deinterleave(const float in[], float *const out[], int channels, int frames){
+    int i,c;
+    if (frames<=0){
+        return;
+    }
+    if (channels==2){
+        vector_kernels()->deinterleave2(in,out[0],out[1],frames);
+        return;
+    }
+    for (c=0;c<channels;c++){
+        float *dest=out[c];
+        for (i=0;i<frames;i++){
+            dest[i]=in[i*channels+c];
+        }
+    }
+}
+
+//Joins one array per channel into interleaved frames [LRLR]
+void vector_interleave(const float *const in[], float out[], int channels, int frames){
+    int i,c;
+    if (frames<=0){
+        return;
+    }
+    if (channels==2){
+        vector_kernels()->interleave2(in[0],in[1],out,frames);
+        return;
+    }
+    for (c=0;c<channels;c++){
+        const float *src=in[c];
+        for (i=0;i<frames;i++){
+            out[i*channels+c]=src[i];
+        }
+    }
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -1,629 +1,768 @@
-//********************************************************************
-//*                    Visual                                        *
-//*==================================================================*
-//* WRITTEN BY: Liam McEvoy    	                 		             *
-//* DATE CREATED:   14/01/21                                         *
-//* MODIFIED:                                                        *
-//*==================================================================*
-//* PROGRAMMED IN: Visual Studio                                     *
-//*==================================================================*
-//* DESCRIPTION: Program to visualise captured and processed         *
-//*             sampled data for Software Defined Radio program      *
-//********************************************************************
-// INCLUDE FILES
-//====================================================================
-
-#include <../include/Test_Data.h>
-#include <../include/tinywav.h>
-#include <fftw3.h>
-#include <math.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <gtk/gtk.h>
-#include <../include/SDR.h>
-#include <gtkglg.h>
-#define _GNU_SOURCE
-#include <string.h>
-
-
-//====================================================================
-// STRUCTURES
-//====================================================================
-
-typedef struct Widgets {
-	GtkWidget	*window;
-	GtkWidget	*fixed;
-	GtkWidget	*menubar;
-	GtkWidget	*New;
-	GtkWidget	*Open;
-	GtkWidget	*Save;
-	GtkWidget	*Save_as;
-	GtkWidget	*Cut;
-	GtkWidget	*Copy;
-	GtkWidget	*Paste;
-	GtkWidget	*Delete;
-	GtkWidget	*FFT;
-	GtkWidget	*Spectrogram;
-	GtkWidget	*Original_Data;
-	GtkWidget	*Triangle;
-	GtkWidget	*Welch;
-	GtkWidget	*Sine;
-	GtkWidget	*Hann;
-	GtkWidget	*Hamming;
-	GtkWidget	*Blackman;
-	GtkWidget	*Gaussian;
-	GtkWidget	*No_window;
-	GtkWidget	*About;
-	GtkWidget	*Play;
-	GtkWidget	*Pause;
-	GtkWidget	*toolbar;
-	GtkWidget	*volume;
-	GtkWidget	*sampling;
-	GtkWidget	*sampling_1;
-	GtkWidget	*sampling_2;
-	GtkWidget	*sampling_3;
-	GtkBuilder  *builder;
-	GlgObject   *dataplot;
-	GtkWidget	*viewport;
-	GtkWidget	*viewport1;
-	GtkWidget	*viewport2;
-	GtkWidget	*viewport3;
-	GtkWidget	*Skip;
-	GtkWidget	*Zoom_out;
-	GtkWidget	*Zoom_in;
-	GtkWidget	*File_name;
-	GlgObject   *Glg_viewport;
-	GtkWidget   *glg;
-	GlgObject   *Glg_viewport1;
-	GtkWidget   *glg1;
-	GtkWidget   *recentchooserdialog1;
-	GtkWidget 	*Savedialog;
-	GtkFileFilter	*filter;
-	char        *filename;
-	char        *path;
-
-} Widgets;
-
-//====================================================================
-// SYMBOLIC CONSTANTS
-//====================================================================
-
-#define _USE_MATH_DEFINES
-#define UPDATE_INTERVAL    50 /* millisec */ 
-#define TRACE_GLG_MESSAGES 0
-
-//====================================================================
-// GLOBAL VARIABLES
-//====================================================================
-GlgObject Plots[2]; 
-GlgObject Plots1[1]; 
-Widgets glade;
-bool user_edited_a_new_document=true;
-//====================================================================
-// FUNCTION DECLARATIONS
-//====================================================================
-
-void InitChartBeforeH( gpointer data,double major_interval,double minor_interval,int NUM_PLOTS, int TimeSpan,double Low, double High, GlgObject Plots[], GlgLong num_plots_in_drawing  );
-
-static gint UpdateChart( gpointer data );
-void on_window_main_destroy();
-void test_wav();
-
-//Main for running the GUI part of the program
-int main(int argc, char *argv[]) {
-	char * full_path;
-
-    gtk_init(&argc, &argv);
-	gtk_glg_toolkit_init( argc, argv );
-
-    glade.builder       = gtk_builder_new();
-    gtk_builder_add_from_file (glade.builder, "../GUI/sdr_window.glade", NULL);
-
-    glade.window        = GTK_WIDGET(gtk_builder_get_object(glade.builder, "window_main"));
-
-    gtk_builder_connect_signals(glade.builder, NULL);
-	
-	glade.glg           = gtk_glg_new();
-	glade.glg1          = gtk_glg_new();
-	glade.fixed         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "fixed"));
-	glade.menubar       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "menubar"));
-	glade.New           = GTK_WIDGET(gtk_builder_get_object(glade.builder, "New"));
-	glade.Open          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Open"));
-	glade.Save          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Save"));
-	glade.Save_as       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Save as"));
-	glade.Cut           = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Cut"));
-	glade.Copy          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Copy"));
-	glade.Paste         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Paste"));
-	glade.Delete        = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Delete"));
-	glade.FFT           = GTK_WIDGET(gtk_builder_get_object(glade.builder, "FFT"));
-	glade.Spectrogram   = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Spectrogram"));
-	glade.Original_Data = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Original_Data"));
-	glade.Triangle      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Triangle"));
-	glade.Welch         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Welch"));
-	glade.Sine          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Sine"));
-	glade.Hann          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Hann"));
-	glade.Hamming       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Hamming"));
-	glade.Blackman      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Blackman"));
-	glade.Gaussian      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Gaussian"));
-	glade.No_window     = GTK_WIDGET(gtk_builder_get_object(glade.builder, "No_window"));
-	glade.About         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "About"));
-	glade.Play          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Play"));
-	glade.Pause         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Pause"));
-	glade.toolbar       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "toolbar"));
-	glade.volume        = GTK_WIDGET(gtk_builder_get_object(glade.builder, "volume"));
-	glade.sampling      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling"));
-	glade.sampling_1    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling_1"));
-	glade.sampling_2    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling_2"));
-	glade.sampling_3    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling_3"));
-	glade.viewport      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport"));
-	glade.viewport1     = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport1"));
-	glade.viewport2     = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport2"));
-	glade.Skip          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Skip"));
-	glade.Zoom_out      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Zoom_out"));
-	glade.Zoom_in       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Zoom_in"));
-	glade.File_name    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "File_name"));
-	glade.viewport3    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport3"));
-	gtk_widget_set_sensitive(glade.Save ,false);
-	
-	full_path = GlgCreateRelativePath( argv[0], "../Drawings", False, False );
-  	GlgSetSResource( NULL, "$config/GlgSearchPath", full_path );
-  	GlgFree( full_path );
-
-	glade.Glg_viewport = GlgLoadWidgetFromFile( "chart2.g"  );
-	glade.Glg_viewport1 = GlgLoadWidgetFromFile( "chart11.g" );
-
-  	gtk_glg_set_viewport(glade.glg, glade.Glg_viewport   );
-	gtk_glg_set_viewport(glade.glg1, glade.Glg_viewport1 );
-  	GlgDropObject( glade.Glg_viewport );
-  	GlgDropObject( glade.Glg_viewport1);
-	
-    g_object_unref(glade.builder);
-	gtk_container_add( GTK_CONTAINER( glade.viewport  ), glade.glg  );
-	gtk_container_add( GTK_CONTAINER( glade.viewport1 ), glade.glg1 );
-
-	double num_plots_d ,num_plots_d1;
-	GlgGetDResource( glade.Glg_viewport, "Chart/NumPlots", &num_plots_d );
-	GlgGetDResource( glade.Glg_viewport1, "Chart/NumPlots", &num_plots_d1 );
-
-	InitChartBeforeH(glade.Glg_viewport,-6,-5,2,60,-1.,1.,Plots,num_plots_d );
-	InitChartBeforeH(glade.Glg_viewport1,-6,-5,1,60,0.,10000.,Plots1,num_plots_d1 );
-	gtk_label_set_text (GTK_LABEL(glade.File_name),"No wav file Chosen");
-
-  	gtk_widget_show( glade.glg    );
-	gtk_widget_show( glade.glg1   );
-  	gtk_widget_show( glade.window );
-
-  	/* Add timer to update control panel with data. */
-  	g_timeout_add( (guint32) UPDATE_INTERVAL, UpdateChart, (gpointer) glade.Glg_viewport );  
-	g_timeout_add( (guint32) UPDATE_INTERVAL, UpdateChart, (gpointer) glade.Glg_viewport1 ); 
-
-	//----- ENTER THE GTK MAIN LOOP -----
-	gtk_main();		//Enter the GTK+ main loop until the application closes.
-
-	return 0;
-}
-
-/*----------------------------------------------------------------------
-| Initializes chart parameters before hierarchy setup occurred.
-*/
-void InitChartBeforeH( gpointer data,double major_interval,double minor_interval,int NUM_PLOTS, int TimeSpan,double Low, double High, GlgObject Plots[], GlgLong num_plots_in_drawing  ){
-   	GlgObject viewport = (GlgObject) data;
-
-   	/* Set new number of plots as needed. */
-   	GlgSetDResource( viewport, "Chart/NumPlots", NUM_PLOTS );
-
-   	/* Set Time Span for the X axis. */
-   	GlgSetDResource(  viewport, "Chart/XAxis/Span", TimeSpan );
-
-   	/* Set tick intervals for the Time axis. Positive value sets the
-      	exact interval in sec, while negative value sets the number of ticks
-      	regardless of the time span. 
-   	*/
-
-   	GlgSetDResource( viewport, "Chart/XAxis/MajorInterval", major_interval );
-   	GlgSetDResource( viewport, "Chart/XAxis/MinorInterval", minor_interval );
-
-   	/* Set data value range. Since the graph has one Y axis and
-      	common data range for the plots, Low/High data range is
-      	set on the YAxis level.
-     	*/
-   	GlgSetDResource( viewport, "Chart/YAxis/Low", Low );
-   	GlgSetDResource( viewport, "Chart/YAxis/High", High );
-
-   	GlgLong i;
-   	char *res_name;
-
-   	/* Store objects IDs for each plot. */
-   	for( i=0; i<NUM_PLOTS; ++i ){
-      	res_name = GlgCreateIndexedName( "Plot#%", i );
-      	Plots[i] = GlgGetNamedPlot( viewport, "Chart", res_name ); 
-      	GlgFree( res_name );
-   	}
-      
-   	/* For the existing plots, use color and line annotation setting 
-     	 from the drawing; initialize new plots using random colors and strings
-      	for demo purposes. 
-   	*/
-   	if( num_plots_in_drawing < NUM_PLOTS ){
-     	for( i=num_plots_in_drawing; i < NUM_PLOTS; ++i ){
-			/* Using a random color for a demo. */
-			GlgSetGResource( Plots[i], "EdgeColor", GlgRand(0., 1.), GlgRand(0., 1.), GlgRand(0., 1.) );
-			res_name = GlgCreateIndexedName( "Var%", i );
-			GlgSetSResource( Plots[i], "Annotation", res_name );
-			GlgFree( res_name );
-     	}
-	}
-}
-
-
-static gint UpdateChart( gpointer data )
-{
-   	GlgObject viewport = (GlgObject) data;
-
-	GlgUpdate( viewport );
-    GlgSync( viewport );
-   	/* Reinstall the timer */
-   	g_timeout_add( (guint32) UPDATE_INTERVAL, UpdateChart, (gpointer) viewport );   
-
-	return 0;
-}
-
-// called when window is closed
-void on_window_main_destroy(){
-    gtk_main_quit();
-}
-
-// called when Quit is clicked
-void on_Quit_activate(GtkMenuItem *menuitem){
-    gtk_main_quit();
-}
-
-// called when New is clicked
-void on_New_activate(GtkMenuItem *menuitem){
-	gtk_label_set_text (GTK_LABEL(glade.File_name),"Untitled.wav");
-	glade.filename="Untitled.wav";
-	gtk_widget_set_sensitive(glade.Save ,true);
-	glade.path="../data/";
-
-}
-
-// called when Open is clicked
-void on_Open_activate(GtkMenuItem *menuitem){
-	gtk_widget_set_sensitive(glade.Save ,true);
-	glade.recentchooserdialog1 = gtk_file_chooser_dialog_new ("Open File",GTK_WINDOW(glade.window),GTK_FILE_CHOOSER_ACTION_OPEN,"_CANCEL", GTK_RESPONSE_CANCEL,"_OPEN", GTK_RESPONSE_ACCEPT,NULL);
-	glade.filter =gtk_file_filter_new();
-    gtk_file_filter_set_name(glade.filter,"Wav Files");
-	gtk_file_filter_add_pattern(glade.filter,"*.wav");
-	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER ( glade.recentchooserdialog1 ),glade.filter);
-	gtk_window_set_default_size(GTK_WINDOW(glade.recentchooserdialog1),100,150);
-	if (gtk_dialog_run (GTK_DIALOG ( glade.recentchooserdialog1 )) == GTK_RESPONSE_ACCEPT){
-    	char *filename;
-    	glade.filename= gtk_file_chooser_get_filename(GTK_FILE_CHOOSER ( glade.recentchooserdialog1 ));
-		filename=g_path_get_basename (glade.filename);
-		user_edited_a_new_document=false;
-		gtk_label_set_text (GTK_LABEL(glade.File_name),filename);
-		g_free (filename);
-		glade.path=g_path_get_dirname(gtk_file_chooser_get_filename(GTK_FILE_CHOOSER ( glade.recentchooserdialog1 )));
-  	}
-	
-
-	gtk_widget_destroy( glade.recentchooserdialog1 );
-}
-
-// called when Save is clicked
-void on_Save_activate(GtkMenuItem *menuitem){
-	
-	char *filename;
-	glade.Savedialog= gtk_file_chooser_dialog_new ("Save File",GTK_WINDOW(glade.window),GTK_FILE_CHOOSER_ACTION_SAVE,"_CANCEL", GTK_RESPONSE_CANCEL,"_SAVE", GTK_RESPONSE_ACCEPT,NULL);
-	glade.filter =gtk_file_filter_new();
-    gtk_file_filter_set_name(glade.filter,"Wav Files");
-	gtk_file_filter_add_pattern(glade.filter,"*.wav");
-	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER ( glade.Savedialog),glade.filter);
-	gtk_window_set_default_size(GTK_WINDOW(glade.Savedialog),100,150);
-	gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER (glade.Savedialog),TRUE);
-	if (user_edited_a_new_document){
-  		gtk_file_chooser_set_current_name (GTK_FILE_CHOOSER (glade.Savedialog),glade.filename);
-	}
-	else{
-  		gtk_file_chooser_set_filename(GTK_FILE_CHOOSER (glade.Savedialog),glade.filename);
-	}
-	if(glade.path!=NULL){
-		gtk_file_chooser_set_current_folder (GTK_FILE_CHOOSER (glade.Savedialog),glade.path);
-	}
-	if (gtk_dialog_run (GTK_DIALOG (glade.Savedialog)) == GTK_RESPONSE_ACCEPT){
-    	glade.filename = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (glade.Savedialog));
-		filename=g_path_get_basename (glade.filename);
-		gtk_label_set_text (GTK_LABEL(glade.File_name),filename);
-    	g_free (filename);
-		user_edited_a_new_document=false;
-		glade.path=g_path_get_dirname(gtk_file_chooser_get_filename(GTK_FILE_CHOOSER ( glade.Savedialog )));
-  	}
-
-	gtk_widget_destroy ( glade.Savedialog );
-}
-
-// called when Save as is clicked
-void on_Save_as_activate(GtkMenuItem *menuitem){
-	
-}
-
-// called when Cut is clicked
-void on_Cut_activate(GtkMenuItem *menuitem){
-	
-}
-
-// called when Copy is clicked
-void on_Copy_activate(GtkMenuItem *menuitem){
-	
-}
-
-// called when Paste is clicked
-void on_Paste_activate(GtkMenuItem *menuitem){
-	
-}
-
-// called when Delete is clicked
-void on_Delete_activate(GtkMenuItem *menuitem){
-	
-}
-
-// called when FFT graph is toggled
-void on_FFT_toggled(GtkCheckMenuItem *checkmenuitem){
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(checkmenuitem));
-	if(T){
-		
-	}
-	else{
-		
-	}	
-}
-
-// called when Spectrogram graph is toggled
-void on_Spectrogram_toggled(GtkCheckMenuItem *checkmenuitem){
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(checkmenuitem));
-	if(T){
-		
-	}
-	else{
-		
-	}	
-}
-
-// called when Data graph is toggled
-void on_Original_Data_toggled(GtkCheckMenuItem *checkmenuitem){
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(checkmenuitem));
-	if(T){
-		
-	}
-	else{
-		
-	}
-
-}
-
-// called when Triangle window is toggled and needs to be implemented
-void on_Triangle_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-		
-	}
-	else{
-		
-	}
-}
-
-// called when Welch window is toggled and needs to be implemented
-void on_Welch_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when Sine window is toggled and needs to be implemented
-void on_Sine_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when Hann window is toggled and needs to be implemented
-void on_Hann_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when Hamming window is toggled and needs to be implemented
-void on_Hamming_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when Blackman window is toggled and needs to be implemented
-void on_Blackman_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when Gaussian window is toggled and needs to be implemented
-void on_Gaussian_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when Uniform window is toggled and needs to be implemented
-void on_No_window_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when About button is clicked
-void on_About_activate(GtkMenuItem *menuitem){
-	
-}
-
-// called when Pause tool is clicked
-void on_Pause_toggled(GtkToolItem *toolitem){
-	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
-	if(T){
-		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Play),False);
-	}
-	else{
-		
-	}
-}
-
-// called when Play tool is clicked
-void on_Play_toggled(GtkToolItem *toolitem){
-	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
-	if(T){
-		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Pause),False);
-	}
-	else{
-		
-	}	
-}
-
-// called when Skip tool is clicked
-void on_Skip_toggled(GtkToolItem *toolitem){
-	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
-	if(T){
-
-	}
-	else{
-		
-	}	
-}
-
-// called when Zoom out tool is clicked
-void on_Zoom_out_toggled(GtkToolItem *toolitem){
-	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
-	if(T){
-		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Zoom_in),False);
-	}
-	else{
-		
-	}	
-}
-
-// called when Zoom in tool is clicked
-void on_Zoom_in_toggled(GtkToolItem *toolitem){
-	gboolean T =gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
-	if(T){
-		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Zoom_out),False);
-	}
-	else{
-		
-	}	
-}
-
-// called when Volume is clicked
-void on_volume_value_changed(GtkVolumeButton *volume){
-	gdouble scale=gtk_scale_button_get_value(GTK_SCALE_BUTTON(volume));
-	
-}
-
-// called when sampling is set to 44.1 KHz
-void on_sampling_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when sampling is set to 48 KHz
-void on_sampling_1_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when sampling is set to 88.2 KHz
-void on_sampling_2_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-// called when sampling is set to 96 KHz
-void on_sampling_3_toggled(GtkRadioMenuItem *radio) {
-	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
-	if(T){
-
-	}
-	else{
-		
-	}
-}
-
-
-
-//Simple test of reading from wav file containing music and rewriting to a new wav file and txt file of the data read
-void test_wav(){
-	int NUM_CHANNELS,SAMPLE_RATE,BLOCK_SIZE;
-	NUM_CHANNELS=1;SAMPLE_RATE=48000;BLOCK_SIZE=48000;
-
-	TinyWav tw,tw1;
-	tinywav_open_read(&tw, "../data/Secrets.wav", TW_INLINE, TW_FLOAT32);
-	char * outputPath;
-    outputPath="../data/secret-test.wav"; 
-    tinywav_open_write(&tw1, NUM_CHANNELS, SAMPLE_RATE, TW_FLOAT32, TW_INLINE, outputPath);
-	int i;
-	for ( i = 0; i < 5; i++) {
-  		// samples are always presented in float32 format
-  		float samples[BLOCK_SIZE];
-  		tinywav_read_f(&tw, samples, BLOCK_SIZE);
-		if(i==0){
-			writetextf(samples,BLOCK_SIZE,"../data/secret-test", 1);	
-		}
-		tinywav_write_f(&tw1, samples, BLOCK_SIZE);
-	}
-	
-	tinywav_close_read(&tw);
-	tinywav_close_write(&tw1);
-}
-
-
+//********************************************************************
+//*                    Visual                                        *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   14/01/21                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Program to visualise captured and processed         *
+//*             sampled data for Software Defined Radio program      *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Test_Data.h>
+#include <../include/tinywav.h>
+#include <fftw3.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <gtk/gtk.h>
+#include <../include/SDR.h>
+#include <../include/Window_Cache.h>
+#include <../include/FFT_Plan.h>
+#include <../include/Waterfall.h>
+#include <../include/Resampler.h>
+#include <gtkglg.h>
+#define _GNU_SOURCE
+#include <string.h>
+
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+typedef struct Widgets {
+	GtkWidget	*window;
+	GtkWidget	*fixed;
+	GtkWidget	*menubar;
+	GtkWidget	*New;
+	GtkWidget	*Open;
+	GtkWidget	*Save;
+	GtkWidget	*Save_as;
+	GtkWidget	*Cut;
+	GtkWidget	*Copy;
+	GtkWidget	*Paste;
+	GtkWidget	*Delete;
+	GtkWidget	*FFT;
+	GtkWidget	*Spectrogram;
+	GtkWidget	*Original_Data;
+	GtkWidget	*Triangle;
+	GtkWidget	*Welch;
+	GtkWidget	*Sine;
+	GtkWidget	*Hann;
+	GtkWidget	*Hamming;
+	GtkWidget	*Blackman;
+	GtkWidget	*Gaussian;
+	GtkWidget	*No_window;
+	GtkWidget	*About;
+	GtkWidget	*Play;
+	GtkWidget	*Pause;
+	GtkWidget	*toolbar;
+	GtkWidget	*volume;
+	GtkWidget	*sampling;
+	GtkWidget	*sampling_1;
+	GtkWidget	*sampling_2;
+	GtkWidget	*sampling_3;
+	GtkBuilder  *builder;
+	GlgObject   *dataplot;
+	GtkWidget	*viewport;
+	GtkWidget	*viewport1;
+	GtkWidget	*viewport2;
+	GtkWidget	*viewport3;
+	GtkWidget	*Skip;
+	GtkWidget	*Zoom_out;
+	GtkWidget	*Zoom_in;
+	GtkWidget	*File_name;
+	GlgObject   *Glg_viewport;
+	GtkWidget   *glg;
+	GlgObject   *Glg_viewport1;
+	GtkWidget   *glg1;
+	GtkWidget   *recentchooserdialog1;
+	GtkWidget 	*Savedialog;
+	GtkFileFilter	*filter;
+	char        *filename;
+	char        *path;
+
+} Widgets;
+
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+
+#define _USE_MATH_DEFINES
+#define UPDATE_INTERVAL    50 /* millisec */ 
+#define TRACE_GLG_MESSAGES 0
+#define FFT_SIZE           4096 /* samples per analysed block */
+#define GAUSSIAN_DELTA     0.4
+#define WATERFALL_COLUMNS  1000
+#define WATERFALL_ROWS     221
+#define WATERFALL_FLOOR_DB -120.
+#define WATERFALL_RANGE_DB 120.
+#define DEFAULT_SAMPLE_RATE 44100 /* matches the sampling menu item active in the glade file */
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+GlgObject Plots[2]; 
+GlgObject Plots1[1]; 
+Widgets glade;
+bool user_edited_a_new_document=true;
+Window_Type window_choice=WINDOW_NONE;
+Waterfall waterfall;
+TinyWav waterfall_wav;
+float *waterfall_block=NULL;
+int waterfall_block_frames=0;
+guint waterfall_timer=0;
+int processing_rate=DEFAULT_SAMPLE_RATE; /* rate chosen in the sampling menu, files at other rates are resampled to it */
+Resampler waterfall_resampler;
+float *waterfall_resampled=NULL; /* one block of waterfall_block after resampling, NULL when the rates match */
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+
+void InitChartBeforeH( gpointer data,double major_interval,double minor_interval,int NUM_PLOTS, int TimeSpan,double Low, double High, GlgObject Plots[], GlgLong num_plots_in_drawing  );
+
+static gint UpdateChart( gpointer data );
+static gint Feed_Spectrogram( gpointer data );
+void spectrogram_start();
+void spectrogram_stop();
+void on_window_main_destroy();
+void select_window(Window_Type type);
+void select_sampling(int sample_rate);
+void waterfall_resampler_start();
+void waterfall_resampler_stop();
+void test_wav();
+
+//Main for running the GUI part of the program
+int main(int argc, char *argv[]) {
+	char * full_path;
+
+    gtk_init(&argc, &argv);
+	gtk_glg_toolkit_init( argc, argv );
+
+	/* Reuse FFT plans measured by earlier runs and measure any missing ones off the GUI thread. */
+	int plan_sizes[] = { FFT_SIZE };
+	fft_threads_init( 0 );
+	fft_plan_cache_init( NULL );
+	fft_plan_premeasure( plan_sizes, 1 );
+
+    glade.builder       = gtk_builder_new();
+    gtk_builder_add_from_file (glade.builder, "../GUI/sdr_window.glade", NULL);
+
+    glade.window        = GTK_WIDGET(gtk_builder_get_object(glade.builder, "window_main"));
+
+    gtk_builder_connect_signals(glade.builder, NULL);
+	
+	glade.glg           = gtk_glg_new();
+	glade.glg1          = gtk_glg_new();
+	glade.fixed         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "fixed"));
+	glade.menubar       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "menubar"));
+	glade.New           = GTK_WIDGET(gtk_builder_get_object(glade.builder, "New"));
+	glade.Open          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Open"));
+	glade.Save          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Save"));
+	glade.Save_as       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Save as"));
+	glade.Cut           = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Cut"));
+	glade.Copy          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Copy"));
+	glade.Paste         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Paste"));
+	glade.Delete        = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Delete"));
+	glade.FFT           = GTK_WIDGET(gtk_builder_get_object(glade.builder, "FFT"));
+	glade.Spectrogram   = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Spectrogram"));
+	glade.Original_Data = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Original_Data"));
+	glade.Triangle      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Triangle"));
+	glade.Welch         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Welch"));
+	glade.Sine          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Sine"));
+	glade.Hann          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Hann"));
+	glade.Hamming       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Hamming"));
+	glade.Blackman      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Blackman"));
+	glade.Gaussian      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Gaussian"));
+	glade.No_window     = GTK_WIDGET(gtk_builder_get_object(glade.builder, "No_window"));
+	glade.About         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "About"));
+	glade.Play          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Play"));
+	glade.Pause         = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Pause"));
+	glade.toolbar       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "toolbar"));
+	glade.volume        = GTK_WIDGET(gtk_builder_get_object(glade.builder, "volume"));
+	glade.sampling      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling"));
+	glade.sampling_1    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling_1"));
+	glade.sampling_2    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling_2"));
+	glade.sampling_3    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "sampling_3"));
+	glade.viewport      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport"));
+	glade.viewport1     = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport1"));
+	glade.viewport2     = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport2"));
+	glade.Skip          = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Skip"));
+	glade.Zoom_out      = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Zoom_out"));
+	glade.Zoom_in       = GTK_WIDGET(gtk_builder_get_object(glade.builder, "Zoom_in"));
+	glade.File_name    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "File_name"));
+	glade.viewport3    = GTK_WIDGET(gtk_builder_get_object(glade.builder, "viewport3"));
+	gtk_widget_set_sensitive(glade.Save ,false);
+	
+	full_path = GlgCreateRelativePath( argv[0], "../Drawings", False, False );
+  	GlgSetSResource( NULL, "$config/GlgSearchPath", full_path );
+  	GlgFree( full_path );
+
+	glade.Glg_viewport = GlgLoadWidgetFromFile( "chart2.g"  );
+	glade.Glg_viewport1 = GlgLoadWidgetFromFile( "chart11.g" );
+
+  	gtk_glg_set_viewport(glade.glg, glade.Glg_viewport   );
+	gtk_glg_set_viewport(glade.glg1, glade.Glg_viewport1 );
+  	GlgDropObject( glade.Glg_viewport );
+  	GlgDropObject( glade.Glg_viewport1);
+	
+    g_object_unref(glade.builder);
+	gtk_container_add( GTK_CONTAINER( glade.viewport  ), glade.glg  );
+	gtk_container_add( GTK_CONTAINER( glade.viewport1 ), glade.glg1 );
+
+	double num_plots_d ,num_plots_d1;
+	GlgGetDResource( glade.Glg_viewport, "Chart/NumPlots", &num_plots_d );
+	GlgGetDResource( glade.Glg_viewport1, "Chart/NumPlots", &num_plots_d1 );
+
+	InitChartBeforeH(glade.Glg_viewport,-6,-5,2,60,-1.,1.,Plots,num_plots_d );
+	InitChartBeforeH(glade.Glg_viewport1,-6,-5,1,60,0.,10000.,Plots1,num_plots_d1 );
+	gtk_label_set_text (GTK_LABEL(glade.File_name),"No wav file Chosen");
+	select_window(WINDOW_NONE);
+
+  	gtk_widget_show( glade.glg    );
+	gtk_widget_show( glade.glg1   );
+  	gtk_widget_show( glade.window );
+
+  	/* Add timer to update control panel with data. */
+  	g_timeout_add( (guint32) UPDATE_INTERVAL, UpdateChart, (gpointer) glade.Glg_viewport );  
+	g_timeout_add( (guint32) UPDATE_INTERVAL, UpdateChart, (gpointer) glade.Glg_viewport1 ); 
+
+	//----- ENTER THE GTK MAIN LOOP -----
+	gtk_main();		//Enter the GTK+ main loop until the application closes.
+
+	return 0;
+}
+
+/*----------------------------------------------------------------------
+| Initializes chart parameters before hierarchy setup occurred.
+*/
+void InitChartBeforeH( gpointer data,double major_interval,double minor_interval,int NUM_PLOTS, int TimeSpan,double Low, double High, GlgObject Plots[], GlgLong num_plots_in_drawing  ){
+   	GlgObject viewport = (GlgObject) data;
+
+   	/* Set new number of plots as needed. */
+   	GlgSetDResource( viewport, "Chart/NumPlots", NUM_PLOTS );
+
+   	/* Set Time Span for the X axis. */
+   	GlgSetDResource(  viewport, "Chart/XAxis/Span", TimeSpan );
+
+   	/* Set tick intervals for the Time axis. Positive value sets the
+      	exact interval in sec, while negative value sets the number of ticks
+      	regardless of the time span. 
+   	*/
+
+   	GlgSetDResource( viewport, "Chart/XAxis/MajorInterval", major_interval );
+   	GlgSetDResource( viewport, "Chart/XAxis/MinorInterval", minor_interval );
+
+   	/* Set data value range. Since the graph has one Y axis and
+      	common data range for the plots, Low/High data range is
+      	set on the YAxis level.
+     	*/
+   	GlgSetDResource( viewport, "Chart/YAxis/Low", Low );
+   	GlgSetDResource( viewport, "Chart/YAxis/High", High );
+
+   	GlgLong i;
+   	char *res_name;
+
+   	/* Store objects IDs for each plot. */
+   	for( i=0; i<NUM_PLOTS; ++i ){
+      	res_name = GlgCreateIndexedName( "Plot#%", i );
+      	Plots[i] = GlgGetNamedPlot( viewport, "Chart", res_name ); 
+      	GlgFree( res_name );
+   	}
+      
+   	/* For the existing plots, use color and line annotation setting 
+     	 from the drawing; initialize new plots using random colors and strings
+      	for demo purposes. 
+   	*/
+   	if( num_plots_in_drawing < NUM_PLOTS ){
+     	for( i=num_plots_in_drawing; i < NUM_PLOTS; ++i ){
+			/* Using a random color for a demo. */
+			GlgSetGResource( Plots[i], "EdgeColor", GlgRand(0., 1.), GlgRand(0., 1.), GlgRand(0., 1.) );
+			res_name = GlgCreateIndexedName( "Var%", i );
+			GlgSetSResource( Plots[i], "Annotation", res_name );
+			GlgFree( res_name );
+     	}
+	}
+}
+
+
+static gint UpdateChart( gpointer data )
+{
+   	GlgObject viewport = (GlgObject) data;
+
+	GlgUpdate( viewport );
+    GlgSync( viewport );
+   	/* Reinstall the timer */
+   	g_timeout_add( (guint32) UPDATE_INTERVAL, UpdateChart, (gpointer) viewport );   
+
+	return 0;
+}
+
+// called when window is closed
+void on_window_main_destroy(){
+    spectrogram_stop();
+    window_cache_clear();
+    fft_plan_cache_shutdown();
+    gtk_main_quit();
+}
+
+// picks the window applied before each FFT, a waterfall already running uses it from its next row on
+void select_window(Window_Type type){
+	window_choice=type;
+	if(waterfall.area!=NULL){
+		waterfall_set_window(&waterfall,type,GAUSSIAN_DELTA);
+	}
+}
+
+// sets the processing rate, a wav file already streaming to the waterfall is resampled to it from the next block on
+void select_sampling(int sample_rate){
+	processing_rate=sample_rate;
+	if(waterfall_block!=NULL){
+		waterfall_resampler_stop();
+		waterfall_resampler_start();
+	}
+}
+
+// resamples the waterfall's wav file when its rate differs from the processing rate
+void waterfall_resampler_start(){
+	int rate=waterfall_wav.h.SampleRate;
+	if(rate==processing_rate || resampler_init(&waterfall_resampler,rate,processing_rate)!=0){
+		return;
+	}
+	waterfall_resampled=(float *) malloc(resampler_max_output(&waterfall_resampler,waterfall_block_frames)*sizeof(float));
+	if(waterfall_resampled==NULL){
+		resampler_destroy(&waterfall_resampler);
+	}
+}
+
+void waterfall_resampler_stop(){
+	if(waterfall_resampled!=NULL){
+		resampler_destroy(&waterfall_resampler);
+		free(waterfall_resampled);
+		waterfall_resampled=NULL;
+	}
+}
+
+// called when Quit is clicked
+void on_Quit_activate(GtkMenuItem *menuitem){
+    spectrogram_stop();
+    window_cache_clear();
+    fft_plan_cache_shutdown();
+    gtk_main_quit();
+}
+
+// called when New is clicked
+void on_New_activate(GtkMenuItem *menuitem){
+	gtk_label_set_text (GTK_LABEL(glade.File_name),"Untitled.wav");
+	glade.filename="Untitled.wav";
+	gtk_widget_set_sensitive(glade.Save ,true);
+	glade.path="../data/";
+
+}
+
+// called when Open is clicked
+void on_Open_activate(GtkMenuItem *menuitem){
+	gtk_widget_set_sensitive(glade.Save ,true);
+	glade.recentchooserdialog1 = gtk_file_chooser_dialog_new ("Open File",GTK_WINDOW(glade.window),GTK_FILE_CHOOSER_ACTION_OPEN,"_CANCEL", GTK_RESPONSE_CANCEL,"_OPEN", GTK_RESPONSE_ACCEPT,NULL);
+	glade.filter =gtk_file_filter_new();
+    gtk_file_filter_set_name(glade.filter,"Wav Files");
+	gtk_file_filter_add_pattern(glade.filter,"*.wav");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER ( glade.recentchooserdialog1 ),glade.filter);
+	gtk_window_set_default_size(GTK_WINDOW(glade.recentchooserdialog1),100,150);
+	if (gtk_dialog_run (GTK_DIALOG ( glade.recentchooserdialog1 )) == GTK_RESPONSE_ACCEPT){
+    	char *filename;
+    	glade.filename= gtk_file_chooser_get_filename(GTK_FILE_CHOOSER ( glade.recentchooserdialog1 ));
+		filename=g_path_get_basename (glade.filename);
+		user_edited_a_new_document=false;
+		gtk_label_set_text (GTK_LABEL(glade.File_name),filename);
+		g_free (filename);
+		glade.path=g_path_get_dirname(gtk_file_chooser_get_filename(GTK_FILE_CHOOSER ( glade.recentchooserdialog1 )));
+  	}
+	
+
+	gtk_widget_destroy( glade.recentchooserdialog1 );
+}
+
+// called when Save is clicked
+void on_Save_activate(GtkMenuItem *menuitem){
+	
+	char *filename;
+	glade.Savedialog= gtk_file_chooser_dialog_new ("Save File",GTK_WINDOW(glade.window),GTK_FILE_CHOOSER_ACTION_SAVE,"_CANCEL", GTK_RESPONSE_CANCEL,"_SAVE", GTK_RESPONSE_ACCEPT,NULL);
+	glade.filter =gtk_file_filter_new();
+    gtk_file_filter_set_name(glade.filter,"Wav Files");
+	gtk_file_filter_add_pattern(glade.filter,"*.wav");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER ( glade.Savedialog),glade.filter);
+	gtk_window_set_default_size(GTK_WINDOW(glade.Savedialog),100,150);
+	gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER (glade.Savedialog),TRUE);
+	if (user_edited_a_new_document){
+  		gtk_file_chooser_set_current_name (GTK_FILE_CHOOSER (glade.Savedialog),glade.filename);
+	}
+	else{
+  		gtk_file_chooser_set_filename(GTK_FILE_CHOOSER (glade.Savedialog),glade.filename);
+	}
+	if(glade.path!=NULL){
+		gtk_file_chooser_set_current_folder (GTK_FILE_CHOOSER (glade.Savedialog),glade.path);
+	}
+	if (gtk_dialog_run (GTK_DIALOG (glade.Savedialog)) == GTK_RESPONSE_ACCEPT){
+    	glade.filename = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (glade.Savedialog));
+		filename=g_path_get_basename (glade.filename);
+		gtk_label_set_text (GTK_LABEL(glade.File_name),filename);
+    	g_free (filename);
+		user_edited_a_new_document=false;
+		glade.path=g_path_get_dirname(gtk_file_chooser_get_filename(GTK_FILE_CHOOSER ( glade.Savedialog )));
+  	}
+
+	gtk_widget_destroy ( glade.Savedialog );
+}
+
+// called when Save as is clicked
+void on_Save_as_activate(GtkMenuItem *menuitem){
+	
+}
+
+// called when Cut is clicked
+void on_Cut_activate(GtkMenuItem *menuitem){
+	
+}
+
+// called when Copy is clicked
+void on_Copy_activate(GtkMenuItem *menuitem){
+	
+}
+
+// called when Paste is clicked
+void on_Paste_activate(GtkMenuItem *menuitem){
+	
+}
+
+// called when Delete is clicked
+void on_Delete_activate(GtkMenuItem *menuitem){
+	
+}
+
+// called when FFT graph is toggled
+void on_FFT_toggled(GtkCheckMenuItem *checkmenuitem){
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(checkmenuitem));
+	if(T){
+		
+	}
+	else{
+		
+	}	
+}
+
+// called when Spectrogram graph is toggled
+void on_Spectrogram_toggled(GtkCheckMenuItem *checkmenuitem){
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(checkmenuitem));
+	if(T){
+		spectrogram_start();
+	}
+	else{
+		spectrogram_stop();
+	}	
+}
+
+// shows the waterfall in the third graph slot, 75% overlap so rows keep up with the input
+void spectrogram_start(){
+	if(waterfall_init(&waterfall,FFT_SIZE,FFT_SIZE/4,window_choice,GAUSSIAN_DELTA,WATERFALL_COLUMNS,WATERFALL_ROWS,WATERFALL_FLOOR_DB,WATERFALL_RANGE_DB)!=0){
+		return;
+	}
+	gtk_container_add(GTK_CONTAINER(glade.viewport2),waterfall.area);
+	gtk_widget_show(waterfall.area);
+
+	/* Stream the chosen wav file through the waterfall in real time. */
+	if(!user_edited_a_new_document && glade.filename!=NULL){
+		if(tinywav_open_read(&waterfall_wav,glade.filename,TW_INLINE,TW_FLOAT32)!=0){
+			waterfall_destroy(&waterfall); // nothing to show, the header sizes nothing below
+			return;
+		}
+		waterfall_block_frames=waterfall_wav.h.SampleRate*UPDATE_INTERVAL/1000;
+		waterfall_block=(float *) malloc(waterfall_block_frames*waterfall_wav.numChannels*sizeof(float));
+		if(waterfall_block==NULL){
+			tinywav_close_read(&waterfall_wav);
+			waterfall_destroy(&waterfall);
+			return;
+		}
+		waterfall_resampler_start();
+		waterfall_timer=g_timeout_add( (guint32) UPDATE_INTERVAL, Feed_Spectrogram, NULL );
+	}
+}
+
+// removes the waterfall and stops reading its wav file
+void spectrogram_stop(){
+	if(waterfall_timer!=0){
+		g_source_remove(waterfall_timer);
+		waterfall_timer=0;
+	}
+	if(waterfall_block!=NULL){
+		waterfall_resampler_stop();
+		tinywav_close_read(&waterfall_wav);
+		free(waterfall_block);
+		waterfall_block=NULL;
+	}
+	if(waterfall.area!=NULL){
+		waterfall_destroy(&waterfall);
+	}
+}
+
+// timer that feeds one interval of samples (first channel) to the waterfall, at the processing rate
+static gint Feed_Spectrogram( gpointer data ){
+	int frames=tinywav_read_f(&waterfall_wav,waterfall_block,waterfall_block_frames);
+	if(frames<=0){
+		waterfall_timer=0;
+		return FALSE;
+	}
+	if(waterfall_resampled!=NULL){
+		frames=resampler_process(&waterfall_resampler,waterfall_block,frames,waterfall_resampled);
+		waterfall_push(&waterfall,waterfall_resampled,frames);
+	}
+	else{
+		waterfall_push(&waterfall,waterfall_block,frames);
+	}
+	return TRUE;
+}
+
+// called when Data graph is toggled
+void on_Original_Data_toggled(GtkCheckMenuItem *checkmenuitem){
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(checkmenuitem));
+	if(T){
+		
+	}
+	else{
+		
+	}
+
+}
+
+// called when Triangle window is toggled
+void on_Triangle_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_TRIANGLE);
+	}
+	else{
+		
+	}
+}
+
+// called when Welch window is toggled
+void on_Welch_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_WELCH);
+	}
+	else{
+		
+	}
+}
+
+// called when Sine window is toggled
+void on_Sine_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_SINE);
+	}
+	else{
+		
+	}
+}
+
+// called when Hann window is toggled
+void on_Hann_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_HANN);
+	}
+	else{
+		
+	}
+}
+
+// called when Hamming window is toggled
+void on_Hamming_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_HAMMING);
+	}
+	else{
+		
+	}
+}
+
+// called when Blackman window is toggled
+void on_Blackman_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_BLACKMAN);
+	}
+	else{
+		
+	}
+}
+
+// called when Gaussian window is toggled
+void on_Gaussian_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_GAUSSIAN);
+	}
+	else{
+		
+	}
+}
+
+// called when Uniform window is toggled
+void on_No_window_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_window(WINDOW_NONE);
+	}
+	else{
+		
+	}
+}
+
+// called when About button is clicked
+void on_About_activate(GtkMenuItem *menuitem){
+	
+}
+
+// called when Pause tool is clicked
+void on_Pause_toggled(GtkToolItem *toolitem){
+	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
+	if(T){
+		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Play),False);
+	}
+	else{
+		
+	}
+}
+
+// called when Play tool is clicked
+void on_Play_toggled(GtkToolItem *toolitem){
+	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
+	if(T){
+		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Pause),False);
+	}
+	else{
+		
+	}	
+}
+
+// called when Skip tool is clicked
+void on_Skip_toggled(GtkToolItem *toolitem){
+	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
+	if(T){
+
+	}
+	else{
+		
+	}	
+}
+
+// called when Zoom out tool is clicked
+void on_Zoom_out_toggled(GtkToolItem *toolitem){
+	gboolean T = gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
+	if(T){
+		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Zoom_in),False);
+	}
+	else{
+		
+	}	
+}
+
+// called when Zoom in tool is clicked
+void on_Zoom_in_toggled(GtkToolItem *toolitem){
+	gboolean T =gtk_toggle_tool_button_get_active(GTK_TOGGLE_TOOL_BUTTON(toolitem));
+	if(T){
+		gtk_toggle_tool_button_set_active(GTK_TOGGLE_TOOL_BUTTON(glade.Zoom_out),False);
+	}
+	else{
+		
+	}	
+}
+
+// called when Volume is clicked
+void on_volume_value_changed(GtkVolumeButton *volume){
+	gdouble scale=gtk_scale_button_get_value(GTK_SCALE_BUTTON(volume));
+	
+}
+
+// called when sampling is set to 44.1 KHz
+void on_sampling_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_sampling(44100);
+	}
+	else{
+		
+	}
+}
+
+// called when sampling is set to 48 KHz
+void on_sampling_1_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_sampling(48000);
+	}
+	else{
+		
+	}
+}
+
+// called when sampling is set to 88.2 KHz
+void on_sampling_2_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_sampling(88200);
+	}
+	else{
+		
+	}
+}
+
+// called when sampling is set to 96 KHz
+void on_sampling_3_toggled(GtkRadioMenuItem *radio) {
+	gboolean T = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(radio));
+	if(T){
+		select_sampling(96000);
+	}
+	else{
+		
+	}
+}
+
+
+
+//Simple test of reading from wav file containing music and rewriting to a new wav file and txt file of the data read
+void test_wav(){
+	int NUM_CHANNELS,SAMPLE_RATE,BLOCK_SIZE;
+	NUM_CHANNELS=1;SAMPLE_RATE=48000;BLOCK_SIZE=48000;
+
+	TinyWav tw,tw1;
+	if(tinywav_open_read(&tw, "../data/Secrets.wav", TW_INLINE, TW_FLOAT32)!=0){
+		return;
+	}
+	char * outputPath;
+    outputPath="../data/secret-test.wav"; 
+    tinywav_open_write(&tw1, NUM_CHANNELS, SAMPLE_RATE, TW_FLOAT32, TW_INLINE, outputPath);
+	int i;
+	for ( i = 0; i < 5; i++) {
+  		// samples are always presented in float32 format
+  		float samples[BLOCK_SIZE];
+  		tinywav_read_f(&tw, samples, BLOCK_SIZE);
+		if(i==0){
+			writetextf(samples,BLOCK_SIZE,"../data/secret-test", 1);	
+		}
+		tinywav_write_f(&tw1, samples, BLOCK_SIZE);
+	}
+	
+	tinywav_close_read(&tw);
+	tinywav_close_write(&tw1);
+}
+
+
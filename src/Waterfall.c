@@ -0,0 +1,236 @@
+//********************************************************************
+//*                    Waterfall                                     *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Scrolling spectrogram that adds one texture row per *
+//*             STFT frame instead of redrawing the whole history    *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/Waterfall.h>
+#include <../include/STFT.h>
+#include <gtk/gtk.h>
+#include <math.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define POWER_FLOOR 1e-20f //keeps log10 away from zero
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int waterfall_init(Waterfall *wf, int fft_size, int hop, Window_Type window, float parameter,
+                   int columns, int rows, float floor_db, float range_db);
+
+void waterfall_push(Waterfall *wf, const float samples[], int N);
+
+int waterfall_set_window(Waterfall *wf, Window_Type window, float parameter);
+
+void waterfall_destroy(Waterfall *wf);
+
+static void waterfall_norm(Waterfall *wf);
+
+static void waterfall_add_row(const fftwf_complex spectrum[], int bins, void *user);
+
+static gboolean waterfall_draw(GtkWidget *widget, cairo_t *cr, gpointer data);
+
+static void waterfall_palette(guint32 palette[256]);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Creates the texture, palette, STFT and drawing area
+int waterfall_init(Waterfall *wf, int fft_size, int hop, Window_Type window, float parameter,
+                   int columns, int rows, float floor_db, float range_db){
+
+    int i;
+
+    memset(wf,0,sizeof(Waterfall));
+    if (rows<1){
+        return -1;
+    }
+    if (stft_init(&wf->stft,fft_size,hop,window,parameter)!=0){
+        return -1;
+    }
+    wf->bins=wf->stft.bins;
+    if (columns<1 || columns>wf->bins){
+        columns=wf->bins;
+    }
+    wf->columns=columns;
+    wf->rows=rows;
+    wf->row=0;
+    wf->floor_db=floor_db;
+    wf->range_db=range_db>0 ? range_db : 1;
+    waterfall_norm(wf);
+
+    wf->texture=cairo_image_surface_create(CAIRO_FORMAT_RGB24,columns,rows);
+    if (cairo_surface_status(wf->texture)!=CAIRO_STATUS_SUCCESS){
+        cairo_surface_destroy(wf->texture);
+        stft_destroy(&wf->stft);
+        return -1;
+    }
+    waterfall_palette(wf->palette);
+    cairo_surface_flush(wf->texture);
+    for (i=0;i<rows;i++){
+        guint32 *line=(guint32 *)(cairo_image_surface_get_data(wf->texture)+i*cairo_image_surface_get_stride(wf->texture));
+        int c;
+        for (c=0;c<columns;c++){
+            line[c]=wf->palette[0];
+        }
+    }
+    cairo_surface_mark_dirty(wf->texture);
+
+    wf->area=gtk_drawing_area_new();
+    g_object_ref_sink(wf->area);
+    g_signal_connect(G_OBJECT(wf->area),"draw",G_CALLBACK(waterfall_draw),wf);
+    return 0;
+}
+
+//Runs samples through the STFT and asks for one redraw for however many rows arrived
+void waterfall_push(Waterfall *wf, const float samples[], int N){
+
+    stft_push(&wf->stft,samples,N,waterfall_add_row,wf);
+    if (wf->dirty){
+        wf->dirty=FALSE;
+        gtk_widget_queue_draw(wf->area);
+    }
+}
+
+//Swaps the STFT's window and rescales the levels for its coherent gain
+int waterfall_set_window(Waterfall *wf, Window_Type window, float parameter){
+
+    if (stft_set_window(&wf->stft,window,parameter)!=0){
+        return -1;
+    }
+    waterfall_norm(wf);
+    return 0;
+}
+
+//Releases the widget, texture and STFT
+void waterfall_destroy(Waterfall *wf){
+
+    if (wf->area!=NULL){
+        gtk_widget_destroy(wf->area);
+        g_object_unref(wf->area);
+    }
+    if (wf->texture!=NULL){
+        cairo_surface_destroy(wf->texture);
+    }
+    stft_destroy(&wf->stft);
+    memset(wf,0,sizeof(Waterfall));
+}
+
+//One sided amplitude, a full scale sine peaks at 0 dB whatever the window
+static void waterfall_norm(Waterfall *wf){
+
+    double gain=0;
+    int i;
+    for (i=0;i<wf->stft.frame_size;i++){
+        gain+=wf->stft.window[i];
+    }
+    wf->norm=(float)(4/(gain*gain));
+}
+
+//STFT callback, turns one spectrum into one texture row above the previous newest row
+static void waterfall_add_row(const fftwf_complex spectrum[], int bins, void *user){
+
+    Waterfall *wf=(Waterfall *) user;
+    guint32 *line;
+    int c;
+    float scale=255/wf->range_db;
+
+    wf->row=(wf->row+wf->rows-1)%wf->rows;
+    cairo_surface_flush(wf->texture);
+    line=(guint32 *)(cairo_image_surface_get_data(wf->texture)+wf->row*cairo_image_surface_get_stride(wf->texture));
+
+    for (c=0;c<wf->columns;c++){
+        int first=(int)((long)c*bins/wf->columns);
+        int last=(int)((long)(c+1)*bins/wf->columns);
+        float peak=POWER_FLOOR;
+        float level;
+        int k,index;
+        if (last<=first){
+            last=first+1;
+        }
+        //max pool in the power domain so only one log is taken per column
+        for (k=first;k<last;k++){
+            float p=spectrum[k][0]*spectrum[k][0]+spectrum[k][1]*spectrum[k][1];
+            if (p>peak){
+                peak=p;
+            }
+        }
+        level=10*log10f(peak*wf->norm);
+        index=(int)((level-wf->floor_db)*scale);
+        if (index<0){
+            index=0;
+        }
+        if (index>255){
+            index=255;
+        }
+        line[c]=wf->palette[index];
+    }
+    cairo_surface_mark_dirty_rectangle(wf->texture,0,wf->row,wf->columns,1);
+    wf->dirty=TRUE;
+}
+
+//Blits the ring texture in two pieces so the newest row is at the top, nothing is recomputed
+static gboolean waterfall_draw(GtkWidget *widget, cairo_t *cr, gpointer data){
+
+    Waterfall *wf=(Waterfall *) data;
+    int width=gtk_widget_get_allocated_width(widget);
+    int height=gtk_widget_get_allocated_height(widget);
+    int older=wf->rows-wf->row;
+
+    cairo_save(cr);
+    cairo_scale(cr,(double)width/wf->columns,(double)height/wf->rows);
+
+    cairo_set_source_surface(cr,wf->texture,0,-wf->row);
+    cairo_pattern_set_filter(cairo_get_source(cr),CAIRO_FILTER_FAST);
+    cairo_rectangle(cr,0,0,wf->columns,older);
+    cairo_fill(cr);
+
+    if (wf->row>0){
+        cairo_set_source_surface(cr,wf->texture,0,older);
+        cairo_pattern_set_filter(cairo_get_source(cr),CAIRO_FILTER_FAST);
+        cairo_rectangle(cr,0,older,wf->columns,wf->row);
+        cairo_fill(cr);
+    }
+    cairo_restore(cr);
+    return FALSE;
+}
+
+//Black, blue, cyan, yellow, red, white colour scale for the dB levels
+static void waterfall_palette(guint32 palette[256]){
+
+    static const float stops[6][3]={{0,0,0},{0,0,1},{0,1,1},{1,1,0},{1,0,0},{1,1,1}};
+    int i;
+    for (i=0;i<256;i++){
+        float x=i*5/255.0f;
+        int s=(int)x;
+        float f;
+        guint32 r,g,b;
+        if (s>4){
+            s=4;
+        }
+        f=x-s;
+        r=(guint32)(255*(stops[s][0]+f*(stops[s+1][0]-stops[s][0])));
+        g=(guint32)(255*(stops[s][1]+f*(stops[s+1][1]-stops[s][1])));
+        b=(guint32)(255*(stops[s][2]+f*(stops[s+1][2]-stops[s][2])));
+        palette[i]=(r<<16)|(g<<8)|b;
+    }
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
@@ -0,0 +1,308 @@
+//********************************************************************
+//*                    Wav Writer                                    *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Wav file writer that hands blocks to a background   *
+//*             thread so recording never waits on the disk          *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+#define _GNU_SOURCE //O_DIRECT
+
+#include <../include/Wav_Writer.h>
+#include <../include/Vector_Ops.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define WAV_WRITER_BLOCK_BYTES (1<<20) //bytes per disk write
+#define WAV_WRITER_ALIGN       4096    //O_DIRECT buffer, offset and length alignment
+#define WAV_WRITER_CHUNK       4096    //samples encoded per pass on the caller's thread
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+int wav_writer_open(Wav_Writer *ww, const char *path, int16_t numChannels, int32_t samplerate,
+                    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt, int direct);
+
+int wav_writer_write(Wav_Writer *ww, const void *data, int len);
+
+int wav_writer_close(Wav_Writer *ww);
+
+static const uint8_t *wav_writer_encode(Wav_Writer *ww, const void *data, int len, int done, int frames,
+                                        float scratch[], uint8_t raw[]);
+
+static void wav_writer_queue(Wav_Writer *ww, const uint8_t bytes[], size_t N);
+
+static void *wav_writer_thread(void *arg);
+
+static int write_all(int fd, const uint8_t *buffer, size_t N, uint64_t offset);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Opens the file, allocates the aligned blocks, queues the header and starts the writer thread
+int wav_writer_open(Wav_Writer *ww, const char *path, int16_t numChannels, int32_t samplerate,
+                    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt, int direct){
+
+    int i;
+
+    memset(ww,0,sizeof(Wav_Writer));
+    ww->fd=-1;
+    if (numChannels<1 || numChannels>WAV_WRITER_CHUNK || tinywav_sample_bytes(sampFmt)==0){
+        return -1;
+    }
+    ww->numChannels=numChannels;
+    ww->sampFmt=sampFmt;
+    ww->chanFmt=chanFmt;
+    ww->frame_bytes=numChannels*tinywav_sample_bytes(sampFmt);
+    ww->block_bytes=WAV_WRITER_BLOCK_BYTES;
+
+    ww->direct= direct && O_DIRECT!=0;
+    ww->fd=open(path,O_WRONLY|O_CREAT|O_TRUNC|(ww->direct ? O_DIRECT : 0),0644);
+    if (ww->fd<0 && ww->direct && errno==EINVAL){ //tmpfs and some network filesystems refuse O_DIRECT
+        ww->direct=0;
+        ww->fd=open(path,O_WRONLY|O_CREAT|O_TRUNC,0644);
+    }
+    if (ww->fd<0){
+        return -1;
+    }
+    for (i=0;i<WAV_WRITER_BLOCKS;i++){
+        void *block;
+        if (posix_memalign(&block,WAV_WRITER_ALIGN,ww->block_bytes)!=0){
+            wav_writer_close(ww);
+            return -1;
+        }
+        ww->blocks[i]=(uint8_t *) block;
+        memset(block,0,ww->block_bytes); //fault the pages in now rather than on the recording thread
+    }
+    if (sem_init(&ww->ready,0,0)!=0){
+        wav_writer_close(ww);
+        return -1;
+    }
+
+    //the header goes out with the first block, its sizes are patched on close
+    tinywav_header(&ww->header,numChannels,samplerate,sampFmt);
+    memcpy(ww->blocks[0],&ww->header,sizeof(TinyWavHeader));
+    ww->fill=sizeof(TinyWavHeader);
+
+    if (pthread_create(&ww->thread,NULL,wav_writer_thread,ww)!=0){
+        sem_destroy(&ww->ready);
+        wav_writer_close(ww);
+        return -1;
+    }
+    ww->running=1;
+    return 0;
+}
+
+//Encodes frames straight into the queue blocks, never blocks, drops what does not fit
+int wav_writer_write(Wav_Writer *ww, const void *data, int len){
+
+    float scratch[WAV_WRITER_CHUNK];
+    uint8_t raw[WAV_WRITER_CHUNK*4];
+    int chunk=WAV_WRITER_CHUNK/ww->numChannels;
+    int done=0;
+
+    while (done<len){
+        int frames= len-done<chunk ? len-done : chunk;
+        unsigned long tail=__atomic_load_n(&ww->tail,__ATOMIC_ACQUIRE);
+        uint64_t space=(uint64_t)(WAV_WRITER_BLOCKS-(ww->head-tail))*ww->block_bytes-ww->fill;
+        const uint8_t *bytes;
+
+        if ((uint64_t)frames*ww->frame_bytes>space){
+            frames=(int)(space/ww->frame_bytes);
+            if (frames==0){
+                break;
+            }
+        }
+        bytes=wav_writer_encode(ww,data,len,done,frames,scratch,raw);
+        wav_writer_queue(ww,bytes,(size_t)frames*ww->frame_bytes);
+        done+=frames;
+    }
+
+    ww->frames+=done;
+    ww->data_bytes+=(uint64_t)done*ww->frame_bytes;
+    ww->dropped+=len-done;
+    return done;
+}
+
+//Queues the last part block, waits for the thread and patches the header sizes
+int wav_writer_close(Wav_Writer *ww){
+
+    int i;
+    int error=0;
+
+    if (ww->running){
+        if (ww->fill>0){
+            ww->used[ww->head%WAV_WRITER_BLOCKS]=ww->fill;
+            __atomic_store_n(&ww->head,ww->head+1,__ATOMIC_RELEASE);
+            ww->fill=0;
+        }
+        __atomic_store_n(&ww->stop,1,__ATOMIC_RELEASE);
+        sem_post(&ww->ready);
+        pthread_join(ww->thread,NULL);
+        sem_destroy(&ww->ready);
+        error=ww->error;
+    }
+
+    if (ww->fd>=0){
+        //a pad byte keeps odd sized data chunks even
+        uint64_t total=sizeof(TinyWavHeader)+ww->data_bytes+(ww->data_bytes&1);
+        if (ww->direct){
+            //the header patch is not block sized, and the padded last block is cut back to the data
+            fcntl(ww->fd,F_SETFL,fcntl(ww->fd,F_GETFL)&~O_DIRECT);
+        }
+        if (ftruncate(ww->fd,(off_t) total)!=0){
+            error=-1;
+        }
+        //past 4 GB the JUNK placeholder becomes the ds64 chunk, nothing has to move
+        tinywav_header_sizes(&ww->header,ww->data_bytes);
+        if (pwrite(ww->fd,&ww->header,sizeof(TinyWavHeader),0)!=sizeof(TinyWavHeader)){
+            error=-1;
+        }
+        if (close(ww->fd)!=0){
+            error=-1;
+        }
+    }
+    for (i=0;i<WAV_WRITER_BLOCKS;i++){
+        free(ww->blocks[i]);
+    }
+    memset(ww,0,sizeof(Wav_Writer));
+    ww->fd=-1;
+    return error;
+}
+
+//Interleaves and converts one chunk of frames, returns the file bytes
+static const uint8_t *wav_writer_encode(Wav_Writer *ww, const void *data, int len, int done, int frames,
+                                        float scratch[], uint8_t raw[]){
+
+    const float *in[WAV_WRITER_CHUNK];
+    const float *x=scratch;
+    int channels=ww->numChannels;
+    int samples=frames*channels;
+    int c;
+
+    switch (ww->chanFmt){
+        case TW_INTERLEAVED:
+            x=(const float *) data+(size_t)done*channels;
+            break;
+        case TW_INLINE:
+            for (c=0;c<channels;c++){
+                in[c]=(const float *) data+(size_t)c*len+done;
+            }
+            vector_interleave(in,scratch,channels,frames);
+            break;
+        case TW_SPLIT:
+            for (c=0;c<channels;c++){
+                in[c]=((const float *const *) data)[c]+done;
+            }
+            vector_interleave(in,scratch,channels,frames);
+            break;
+    }
+
+    switch (ww->sampFmt){
+        case TW_INT16:
+            vector_float_to_s16(x,(int16_t *) raw,samples);
+            break;
+        case TW_INT24:
+            vector_float_to_s24(x,raw,samples);
+            break;
+        case TW_INT32:
+            vector_float_to_s32(x,(int32_t *) raw,samples);
+            break;
+        case TW_FLOAT32:
+            return (const uint8_t *) x;
+    }
+    return raw;
+}
+
+//Copies bytes into the open block, handing each block to the thread as it fills. The caller checked there is room.
+static void wav_writer_queue(Wav_Writer *ww, const uint8_t bytes[], size_t N){
+
+    while (N>0){
+        int index=ww->head%WAV_WRITER_BLOCKS;
+        size_t take=ww->block_bytes-ww->fill;
+        if (take>N){
+            take=N;
+        }
+        memcpy(ww->blocks[index]+ww->fill,bytes,take);
+        ww->fill+=take;
+        bytes+=take;
+        N-=take;
+
+        if (ww->fill==ww->block_bytes){
+            ww->used[index]=ww->block_bytes;
+            __atomic_store_n(&ww->head,ww->head+1,__ATOMIC_RELEASE);
+            sem_post(&ww->ready);
+            ww->fill=0;
+        }
+    }
+}
+
+//Writes queued blocks in order until told to stop and the queue is empty
+static void *wav_writer_thread(void *arg){
+
+    Wav_Writer *ww=(Wav_Writer *) arg;
+    uint64_t offset=0;
+
+    for (;;){
+        unsigned long head;
+        sem_wait(&ww->ready);
+        head=__atomic_load_n(&ww->head,__ATOMIC_ACQUIRE);
+        while (ww->tail!=head){
+            int index=ww->tail%WAV_WRITER_BLOCKS;
+            size_t N=ww->used[index];
+            size_t length=N;
+            if (ww->direct){ //only the last block is short, write it padded and truncate on close
+                length=(N+WAV_WRITER_ALIGN-1)&~(size_t)(WAV_WRITER_ALIGN-1);
+            }
+            if (!ww->error && write_all(ww->fd,ww->blocks[index],length,offset)!=0){
+                ww->error=-1;
+            }
+            offset+=N;
+            __atomic_store_n(&ww->tail,ww->tail+1,__ATOMIC_RELEASE);
+        }
+        if (__atomic_load_n(&ww->stop,__ATOMIC_ACQUIRE) && ww->tail==__atomic_load_n(&ww->head,__ATOMIC_ACQUIRE)){
+            break;
+        }
+    }
+    return NULL;
+}
+
+//pwrite until everything is written, retrying short writes and interruptions
+static int write_all(int fd, const uint8_t *buffer, size_t N, uint64_t offset){
+
+    while (N>0){
+        ssize_t n=pwrite(fd,buffer,N,(off_t) offset);
+        if (n<0){
+            if (errno==EINTR){
+                continue;
+            }
+            return -1;
+        }
+        buffer+=n;
+        N-=(size_t) n;
+        offset+=(uint64_t) n;
+    }
+    return 0;
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
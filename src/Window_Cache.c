@@ -0,0 +1,200 @@
+//********************************************************************
+//*                    Window Cache                                  *
+//*==================================================================*
+//* WRITTEN BY: Liam McEvoy    	                 		             *
+//* DATE CREATED:   17/10/26                                         *
+//* MODIFIED:                                                        *
+//*==================================================================*
+//* PROGRAMMED IN: Visual Studio                                     *
+//*==================================================================*
+//* DESCRIPTION: Registry of precomputed window tables so windows    *
+//*             are built once and shared by the GUI and pipelines   *
+//********************************************************************
+// INCLUDE FILES
+//====================================================================
+
+#include <../include/tinywav.h>
+#include <../include/SDR.h>
+#include <../include/Window_Cache.h>
+#include <../include/Vector_Ops.h>
+#include <fftw3.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+//====================================================================
+// SYMBOLIC CONSTANTS
+//====================================================================
+#define WINDOW_CACHE_BUCKETS 64
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+typedef struct Window_Entry {
+    Window_Type type;
+    int window_size;
+    float parameter;
+    float *table;
+    float *inverse;   // built on first request for it
+    struct Window_Entry *next;
+} Window_Entry;
+
+//====================================================================
+// GLOBAL VARIABLES
+//====================================================================
+static Window_Entry *window_buckets[WINDOW_CACHE_BUCKETS];
+static pthread_mutex_t window_lock = PTHREAD_MUTEX_INITIALIZER;
+//====================================================================
+// FUNCTION DECLARATIONS
+//====================================================================
+const float *window_cache_get(Window_Type type, int window_size, float parameter);
+
+const float *window_cache_get_inverse(Window_Type type, int window_size, float parameter);
+
+int window_cache_copy(Window_Type type, int window_size, float parameter, float data[]);
+
+void window_cache_clear(void);
+
+static Window_Entry *window_lookup(Window_Type type, int window_size, float parameter);
+
+static unsigned window_hash(Window_Type type, int window_size, float parameter);
+
+static int window_build(Window_Type type, int window_size, float parameter, float table[]);
+
+//====================================================================
+// FUNCTION DEFINITIONS
+//====================================================================
+
+//Looks up a window table, building it with the SDR window functions the first time it is asked for
+const float *window_cache_get(Window_Type type, int window_size, float parameter){
+
+    Window_Entry *entry;
+
+    pthread_mutex_lock(&window_lock);
+    entry=window_lookup(type,window_size,parameter);
+    pthread_mutex_unlock(&window_lock);
+
+    return entry!=NULL ? entry->table : NULL;
+}
+
+//Looks up the reciprocal of a window table, building it from the cached window the first time
+const float *window_cache_get_inverse(Window_Type type, int window_size, float parameter){
+
+    Window_Entry *entry;
+
+    pthread_mutex_lock(&window_lock);
+    entry=window_lookup(type,window_size,parameter);
+    if (entry!=NULL && entry->inverse==NULL){
+        float *inverse = (float *) fftwf_malloc((window_size+1)*sizeof(float));
+        if (inverse!=NULL){
+            vector_reciprocal(entry->table,inverse,window_size+1);
+            entry->inverse=inverse;
+        }
+    }
+    pthread_mutex_unlock(&window_lock);
+
+    return entry!=NULL ? entry->inverse : NULL;
+}
+
+//Copies a cached window into a caller owned array, a drop in for the SDR window functions
+int window_cache_copy(Window_Type type, int window_size, float parameter, float data[]){
+
+    const float *table = window_cache_get(type,window_size,parameter);
+    if (table==NULL){
+        return -1;
+    }
+    memcpy(data,table,(window_size+1)*sizeof(float));
+    return 0;
+}
+
+//Finds or creates the cache entry for a key, called with window_lock held
+static Window_Entry *window_lookup(Window_Type type, int window_size, float parameter){
+
+    Window_Entry *entry;
+    unsigned bucket;
+
+    if (window_size<0){
+        return NULL;
+    }
+    if (type!=WINDOW_GAUSSIAN && type!=WINDOW_KAISER){ //only the Gaussian and Kaiser windows are shaped by their parameter
+        parameter=0;
+    }
+    bucket=window_hash(type,window_size,parameter);
+
+    for (entry=window_buckets[bucket];entry!=NULL;entry=entry->next){
+        if (entry->type==type && entry->window_size==window_size && entry->parameter==parameter){
+            return entry;
+        }
+    }
+
+    entry = (Window_Entry *) malloc(sizeof(Window_Entry));
+    if (entry==NULL){
+        return NULL;
+    }
+    entry->table = (float *) fftwf_malloc((window_size+1)*sizeof(float));
+    if (entry->table==NULL || window_build(type,window_size,parameter,entry->table)!=0){
+        fftwf_free(entry->table);
+        free(entry);
+        return NULL;
+    }
+    entry->inverse=NULL;
+    entry->type=type;
+    entry->window_size=window_size;
+    entry->parameter=parameter;
+    entry->next=window_buckets[bucket];
+    window_buckets[bucket]=entry;
+
+    return entry;
+}
+
+//Releases every cached window table
+void window_cache_clear(void){
+
+    int i;
+    pthread_mutex_lock(&window_lock);
+    for (i=0;i<WINDOW_CACHE_BUCKETS;i++){
+        Window_Entry *entry=window_buckets[i];
+        while (entry!=NULL){
+            Window_Entry *next=entry->next;
+            fftwf_free(entry->table);
+            fftwf_free(entry->inverse);
+            free(entry);
+            entry=next;
+        }
+        window_buckets[i]=NULL;
+    }
+    pthread_mutex_unlock(&window_lock);
+}
+
+//Spreads (type, size, parameter) keys over the cache buckets
+static unsigned window_hash(Window_Type type, int window_size, float parameter){
+
+    unsigned bits;
+    memcpy(&bits,&parameter,sizeof(bits));
+    return ((unsigned)type*31u + (unsigned)window_size*2654435761u + bits) % WINDOW_CACHE_BUCKETS;
+}
+
+//Fills a table with the requested window using the existing SDR window functions
+static int window_build(Window_Type type, int window_size, float parameter, float table[]){
+
+    int i;
+    switch (type){
+        case WINDOW_NONE:
+            for (i=0;i<=window_size;i++){
+                table[i]=1;
+            }
+            return 0;
+        case WINDOW_TRIANGLE: return triangle(window_size,table);
+        case WINDOW_WELCH:    return Welch(window_size,table);
+        case WINDOW_SINE:     return Sine(window_size,table);
+        case WINDOW_HANN:     return Hann(window_size,table);
+        case WINDOW_HAMMING:  return Hamming(window_size,table);
+        case WINDOW_BLACKMAN: return Blackman(window_size,table);
+        case WINDOW_GAUSSIAN: return Gaussian(window_size,table,parameter);
+        case WINDOW_KAISER:   return Kaiser(window_size,table,parameter);
+        default:              return -1;
+    }
+}
+
+//********************************************************************
+// END OF PROGRAM
+//********************************************************************
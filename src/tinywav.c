@@ -1,258 +1,444 @@
-/**
- * Copyright (c) 2015-2017, Martin Roth (mhroth@gmail.com)
- *
- * Permission to use, copy, modify, and/or distribute this software for any
- * purpose with or without fee is hereby granted, provided that the above
- * copyright notice and this permission notice appear in all copies.
- *
- * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
- * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
- * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
- * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
- * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
- * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
- * PERFORMANCE OF THIS SOFTWARE.
- */
-
-
-
-#include <assert.h>
-#include <string.h>
-#if _WIN32
-#include <winsock2.h>
-#include <malloc.h>
-#else
-#include <alloca.h>
-#include <netinet/in.h>
-#endif
-#include <../include/tinywav.h>
-
-int tinywav_open_write(TinyWav *tw,
-    int16_t numChannels, int32_t samplerate,
-    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt,
-    const char *path) {
-#if _WIN32
-  errno_t err = fopen_s(&tw->f, path, "w");
-  assert(err == 0);
-#else
-  tw->f = fopen(path, "w");
-#endif
-  assert(tw->f != NULL);
-  tw->numChannels = numChannels;
-  tw->totalFramesWritten = 0;
-  tw->sampFmt = sampFmt;
-  tw->chanFmt = chanFmt;
-
-  // prepare WAV header
-  TinyWavHeader h;
-  h.ChunkID = htonl(0x52494646); // "RIFF"
-  h.ChunkSize = 0; // fill this in on file-close
-  h.Format = htonl(0x57415645); // "WAVE"
-  h.Subchunk1ID = htonl(0x666d7420); // "fmt "
-  h.Subchunk1Size = 16; // PCM
-  h.AudioFormat = (tw->sampFmt-1); // 1 PCM, 3 IEEE float
-  h.NumChannels = numChannels;
-  h.SampleRate = samplerate;
-  h.ByteRate = samplerate * numChannels * tw->sampFmt;
-  h.BlockAlign = numChannels * tw->sampFmt;
-  h.BitsPerSample = 8*tw->sampFmt;
-  h.Subchunk2ID = htonl(0x64617461); // "data"
-  h.Subchunk2Size = 0; // fill this in on file-close
-
-  // write WAV header
-  fwrite(&h, sizeof(TinyWavHeader), 1, tw->f);
-
-  return 0;
-}
-
-int tinywav_open_read(TinyWav *tw, const char *path, TinyWavChannelFormat chanFmt, TinyWavSampleFormat sampFmt) {
-  tw->f = fopen(path, "rb");
-  assert(tw->f != NULL);
-  
-  size_t ret = fread(&tw->h, sizeof(TinyWavHeader), 1, tw->f);
-  assert(ret > 0);
-  assert(tw->h.ChunkID == htonl(0x52494646));        // "RIFF"
-  assert(tw->h.Format == htonl(0x57415645));         // "WAVE"
-  assert(tw->h.Subchunk1ID == htonl(0x666d7420));    // "fmt "
-  
-  // skip over any other chunks before the "data" chunk
-  while (tw->h.Subchunk2ID != htonl(0x64617461)) {   // "data"
-    fseek(tw->f, 4, SEEK_CUR);
-    fread(&tw->h.Subchunk2ID, 4, 1, tw->f);
-  }
-  assert(tw->h.Subchunk2ID == htonl(0x64617461));    // "data"
-  fread(&tw->h.Subchunk2Size, 4, 1, tw->f);
-  
-  tw->numChannels = tw->h.NumChannels;
-  tw->chanFmt = chanFmt;
-  tw->sampFmt = sampFmt;
-  
-  tw->totalFramesWritten = tw->h.Subchunk2Size / (tw->numChannels * tw->sampFmt);
-  return 0;
-}
-
-int tinywav_read_f(TinyWav *tw, void *data, int len) { // returns number of frames read
-  switch (tw->sampFmt) {
-    case TW_INT16: { //TODO(gio): implement TW_INT16 conversion
-      int16_t *z = (int16_t *) alloca(tw->numChannels*len*sizeof(int16_t));
-      switch (tw->chanFmt) {
-        case TW_INTERLEAVED: {
-          const float *const x = (const float *const) data;
-          for (int i = 0; i < tw->numChannels*len; ++i) {
-            z[i] = (int16_t) (x[i] * 32767.0f);
-          }
-          break;
-        }
-        case TW_INLINE: {
-          const float *const x = (const float *const) data;
-          for (int i = 0, k = 0; i < len; ++i) {
-            for (int j = 0; j < tw->numChannels; ++j) {
-              z[k++] = (int16_t) (x[j*len+i] * 32767.0f);
-            }
-          }
-          break;
-        }
-        case TW_SPLIT: {
-          const float **const x = (const float **const) data;
-          for (int i = 0, k = 0; i < len; ++i) {
-            for (int j = 0; j < tw->numChannels; ++j) {
-              z[k++] = (int16_t) (x[j][i] * 32767.0f);
-            }
-          }
-          break;
-        }
-        default: return 0;
-      }
-      
-      tw->totalFramesWritten += len;
-      return (int) fwrite(z, sizeof(int16_t), tw->numChannels*len, tw->f);
-    }
-    case TW_FLOAT32: {
-      size_t samples_read = 0;
-      float *interleaved_data = (float *) alloca(tw->numChannels*len*sizeof(float));
-      samples_read = fread(interleaved_data, sizeof(float), tw->numChannels*len, tw->f);
-      switch (tw->chanFmt) {
-        case TW_INTERLEAVED: { // channel buffer is interleaved e.g. [LRLRLRLR]
-          memcpy(data, interleaved_data, tw->numChannels*len*sizeof(float));
-          return (int) (samples_read/tw->numChannels);
-        }
-        case TW_INLINE: { // channel buffer is inlined e.g. [LLLLRRRR]
-          for (int i = 0, pos = 0; i < tw->numChannels; i++) {
-            for (int j = i; j < len * tw->numChannels; j += tw->numChannels, ++pos) {
-              ((float *) data)[pos] = interleaved_data[j];
-            }
-          }
-          return (int) (samples_read/tw->numChannels);
-        }
-        case TW_SPLIT: { // channel buffer is split e.g. [[LLLL],[RRRR]]
-          for (int i = 0, pos = 0; i < tw->numChannels; i++) {
-            for (int j = 0; j < len; j++, ++pos) {
-              ((float **) data)[i][j] = interleaved_data[j*tw->numChannels + i];
-            }
-          }
-          return (int) (samples_read/tw->numChannels);
-        }
-        default: return 0;
-      }
-    }
-    default: return 0;
-  }
-
-  return len;
-}
-
-void tinywav_close_read(TinyWav *tw) {
-  fclose(tw->f);
-  tw->f = NULL;
-}
-
-size_t tinywav_write_f(TinyWav *tw, void *f, int len) {
-  switch (tw->sampFmt) {
-    case TW_INT16: {
-      int16_t *z = (int16_t *) alloca(tw->numChannels*len*sizeof(int16_t));
-      switch (tw->chanFmt) {
-        case TW_INTERLEAVED: {
-          const float *const x = (const float *const) f;
-          for (int i = 0; i < tw->numChannels*len; ++i) {
-            z[i] = (int16_t) (x[i] * 32767.0f);
-          }
-          break;
-        }
-        case TW_INLINE: {
-          const float *const x = (const float *const) f;
-          for (int i = 0, k = 0; i < len; ++i) {
-            for (int j = 0; j < tw->numChannels; ++j) {
-              z[k++] = (int16_t) (x[j*len+i] * 32767.0f);
-            }
-          }
-          break;
-        }
-        case TW_SPLIT: {
-          const float **const x = (const float **const) f;
-          for (int i = 0, k = 0; i < len; ++i) {
-            for (int j = 0; j < tw->numChannels; ++j) {
-              z[k++] = (int16_t) (x[j][i] * 32767.0f);
-            }
-          }
-          break;
-        }
-        default: return 0;
-      }
-
-      tw->totalFramesWritten += len;
-      return fwrite(z, sizeof(int16_t), tw->numChannels*len, tw->f);
-      break;
-    }
-    case TW_FLOAT32: {
-      float *z = (float *) alloca(tw->numChannels*len*sizeof(float));
-      switch (tw->chanFmt) {
-        case TW_INTERLEAVED: {
-          tw->totalFramesWritten += len;
-          return fwrite(f, sizeof(float), tw->numChannels*len, tw->f);
-        }
-        case TW_INLINE: {
-          const float *const x = (const float *const) f;
-          for (int i = 0, k = 0; i < len; ++i) {
-            for (int j = 0; j < tw->numChannels; ++j) {
-              z[k++] = x[j*len+i];
-            }
-          }
-          break;
-        }
-        case TW_SPLIT: {
-          const float **const x = (const float **const) f;
-          for (int i = 0, k = 0; i < len; ++i) {
-            for (int j = 0; j < tw->numChannels; ++j) {
-              z[k++] = x[j][i];
-            }
-          }
-          break;
-        }
-        default: return 0;
-      }
-
-      tw->totalFramesWritten += len;
-      return fwrite(z, sizeof(float), tw->numChannels*len, tw->f);
-    }
-    default: return 0;
-  }
-}
-
-void tinywav_close_write(TinyWav *tw) {
-  uint32_t data_len = tw->totalFramesWritten * tw->numChannels * tw->sampFmt;
-
-  // set length of data
-  fseek(tw->f, 4, SEEK_SET);
-  uint32_t chunkSize_len = 36 + data_len;
-  fwrite(&chunkSize_len, sizeof(uint32_t), 1, tw->f);
-
-  fseek(tw->f, 40, SEEK_SET);
-  fwrite(&data_len, sizeof(uint32_t), 1, tw->f);
-
-  fclose(tw->f);
-  tw->f = NULL;
-}
-
-bool tinywav_isOpen(TinyWav *tw) {
-  return (tw->f != NULL);
-}
+/**
+ * Copyright (c) 2015-2017, Martin Roth (mhroth@gmail.com)
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+ * OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+
+#include <assert.h>
+#include <string.h>
+#if _WIN32
+#include <winsock2.h>
+#include <malloc.h>
+#else
+#include <alloca.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <../include/tinywav.h>
+#include <../include/Vector_Ops.h>
+
+#define TW_CHUNK_SAMPLES 4096 // samples converted per pass, keeps the scratch buffers on the stack
+
+static uint32_t tinywav_le32(const uint8_t *p);
+static uint16_t tinywav_le16(const uint8_t *p);
+
+int tinywav_sample_bytes(TinyWavSampleFormat sampFmt) {
+  switch (sampFmt) {
+    case TW_INT16: return 2;
+    case TW_INT24: return 3;
+    case TW_INT32: return 4;
+    case TW_FLOAT32: return 4;
+    default: return 0;
+  }
+}
+
+int tinywav_open_write(TinyWav *tw,
+    int16_t numChannels, int32_t samplerate,
+    TinyWavSampleFormat sampFmt, TinyWavChannelFormat chanFmt,
+    const char *path) {
+#if _WIN32
+  errno_t err = fopen_s(&tw->f, path, "wb");
+  assert(err == 0);
+#else
+  tw->f = fopen(path, "wb");
+#endif
+  assert(tw->f != NULL);
+  tw->numChannels = numChannels;
+  tw->totalFramesWritten = 0;
+  tw->totalFramesRead = 0;
+  tw->sampFmt = sampFmt;
+  tw->chanFmt = chanFmt;
+
+  // prepare WAV header
+  TinyWavHeader h;
+  tinywav_header(&h, numChannels, samplerate, sampFmt);
+  tw->h = h;
+
+  // write WAV header
+  fwrite(&h, sizeof(TinyWavHeader), 1, tw->f);
+
+  return 0;
+}
+
+void tinywav_header(TinyWavHeader *h, int16_t numChannels, int32_t samplerate, TinyWavSampleFormat sampFmt) {
+  int bytes = tinywav_sample_bytes(sampFmt);
+  h->ChunkID = htonl(0x52494646); // "RIFF"
+  h->ChunkSize = 0; // fill this in on file-close
+  h->Format = htonl(0x57415645); // "WAVE"
+  memset(&h->Ds64, 0, sizeof(TinyWavDs64));
+  h->Ds64.ChunkID = htonl(0x4a554e4b); // "JUNK", becomes "ds64" if the file outgrows 32-bit sizes
+  h->Ds64.ChunkSize = sizeof(TinyWavDs64) - 8;
+  h->Subchunk1ID = htonl(0x666d7420); // "fmt "
+  h->Subchunk1Size = 16; // PCM
+  h->AudioFormat = (sampFmt == TW_FLOAT32) ? 3 : 1; // 1 PCM, 3 IEEE float
+  h->NumChannels = numChannels;
+  h->SampleRate = samplerate;
+  h->ByteRate = samplerate * numChannels * bytes;
+  h->BlockAlign = numChannels * bytes;
+  h->BitsPerSample = 8*bytes;
+  h->Subchunk2ID = htonl(0x64617461); // "data"
+  h->Subchunk2Size = 0; // fill this in on file-close
+}
+
+void tinywav_header_sizes(TinyWavHeader *h, uint64_t dataBytes) {
+  uint64_t riffSize = sizeof(TinyWavHeader) - 8 + dataBytes + (dataBytes & 1);
+  if (riffSize <= 0xFFFFFFFF) {
+    h->ChunkID = htonl(0x52494646); // "RIFF"
+    h->ChunkSize = (uint32_t) riffSize;
+    h->Subchunk2Size = (uint32_t) dataBytes;
+    h->Ds64.ChunkID = htonl(0x4a554e4b); // "JUNK"
+    return;
+  }
+  uint64_t samples = h->BlockAlign ? dataBytes / h->BlockAlign : 0;
+  h->ChunkID = htonl(0x52463634); // "RF64"
+  h->ChunkSize = 0xFFFFFFFF;
+  h->Subchunk2Size = 0xFFFFFFFF;
+  h->Ds64.ChunkID = htonl(0x64733634); // "ds64"
+  h->Ds64.RiffSizeLow = (uint32_t) riffSize;
+  h->Ds64.RiffSizeHigh = (uint32_t) (riffSize >> 32);
+  h->Ds64.DataSizeLow = (uint32_t) dataBytes;
+  h->Ds64.DataSizeHigh = (uint32_t) (dataBytes >> 32);
+  h->Ds64.SampleCountLow = (uint32_t) samples;
+  h->Ds64.SampleCountHigh = (uint32_t) (samples >> 32);
+}
+
+int tinywav_open_read(TinyWav *tw, const char *path, TinyWavChannelFormat chanFmt, TinyWavSampleFormat sampFmt) {
+  (void) sampFmt; // always read as float
+  tw->f = fopen(path, "rb");
+  if (tw->f == NULL) return -1;
+  memset(&tw->h, 0, sizeof(TinyWavHeader));
+
+  uint8_t riff[12];
+  if (fread(riff, sizeof(riff), 1, tw->f) != 1
+      || (memcmp(riff, "RIFF", 4) != 0 && memcmp(riff, "RF64", 4) != 0 && memcmp(riff, "BW64", 4) != 0)
+      || memcmp(riff+8, "WAVE", 4) != 0) {
+    fclose(tw->f);
+    tw->f = NULL;
+    return -1;
+  }
+  memcpy(&tw->h.ChunkID, riff, 4);
+  tw->h.ChunkSize = tinywav_le32(riff+4);
+  tw->h.Format = htonl(0x57415645);
+  uint64_t dataSize = 0;
+
+  // walk the chunks for "fmt " and "data", chunks are padded to an even size
+  bool haveFmt = false;
+  uint16_t subFormat = 0;
+  for (;;) {
+    uint8_t chunk[8];
+    if (fread(chunk, sizeof(chunk), 1, tw->f) != 1) break;
+    uint32_t size = tinywav_le32(chunk+4);
+    if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+      uint8_t fmt[40] = {0};
+      uint32_t take = size < sizeof(fmt) ? size : (uint32_t) sizeof(fmt);
+      if (fread(fmt, take, 1, tw->f) != 1) break;
+      tw->h.Subchunk1ID = htonl(0x666d7420);
+      tw->h.Subchunk1Size = size;
+      tw->h.AudioFormat = tinywav_le16(fmt);
+      tw->h.NumChannels = tinywav_le16(fmt+2);
+      tw->h.SampleRate = tinywav_le32(fmt+4);
+      tw->h.ByteRate = tinywav_le32(fmt+8);
+      tw->h.BlockAlign = tinywav_le16(fmt+12);
+      tw->h.BitsPerSample = tinywav_le16(fmt+14);
+      // WAVE_FORMAT_EXTENSIBLE keeps the real format code at the start of the sub format GUID
+      subFormat = (tw->h.AudioFormat == 0xFFFE && take >= 26) ? tinywav_le16(fmt+24) : tw->h.AudioFormat;
+      fseek(tw->f, (long) (size - take + (size & 1)), SEEK_CUR);
+      haveFmt = true;
+    } else if (memcmp(chunk, "ds64", 4) == 0 && size >= 24) {
+      uint8_t ds64[24];
+      if (fread(ds64, sizeof(ds64), 1, tw->f) != 1) break;
+      tw->h.Ds64.ChunkID = htonl(0x64733634);
+      tw->h.Ds64.ChunkSize = size;
+      tw->h.Ds64.RiffSizeLow = tinywav_le32(ds64);
+      tw->h.Ds64.RiffSizeHigh = tinywav_le32(ds64+4);
+      tw->h.Ds64.DataSizeLow = tinywav_le32(ds64+8);
+      tw->h.Ds64.DataSizeHigh = tinywav_le32(ds64+12);
+      tw->h.Ds64.SampleCountLow = tinywav_le32(ds64+16);
+      tw->h.Ds64.SampleCountHigh = tinywav_le32(ds64+20);
+      fseek(tw->f, (long) (size - 24 + (size & 1)), SEEK_CUR);
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      tw->h.Subchunk2ID = htonl(0x64617461);
+      tw->h.Subchunk2Size = size;
+      // RF64 marks the 32-bit size unused and keeps the real one in ds64
+      dataSize = size;
+      if (size == 0xFFFFFFFF && tw->h.Ds64.ChunkID == htonl(0x64733634)) {
+        dataSize = ((uint64_t) tw->h.Ds64.DataSizeHigh << 32) | tw->h.Ds64.DataSizeLow;
+      }
+      break;
+    } else {
+      fseek(tw->f, (long) size + (size & 1), SEEK_CUR);
+    }
+  }
+  // no "fmt " or "data" chunk, or a format this reader does not decode
+  if (!haveFmt || tw->h.Subchunk2ID != htonl(0x64617461) || tw->h.NumChannels == 0) subFormat = 0;
+
+  if (subFormat == 3 && tw->h.BitsPerSample == 32) tw->sampFmt = TW_FLOAT32;
+  else if (subFormat == 1 && tw->h.BitsPerSample == 16) tw->sampFmt = TW_INT16;
+  else if (subFormat == 1 && tw->h.BitsPerSample == 24) tw->sampFmt = TW_INT24;
+  else if (subFormat == 1 && tw->h.BitsPerSample == 32) tw->sampFmt = TW_INT32;
+  else {
+    fclose(tw->f);
+    tw->f = NULL;
+    return -1;
+  }
+
+  tw->numChannels = tw->h.NumChannels;
+  tw->chanFmt = chanFmt;
+  tw->totalFramesRead = 0;
+  tw->totalFramesWritten = dataSize / (tw->numChannels * tinywav_sample_bytes(tw->sampFmt));
+  return 0;
+}
+
+int tinywav_read_f(TinyWav *tw, void *data, int len) { // returns number of frames read
+  const int channels = tw->numChannels;
+  const int bytes = tinywav_sample_bytes(tw->sampFmt);
+  assert(channels > 0 && channels <= TW_CHUNK_SAMPLES);
+  const int chunkFrames = TW_CHUNK_SAMPLES / channels;
+  uint8_t raw[TW_CHUNK_SAMPLES*4];
+  float scratch[TW_CHUNK_SAMPLES];
+  float **out = (float **) alloca(channels*sizeof(float *));
+
+  // never read past the data chunk into whatever chunk follows it,
+  // len stays the channel stride of an inlined buffer
+  int wanted = len;
+  if ((uint64_t) wanted > tw->totalFramesWritten - tw->totalFramesRead) {
+    wanted = (int) (tw->totalFramesWritten - tw->totalFramesRead);
+  }
+
+  int done = 0;
+  while (done < wanted) {
+    int frames = (wanted - done < chunkFrames) ? wanted - done : chunkFrames;
+    // interleaved output is decoded in place, other layouts go through the scratch buffer
+    float *dest = (tw->chanFmt == TW_INTERLEAVED) ? (float *) data + (size_t) done*channels : scratch;
+    void *src = (tw->sampFmt == TW_FLOAT32) ? (void *) dest : (void *) raw;
+    int got = (int) (fread(src, (size_t) bytes*channels, (size_t) frames, tw->f));
+    int samples = got*channels;
+
+    switch (tw->sampFmt) {
+      case TW_INT16: vector_s16_to_float((const int16_t *) raw, dest, samples); break;
+      case TW_INT24: vector_s24_to_float(raw, dest, samples); break;
+      case TW_INT32: vector_s32_to_float((const int32_t *) raw, dest, samples); break;
+      case TW_FLOAT32: break;
+      default: return done;
+    }
+
+    switch (tw->chanFmt) {
+      case TW_INTERLEAVED: break;
+      case TW_INLINE: { // channel buffer is inlined e.g. [LLLLRRRR]
+        for (int c = 0; c < channels; ++c) out[c] = (float *) data + (size_t) c*len + done;
+        vector_deinterleave(dest, out, channels, got);
+        break;
+      }
+      case TW_SPLIT: { // channel buffer is split e.g. [[LLLL],[RRRR]]
+        for (int c = 0; c < channels; ++c) out[c] = ((float **) data)[c] + done;
+        vector_deinterleave(dest, out, channels, got);
+        break;
+      }
+      default: return done;
+    }
+
+    done += got;
+    tw->totalFramesRead += got;
+    if (got < frames) break;
+  }
+  return done;
+}
+
+void tinywav_close_read(TinyWav *tw) {
+  fclose(tw->f);
+  tw->f = NULL;
+}
+
+size_t tinywav_write_f(TinyWav *tw, void *f, int len) {
+  const int channels = tw->numChannels;
+  const int bytes = tinywav_sample_bytes(tw->sampFmt);
+
+  if (tw->sampFmt == TW_FLOAT32 && tw->chanFmt == TW_INTERLEAVED) { // already in file layout
+    tw->totalFramesWritten += len;
+    return fwrite(f, sizeof(float), (size_t) channels*len, tw->f);
+  }
+
+  assert(channels > 0 && channels <= TW_CHUNK_SAMPLES);
+  const int chunkFrames = TW_CHUNK_SAMPLES / channels;
+  uint8_t raw[TW_CHUNK_SAMPLES*4];
+  float scratch[TW_CHUNK_SAMPLES];
+  const float **in = (const float **) alloca(channels*sizeof(float *));
+
+  size_t written = 0;
+  for (int done = 0; done < len; ) {
+    int frames = (len - done < chunkFrames) ? len - done : chunkFrames;
+    int samples = frames*channels;
+    const float *x = scratch;
+
+    switch (tw->chanFmt) {
+      case TW_INTERLEAVED: x = (const float *) f + (size_t) done*channels; break;
+      case TW_INLINE: {
+        for (int c = 0; c < channels; ++c) in[c] = (const float *) f + (size_t) c*len + done;
+        vector_interleave(in, scratch, channels, frames);
+        break;
+      }
+      case TW_SPLIT: {
+        for (int c = 0; c < channels; ++c) in[c] = ((const float **) f)[c] + done;
+        vector_interleave(in, scratch, channels, frames);
+        break;
+      }
+      default: return written;
+    }
+
+    const void *z = raw;
+    switch (tw->sampFmt) {
+      case TW_INT16: vector_float_to_s16(x, (int16_t *) raw, samples); break;
+      case TW_INT24: vector_float_to_s24(x, raw, samples); break;
+      case TW_INT32: vector_float_to_s32(x, (int32_t *) raw, samples); break;
+      case TW_FLOAT32: z = x; break;
+      default: return written;
+    }
+
+    size_t n = fwrite(z, (size_t) bytes, (size_t) samples, tw->f);
+    written += n;
+    tw->totalFramesWritten += (uint32_t) (n / channels);
+    if (n < (size_t) samples) break;
+    done += frames;
+  }
+  return written;
+}
+
+void tinywav_close_write(TinyWav *tw) {
+  uint64_t data_len = tw->totalFramesWritten * tw->numChannels * tinywav_sample_bytes(tw->sampFmt);
+
+  // chunks are padded to an even size
+  if (data_len & 1) fputc(0, tw->f);
+
+  // set the sizes, past 4 GB this also turns the header into RF64
+  tinywav_header_sizes(&tw->h, data_len);
+  fseek(tw->f, 0, SEEK_SET);
+  fwrite(&tw->h, sizeof(TinyWavHeader), 1, tw->f);
+
+  fclose(tw->f);
+  tw->f = NULL;
+}
+
+static uint32_t tinywav_le32(const uint8_t *p) {
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint16_t tinywav_le16(const uint8_t *p) {
+  return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+int tinywav_map_open(TinyWavMap *map, const char *path) {
+  memset(map, 0, sizeof(TinyWavMap));
+#if _WIN32
+  return -1;
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return -1;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < 12) {
+    close(fd);
+    return -1;
+  }
+  void *base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping keeps the file alive
+  if (base == MAP_FAILED) return -1;
+  map->base = base;
+  map->length = (size_t) st.st_size;
+
+  const uint8_t *p = (const uint8_t *) base;
+  const uint8_t *end = p + map->length;
+  bool rf64 = memcmp(p, "RF64", 4) == 0 || memcmp(p, "BW64", 4) == 0;
+  if ((memcmp(p, "RIFF", 4) != 0 && !rf64) || memcmp(p+8, "WAVE", 4) != 0) {
+    tinywav_map_close(map);
+    return -1;
+  }
+
+  // walk the chunks for "fmt " and "data", chunks are padded to an even size
+  bool haveFmt = false;
+  uint64_t ds64Data = 0;
+  for (p += 12; p + 8 <= end; ) {
+    uint64_t size = tinywav_le32(p+4);
+    if (memcmp(p, "fmt ", 4) == 0 && p + 24 <= end) {
+      map->audioFormat = tinywav_le16(p+8);
+      map->numChannels = (int16_t) tinywav_le16(p+10);
+      map->sampleRate = tinywav_le32(p+12);
+      map->blockAlign = tinywav_le16(p+20);
+      map->bitsPerSample = tinywav_le16(p+22);
+      haveFmt = true;
+    } else if (memcmp(p, "ds64", 4) == 0 && p + 32 <= end) {
+      ds64Data = ((uint64_t) tinywav_le32(p+20) << 32) | tinywav_le32(p+16);
+    } else if (memcmp(p, "data", 4) == 0) {
+      map->data = p + 8;
+      if (rf64 && size == 0xFFFFFFFF) size = ds64Data;
+      // a writer that never closed leaves the size at zero, take the rest of the file
+      if (size == 0 || size > (uint64_t) (end - map->data)) size = (uint64_t) (end - map->data);
+      map->dataSize = size;
+      break;
+    }
+    p += 8 + size + (size & 1);
+  }
+  if (!haveFmt || map->data == NULL || map->blockAlign == 0) {
+    tinywav_map_close(map);
+    return -1;
+  }
+  map->numFrames = map->dataSize / map->blockAlign;
+
+  madvise(map->base, map->length, MADV_SEQUENTIAL);
+  return 0;
+#endif
+}
+
+const void *tinywav_map_frame(const TinyWavMap *map, uint64_t frame, uint64_t *count) {
+  if (frame >= map->numFrames) {
+    if (count != NULL) *count = 0;
+    return NULL;
+  }
+  if (count != NULL) *count = map->numFrames - frame;
+  return map->data + frame*map->blockAlign;
+}
+
+const float *tinywav_map_frames_f(const TinyWavMap *map, uint64_t frame, uint64_t *count) {
+  if (map->audioFormat != 3 || map->bitsPerSample != 32) {
+    if (count != NULL) *count = 0;
+    return NULL;
+  }
+  return (const float *) tinywav_map_frame(map, frame, count);
+}
+
+void tinywav_map_willneed(const TinyWavMap *map, uint64_t frame, uint64_t count) {
+#if !_WIN32
+  if (frame >= map->numFrames) return;
+  if (count > map->numFrames - frame) count = map->numFrames - frame;
+  // madvise wants a page aligned start
+  uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+  uintptr_t start = (uintptr_t) (map->data + frame*map->blockAlign);
+  uintptr_t stop = start + count*map->blockAlign;
+  start &= ~(page-1);
+  madvise((void *) start, stop - start, MADV_WILLNEED);
+#endif
+}
+
+void tinywav_map_close(TinyWavMap *map) {
+#if !_WIN32
+  if (map->base != NULL) munmap(map->base, map->length);
+#endif
+  memset(map, 0, sizeof(TinyWavMap));
+}
+
+bool tinywav_isOpen(TinyWav *tw) {
+  return (tw->f != NULL);
+}